@@ -0,0 +1,118 @@
+#include "engine.h"
+
+// Size of the surface drawn on
+#define BENCH_SIZE 512
+// Steps per control point of the uniform routines
+#define BENCH_STEPS 20
+// Repeats of each timing
+#define BENCH_REPEATS 20000
+// Maximum number of control points of a curve
+#define BENCH_MAX_POINTS 16
+
+// Evaluator of the previous bezier routine, still exported by SDL2_gfxPrimitives.c
+double _evaluateBezier(double *data, int ndata, double t);
+
+/**
+ * Samples a curve like the previous bezier routine, calling the evaluator for each coordinate of each step
+ * \param vx The x coordinates of the control points
+ * \param vy The y coordinates of the control points
+ * \param n The number of control points, at most BENCH_MAX_POINTS
+ * \param s The number of steps per control point
+ * \param points The array to store the n * s + 1 samples
+ * \return The number of samples
+ */
+static int old_sample(const Sint16 *vx, const Sint16 *vy, int n, int s, SDL_Point *points) {
+    double x[BENCH_MAX_POINTS + 1], y[BENCH_MAX_POINTS + 1];
+    for (int i = 0; i < n; i++) {
+        x[i] = vx[i];
+        y[i] = vy[i];
+    }
+    x[n] = vx[0];
+    y[n] = vy[0];
+    double t = 0.0, stepsize = 1.0 / s;
+    points[0] = (SDL_Point){(int)lrint(_evaluateBezier(x, n + 1, t)), (int)lrint(_evaluateBezier(y, n + 1, t))};
+    for (int i = 0; i < n * s; i++) {
+        t += stepsize;
+        points[i + 1] = (SDL_Point){(int)_evaluateBezier(x, n, t), (int)_evaluateBezier(y, n, t)};
+    }
+    return n * s + 1;
+}
+
+/**
+ * Draws a curve like the previous bezier routine, one line call per step
+ * \param renderer The renderer
+ * \param vx The x coordinates of the control points
+ * \param vy The y coordinates of the control points
+ * \param n The number of control points
+ * \param s The number of steps per control point
+ * \param points A buffer of n * s + 1 points
+ */
+static void old_draw(SDL_Renderer *renderer, const Sint16 *vx, const Sint16 *vy, int n, int s, SDL_Point *points) {
+    int count = old_sample(vx, vy, n, s, points);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    for (int i = 0; i + 1 < count; i++) {
+        SDL_RenderDrawLine(renderer, points[i].x, points[i].y, points[i + 1].x, points[i + 1].y);
+    }
+}
+
+static double seconds_since(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+/**
+ * Times the previous and the new routines on a curve and prints their steps and time per curve
+ * \param name The name of the curve
+ * \param renderer The software renderer
+ * \param vx The x coordinates of the control points
+ * \param vy The y coordinates of the control points
+ * \param n The number of control points
+ */
+static void run(const char *name, SDL_Renderer *renderer, const Sint16 *vx, const Sint16 *vy, int n) {
+    static SDL_Point points[BENCH_STEPS * BENCH_MAX_POINTS + 1];
+    static SDL_FPoint flat[4096];
+    int uniform = n * BENCH_STEPS + 1;
+    int adaptive = bezierFlatten(vx, vy, n, 0.25, flat, 4096);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_REPEATS; i++) old_sample(vx, vy, n, BENCH_STEPS, points);
+    double old_eval = seconds_since(start) / BENCH_REPEATS;
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_REPEATS; i++) bezierFlatten(vx, vy, n, 0.25, flat, 4096);
+    double flatten = seconds_since(start) / BENCH_REPEATS;
+
+    int draws = BENCH_REPEATS / 10;
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < draws; i++) old_draw(renderer, vx, vy, n, BENCH_STEPS, points);
+    double old_time = seconds_since(start) / draws;
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < draws; i++) bezierRGBA(renderer, vx, vy, n, BENCH_STEPS, 255, 255, 255, 255);
+    double new_time = seconds_since(start) / draws;
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < draws; i++) adaptiveBezierRGBA(renderer, vx, vy, n, 0.25, 255, 255, 255, 255);
+    double adaptive_time = seconds_since(start) / draws;
+
+    printf("%-10s steps: uniform %4d adaptive %4d | evaluate: old %7.2f us flatten %6.2f us | draw: old %7.2f us bezierRGBA %7.2f us adaptive %7.2f us\n",
+        name, uniform, adaptive, old_eval * 1e6, flatten * 1e6, old_time * 1e6, new_time * 1e6, adaptive_time * 1e6);
+}
+
+// Bezier benchmark: bezier_bench
+int main(int argc, char *argv[]) {
+    // Drawn in software on a surface, no window is needed
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, BENCH_SIZE, BENCH_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = surface != NULL ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if (renderer == NULL) {
+        fprintf(stderr, "[BENCH] Failed to create software renderer: %s\n", SDL_GetError());
+        exit(1);
+    }
+
+    Sint16 quadratic_x[] = {20, 250, 480}, quadratic_y[] = {480, 20, 480};
+    Sint16 cubic_x[] = {20, 150, 360, 490}, cubic_y[] = {20, 490, -100, 400};
+    Sint16 sextic_x[] = {10, 200, -50, 300, 40, 500}, sextic_y[] = {10, 400, 300, -20, 90, 250};
+    run("quadratic", renderer, quadratic_x, quadratic_y, 3);
+    run("cubic", renderer, cubic_x, cubic_y, 4);
+    run("6 points", renderer, sextic_x, sextic_y, 6);
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "lockstep.h"
+
+// Ticks simulated by each run
+#define BENCH_TICKS 100000
+// First UDP port, the second session uses the next one
+#define BENCH_UDP_PORT 40001
+
+/**
+ * Benchmark state (hash of every applied command, stands for a deterministic game)
+ * \param value The hash
+ */
+typedef struct _BenchState {
+    Uint32 value;
+} BenchState;
+
+static void apply_command(void *state, int player, const Command *command) {
+    BenchState *bench = (BenchState *)state;
+    bench->value = bench->value * 31 + player * 7 + command->type + command->x * 3 + command->y * 5;
+}
+
+static Uint32 checksum(void *state) {
+    return ((BenchState *)state)->value;
+}
+
+/**
+ * Runs two lockstep sessions against each other in one thread and prints their throughput
+ * \param name The name of the run
+ * \param first The transport of the first player
+ * \param second The transport of the second player
+ * \param input_delay The input delay of both sessions
+ * \note Each player sends a command every 4 frames on average, the transports are closed
+ */
+static void run(const char *name, Transport *first, Transport *second, int input_delay) {
+    BenchState states[LOCKSTEP_PLAYERS] = {{1}, {1}};
+    Lockstep *sessions[LOCKSTEP_PLAYERS] = {
+        lockstep_create(first, 0, input_delay, apply_command, checksum, &states[0]),
+        lockstep_create(second, 1, input_delay, apply_command, checksum, &states[1])
+    };
+
+    srand(1);
+    Uint64 frames = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    while (sessions[0]->tick < BENCH_TICKS || sessions[1]->tick < BENCH_TICKS) {
+        for (int player = 0; player < LOCKSTEP_PLAYERS; player++) {
+            if (rand() % 4 == 0) lockstep_set_input(sessions[player], (Command){1 + rand() % 2, rand() % 3, rand() % 3});
+            lockstep_update(sessions[player]);
+        }
+        // A run losing every datagram would never end
+        if (++frames > (Uint64)BENCH_TICKS * 100) {
+            printf("%s: stalled at ticks %u/%u\n", name, sessions[0]->tick, sessions[1]->tick);
+            break;
+        }
+    }
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+    Lockstep *lockstep = sessions[0];
+    printf("%-16s %10.0f ticks/s %6.2f frames/tick %7.1f bytes/tick/player %5.2f packets/tick/player %s\n",
+        name, lockstep->tick / seconds, (double)frames / lockstep->tick,
+        (double)(sessions[0]->bytes_sent + sessions[1]->bytes_sent) / LOCKSTEP_PLAYERS / lockstep->tick,
+        (double)(sessions[0]->packets_sent + sessions[1]->packets_sent) / LOCKSTEP_PLAYERS / lockstep->tick,
+        sessions[0]->desync || sessions[1]->desync ? "DESYNC" : "in sync");
+
+    for (int player = 0; player < LOCKSTEP_PLAYERS; player++) lockstep_destroy(sessions[player]);
+    first->close(first);
+    second->close(second);
+}
+
+// Lockstep benchmark: lockstep_bench [udp port]
+int main(int argc, char *argv[]) {
+    Transport *first, *second;
+    int drops[] = {0, 5, 20};
+    for (int i = 0; i < 3; i++) {
+        char name[32];
+        sprintf(name, "loopback %d%%", drops[i]);
+        transport_loopback_pair(&first, &second, drops[i]);
+        run(name, first, second, 3);
+    }
+
+    int port = argc > 1 ? atoi(argv[1]) : BENCH_UDP_PORT;
+    first = transport_udp_open(port, "127.0.0.1", port + 1);
+    second = transport_udp_open(port + 1, "127.0.0.1", port);
+    run("udp 127.0.0.1", first, second, 3);
+    return 0;
+}
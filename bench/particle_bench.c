@@ -0,0 +1,78 @@
+#include "engine.h"
+
+// Capacity of the emitter, kept full
+#define BENCH_PARTICLES 100000
+// Frames timed
+#define BENCH_FRAMES 300
+
+/**
+ * Benchmark state
+ * \param emitter The particle emitter
+ * \param frame The current frame
+ * \param emit The time spent emitting particles
+ * \param update The time spent between the update and the draw callbacks, where the engine updates the particles
+ * \param draw The time spent building and submitting the geometry of the particles
+ * \param updated The end of the last update callback
+ * \param alive The number of particles alive before each refill, summed over the frames
+ */
+typedef struct _Bench {
+    ParticleEmitter *emitter;
+    int frame;
+    double emit;
+    double update;
+    double draw;
+    Uint64 updated;
+    double alive;
+} Bench;
+
+static double seconds_since(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+/**
+ * Refills the emitter, particles live between 0.25 and 0.5 seconds so a part of them is removed every frame
+ * \param data The benchmark state
+ */
+static void update(void *data) {
+    Bench *bench = (Bench *)data;
+    ParticleEmitter *emitter = bench->emitter;
+    bench->alive += emitter->count;
+    Uint64 start = SDL_GetPerformanceCounter();
+    emit_particles(emitter, emitter->capacity - emitter->count, 512.0f, 384.0f, 200.0f, 500, (Color){255, 160, 32, 255});
+    bench->emit += seconds_since(start);
+    bench->updated = SDL_GetPerformanceCounter();
+}
+
+/**
+ * Draws the particles, prints the timings once every frame is done
+ * \param data The benchmark state
+ */
+static void draw(void *data) {
+    Bench *bench = (Bench *)data;
+    // The engine draws once more before handling the quit event
+    if (bench->frame == BENCH_FRAMES) return;
+    bench->update += seconds_since(bench->updated);
+    Uint64 start = SDL_GetPerformanceCounter();
+    draw_particles(bench->emitter);
+    bench->draw += seconds_since(start);
+
+    if (++bench->frame < BENCH_FRAMES) return;
+    printf("%d particles: %.0f alive before refill, emit %7.1f us update %7.1f us draw %7.1f us per frame (%.2f ns per particle)\n",
+        BENCH_PARTICLES, bench->alive / BENCH_FRAMES, bench->emit / BENCH_FRAMES * 1e6, bench->update / BENCH_FRAMES * 1e6,
+        bench->draw / BENCH_FRAMES * 1e6, (bench->update + bench->draw) / BENCH_FRAMES / BENCH_PARTICLES * 1e9);
+    SDL_Event quit = {SDL_QUIT};
+    SDL_PushEvent(&quit);
+}
+
+// Particle benchmark: particle_bench
+int main(int argc, char *argv[]) {
+    // Above 1000 frames per second the engine does not wait between frames
+    engine_init("Particle benchmark", 1024, 768, 1000000);
+    Bench bench = {create_particle_emitter(NULL, BENCH_PARTICLES, 2.0f, 200.0f), 0, 0.0, 0.0, 0.0, 0, 0.0};
+
+    engine_run(update, draw, NULL, &bench);
+
+    destroy_particle_emitter(bench.emitter);
+    engine_quit();
+    return 0;
+}
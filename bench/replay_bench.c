@@ -0,0 +1,116 @@
+#include "replay.h"
+
+// Number of units of the benchmark world, each with an object
+#define BENCH_UNITS 500
+// Ticks recorded, 10 minutes at 60 ticks per second
+#define BENCH_TICKS 36000
+// Number of timed seeks
+#define BENCH_SEEKS 2000
+
+/**
+ * Benchmark world (state of a strategy game where a few units change every tick)
+ * \param tick The current tick
+ * \param hp The health points of each unit
+ * \param x The x position of each unit
+ * \param y The y position of each unit
+ */
+typedef struct _World {
+    int tick;
+    int hp[BENCH_UNITS];
+    int x[BENCH_UNITS];
+    int y[BENCH_UNITS];
+} World;
+
+static World world;
+static Object *objects[BENCH_UNITS];
+
+/**
+ * Simulates a tick: 8 units move, an effect object appears every 500 ticks and disappears 150 ticks later
+ * \param tick The tick
+ */
+static void simulate(int tick) {
+    world.tick = tick;
+    for (int k = 0; k < 8; k++) {
+        int i = (tick * 37 + k * 101) % BENCH_UNITS;
+        world.x[i]++;
+        world.y[i]--;
+        world.hp[i] -= (tick + k) % 3;
+        objects[i]->x = world.x[i];
+        objects[i]->y = world.y[i];
+    }
+    char name[32];
+    if (tick % 500 == 250) {
+        sprintf(name, "effect_%d", tick);
+        create_object(name, NULL, tick, tick, 1, 1, false, &world.hp[3]);
+    } else if (tick % 500 == 400) {
+        sprintf(name, "effect_%d", tick - 150);
+        destroy_object_by_name(name);
+    }
+}
+
+static double seconds_since(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+/**
+ * Records a match and prints its size and the seek latency
+ * \param keyframe_interval The number of ticks between keyframes
+ */
+static void run(int keyframe_interval) {
+    memset(&world, 0, sizeof(World));
+    for (int i = 0; i < BENCH_UNITS; i++) {
+        char name[32];
+        sprintf(name, "unit_%d", i);
+        objects[i] = create_object(name, NULL, 0, 0, 16, 16, true, &world.hp[i]);
+    }
+
+    // The save of the last tick is checked against the seek
+    Replay *replay = replay_create(&world, sizeof(World), keyframe_interval);
+    size_t saves_size = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int tick = 0; tick < BENCH_TICKS; tick++) {
+        simulate(tick);
+        replay_record(replay);
+        saves_size += replay->save_size;
+    }
+    double record = seconds_since(start) / BENCH_TICKS;
+    size_t last_size;
+    Uint8 *last = save_game_to_memory(&world, sizeof(World), &last_size);
+
+    srand(1);
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_SEEKS; i++) replay_seek(replay, rand() % BENCH_TICKS);
+    double seek = seconds_since(start) / BENCH_SEEKS;
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_SEEKS; i++) replay_seek(replay, rand() % (BENCH_TICKS / keyframe_interval) * keyframe_interval);
+    double keyframe_seek = seconds_since(start) / BENCH_SEEKS;
+    start = SDL_GetPerformanceCounter();
+    for (int tick = 0; tick < BENCH_TICKS; tick++) replay_seek(replay, tick);
+    double playback = seconds_since(start) / BENCH_TICKS;
+
+    size_t size;
+    Uint8 *save = save_game_to_memory(&world, sizeof(World), &size);
+    bool same = size == last_size && memcmp(save, last, size) == 0;
+    free(save);
+    free(last);
+
+    printf("keyframes every %4d ticks: %7.1f bytes/tick (%.0f bytes/save, %5.1fx) record %6.1f us seek %7.1f us keyframe seek %6.1f us playback %6.1f us/tick %s\n",
+        keyframe_interval, (double)replay->data_size / BENCH_TICKS, (double)saves_size / BENCH_TICKS, (double)saves_size / replay->data_size,
+        record * 1e6, seek * 1e6, keyframe_seek * 1e6, playback * 1e6, same ? "match" : "MISMATCH");
+
+    replay_destroy(replay);
+    destroy_all_objects();
+}
+
+// Replay benchmark: replay_bench [keyframe interval]...
+int main(int argc, char *argv[]) {
+    engine_init("Replay benchmark", 64, 64, 60);
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) run(atoi(argv[i]));
+    } else {
+        int intervals[] = {60, 300, 1800};
+        for (int i = 0; i < 3; i++) run(intervals[i]);
+    }
+    engine_quit();
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "rollback.h"
+
+// Frames simulated by each run
+#define BENCH_FRAMES 3000
+// Delay of the inputs of the second player in frames
+#define BENCH_LATENCY 5
+// Number of frames a session can rewind
+#define BENCH_MAX_FRAMES 8
+
+/**
+ * Unit structure (one object of the benchmark world)
+ * \param x The x position
+ * \param y The y position
+ * \param hp The health points
+ * \param target The x position the unit walks to
+ */
+typedef struct _Unit {
+    int x;
+    int y;
+    int hp;
+    int target;
+} Unit;
+
+/**
+ * Benchmark world (state of a strategy game with one object per unit)
+ * \param seed The hash of the applied inputs
+ * \param nb_units The number of units
+ * \param units The units
+ */
+typedef struct _World {
+    Uint32 seed;
+    int nb_units;
+    Unit units[];
+} World;
+
+static Object **objects = NULL;
+
+/**
+ * Simulates a frame of the world, without touching the objects
+ * \param state The world
+ * \param inputs The inputs of every player
+ */
+static void simulate(void *state, const Command inputs[LOCKSTEP_PLAYERS]) {
+    World *world = (World *)state;
+    for (int player = 0; player < LOCKSTEP_PLAYERS; player++) {
+        if (inputs[player].type == COMMAND_NONE) continue;
+        world->units[inputs[player].x * 7 % world->nb_units].target = inputs[player].y;
+        world->seed = world->seed * 31 + inputs[player].x + player;
+    }
+    for (int i = 0; i < world->nb_units; i++) {
+        Unit *unit = &world->units[i];
+        unit->x += (unit->target - unit->x) / 8 + 1;
+        unit->y ^= unit->x;
+        unit->hp += world->seed & 3;
+    }
+}
+
+/**
+ * Simulates a frame of the world and moves the objects of the units
+ * \param state The world
+ * \param inputs The inputs of every player
+ */
+static void advance(void *state, const Command inputs[LOCKSTEP_PLAYERS]) {
+    World *world = (World *)state;
+    simulate(state, inputs);
+    for (int i = 0; i < world->nb_units; i++) {
+        objects[i]->x = world->units[i].x;
+        objects[i]->y = world->units[i].y;
+    }
+}
+
+static double seconds_since(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+/**
+ * Plays a match where the inputs of the second player arrive late, then times each rollback step
+ * \param nb_units The number of units, each with an object
+ */
+static void run(int nb_units) {
+    size_t state_size = sizeof(World) + sizeof(Unit) * nb_units;
+    World *world = (World *)calloc(1, state_size);
+    World *expected = (World *)calloc(1, state_size);
+    Command (*inputs)[LOCKSTEP_PLAYERS] = malloc(sizeof(Command) * LOCKSTEP_PLAYERS * (BENCH_FRAMES + 1));
+    objects = (Object **)malloc(sizeof(Object *) * nb_units);
+    if (world == NULL || expected == NULL || inputs == NULL || objects == NULL) {
+        fprintf(stderr, "[BENCH] Failed to allocate memory for benchmark\n");
+        exit(1);
+    }
+    world->nb_units = expected->nb_units = nb_units;
+    for (int i = 0; i < nb_units; i++) {
+        char name[32];
+        sprintf(name, "unit_%d", i);
+        objects[i] = create_object(name, NULL, 0, 0, 8, 8, true, &world->units[i]);
+    }
+
+    // Reference match, every input on time
+    srand(3);
+    for (int frame = 0; frame <= BENCH_FRAMES; frame++) {
+        for (int player = 0; player < LOCKSTEP_PLAYERS; player++) {
+            inputs[frame][player] = frame < BENCH_FRAMES ? (Command){rand() % 10 == 0, rand() % 200, rand() % 200} : (Command){COMMAND_NONE, 0, 0};
+        }
+        simulate(expected, inputs[frame]);
+    }
+
+    Rollback *rollback = rollback_create(world, state_size, nb_units, BENCH_MAX_FRAMES, advance);
+    int simulated = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int frame = 0; frame <= BENCH_FRAMES; frame++) {
+        rollback_add_input(rollback, 0, frame, inputs[frame][0]);
+        for (int late = frame - BENCH_LATENCY; late <= frame; late++) {
+            // The last frame receives every missing input at once
+            if (late >= 0 && (late == frame - BENCH_LATENCY || frame == BENCH_FRAMES)) rollback_add_input(rollback, 1, late, inputs[late][1]);
+        }
+        simulated += rollback_advance_frame(rollback);
+    }
+    double match = seconds_since(start) / (BENCH_FRAMES + 1);
+    bool same = memcmp(world, expected, state_size) == 0;
+
+    // Each step alone, on the final state
+    int repeats = 1000;
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < repeats; i++) rollback_save(rollback);
+    double save = seconds_since(start) / repeats;
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < repeats; i++) rollback_load(rollback, rollback->frame);
+    double load = seconds_since(start) / repeats;
+    Command none[LOCKSTEP_PLAYERS] = {{COMMAND_NONE, 0, 0}};
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < repeats; i++) advance(world, none);
+    double step = seconds_since(start) / repeats;
+
+    printf("%5d units %7zu bytes: frame %7.1f us (%.2f simulations/frame, %u rollbacks) save %6.1f us load %6.1f us advance %6.1f us, %d-frame rollback %7.1f us %s\n",
+        nb_units, state_size + sizeof(ObjectState) * nb_units, match * 1e6, (double)simulated / (BENCH_FRAMES + 1), rollback->rollbacks,
+        save * 1e6, load * 1e6, step * 1e6, BENCH_MAX_FRAMES, (load + BENCH_MAX_FRAMES * (save + step)) * 1e6, same ? "match" : "MISMATCH");
+
+    rollback_destroy(rollback);
+    destroy_all_objects();
+    free(objects);
+    free(inputs);
+    free(expected);
+    free(world);
+}
+
+// Rollback benchmark: rollback_bench [units]...
+int main(int argc, char *argv[]) {
+    engine_init("Rollback benchmark", 64, 64, 60);
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) run(atoi(argv[i]));
+    } else {
+        int counts[] = {100, 500, 2000, 5000};
+        for (int i = 0; i < 4; i++) run(counts[i]);
+    }
+    engine_quit();
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "engine.h"
+#include "SDL2_rotozoom.h"
+
+// Width and height of the rotated surfaces
+#define BENCH_SIZE 4096
+// Runs of each rotation, the fastest is kept
+#define BENCH_RUNS 3
+
+/**
+ * Rotates a surface like the previous untiled routine, one memcpy per pixel
+ * \param src The surface to rotate
+ * \param turns The number of clockwise quarter turns, from 1 to 3
+ * \return The rotated surface, to free
+ */
+static SDL_Surface *untiled_rotate(SDL_Surface *src, int turns) {
+    int bpp = src->format->BytesPerPixel;
+    int width = turns % 2 ? src->h : src->w;
+    int height = turns % 2 ? src->w : src->h;
+    SDL_Surface *dst = SDL_CreateRGBSurface(src->flags, width, height, src->format->BitsPerPixel, src->format->Rmask, src->format->Gmask, src->format->Bmask, src->format->Amask);
+    if (dst == NULL) {
+        fprintf(stderr, "[BENCH] Failed to create surface: %s\n", SDL_GetError());
+        exit(1);
+    }
+    for (int row = 0; row < src->h; row++) {
+        Uint8 *src_buf = (Uint8 *)src->pixels + row * src->pitch;
+        Uint8 *dst_buf;
+        int step;
+        if (turns == 1) {
+            dst_buf = (Uint8 *)dst->pixels + (dst->w - row - 1) * bpp;
+            step = dst->pitch;
+        } else if (turns == 2) {
+            dst_buf = (Uint8 *)dst->pixels + (dst->h - row - 1) * dst->pitch + (dst->w - 1) * bpp;
+            step = -bpp;
+        } else {
+            dst_buf = (Uint8 *)dst->pixels + row * bpp + (dst->h - 1) * dst->pitch;
+            step = -dst->pitch;
+        }
+        for (int col = 0; col < src->w; col++) {
+            memcpy(dst_buf, src_buf, bpp);
+            src_buf += bpp;
+            dst_buf += step;
+        }
+    }
+    return dst;
+}
+
+/**
+ * Checks that two surfaces hold the same pixels
+ * \param a The first surface
+ * \param b The second surface
+ * \return True if every row is the same
+ */
+static bool same_pixels(SDL_Surface *a, SDL_Surface *b) {
+    if (a->w != b->w || a->h != b->h) return false;
+    for (int row = 0; row < a->h; row++) {
+        if (memcmp((Uint8 *)a->pixels + row * a->pitch, (Uint8 *)b->pixels + row * b->pitch, a->w * a->format->BytesPerPixel) != 0) return false;
+    }
+    return true;
+}
+
+/**
+ * Times a rotation and keeps its last result
+ * \param src The surface to rotate
+ * \param turns The number of clockwise quarter turns
+ * \param tiled True for rotateSurface90Degrees, false for the untiled routine
+ * \param result The variable to store the rotated surface
+ * \return The fastest run in milliseconds
+ */
+static double time_rotation(SDL_Surface *src, int turns, bool tiled, SDL_Surface **result) {
+    double best = 0.0;
+    *result = NULL;
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        if (*result != NULL) SDL_FreeSurface(*result);
+        Uint64 start = SDL_GetPerformanceCounter();
+        *result = tiled ? rotateSurface90Degrees(src, turns) : untiled_rotate(src, turns);
+        double ms = (double)(SDL_GetPerformanceCounter() - start) * 1e3 / SDL_GetPerformanceFrequency();
+        if (run == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+// Rotation benchmark: rotate_bench
+int main(int argc, char *argv[]) {
+    Uint32 formats[] = {SDL_PIXELFORMAT_INDEX8, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_ARGB8888};
+    for (int i = 0; i < 4; i++) {
+        SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, BENCH_SIZE, BENCH_SIZE, SDL_BITSPERPIXEL(formats[i]), formats[i]);
+        if (src == NULL) {
+            fprintf(stderr, "[BENCH] Failed to create surface: %s\n", SDL_GetError());
+            exit(1);
+        }
+        for (int row = 0; row < src->h; row++) {
+            Uint8 *pixels = (Uint8 *)src->pixels + row * src->pitch;
+            for (int x = 0; x < src->pitch; x++) pixels[x] = (Uint8)(row * 31 + x * 7);
+        }
+
+        for (int turns = 1; turns <= 3; turns++) {
+            SDL_Surface *untiled, *tiled;
+            double untiled_ms = time_rotation(src, turns, false, &untiled);
+            double tiled_ms = time_rotation(src, turns, true, &tiled);
+            printf("%2d bpp %3d degrees: untiled %7.1f ms tiled %7.1f ms (%.2fx) %s\n", src->format->BitsPerPixel, turns * 90,
+                untiled_ms, tiled_ms, untiled_ms / tiled_ms, same_pixels(untiled, tiled) ? "match" : "MISMATCH");
+            SDL_FreeSurface(untiled);
+            SDL_FreeSurface(tiled);
+        }
+        SDL_FreeSurface(src);
+    }
+    return 0;
+}
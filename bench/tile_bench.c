@@ -0,0 +1,112 @@
+#include "engine.h"
+
+// Size of a tile in pixels
+#define BENCH_TILE_SIZE 16
+// Number of rows and columns of the tileset
+#define BENCH_TILESET_SIZE 16
+// Tiles drawn each frame, a 64x64 grid
+#define BENCH_GRID 64
+// Frames drawn by each run
+#define BENCH_FRAMES 200
+
+static double seconds_since(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+/**
+ * Writes a tileset where every tile has its own color
+ * \param filename The path to the image
+ */
+static void write_tileset(const char *filename) {
+    int size = BENCH_TILE_SIZE * BENCH_TILESET_SIZE;
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (surface == NULL) {
+        fprintf(stderr, "[BENCH] Failed to create tileset: %s\n", SDL_GetError());
+        exit(1);
+    }
+    for (int row = 0; row < BENCH_TILESET_SIZE; row++) {
+        for (int col = 0; col < BENCH_TILESET_SIZE; col++) {
+            SDL_Rect rect = {col * BENCH_TILE_SIZE, row * BENCH_TILE_SIZE, BENCH_TILE_SIZE, BENCH_TILE_SIZE};
+            SDL_FillRect(surface, &rect, SDL_MapRGB(surface->format, row * 16, col * 16, 128));
+        }
+    }
+    if (SDL_SaveBMP(surface, filename) != 0) {
+        fprintf(stderr, "[BENCH] Failed to write tileset: %s\n", SDL_GetError());
+        exit(1);
+    }
+    SDL_FreeSurface(surface);
+}
+
+/**
+ * Benchmark state
+ * \param tilemap The tilemap
+ * \param path The tile path: 0 for draw_tile_id, 1 for draw_tile_from_tilemap, 2 for get_tile and draw_tile
+ * \param frame The frame of the current path
+ * \param draw The time spent drawing tiles with the current path
+ * \param start The start of the current path
+ */
+typedef struct _Bench {
+    Tilemap *tilemap;
+    int path;
+    int frame;
+    double draw;
+    Uint64 start;
+} Bench;
+
+static const char *path_names[] = {"draw_tile_id", "draw_tile_from_tilemap", "get_tile + draw_tile"};
+
+/**
+ * Draws a frame of tiles with the current path, prints the tiles drawn per millisecond once the path is done
+ * \param data The benchmark state
+ * \note The time with present includes the previous frames of the path, the engine presents after this call
+ */
+static void draw(void *data) {
+    Bench *bench = (Bench *)data;
+    // The engine draws once more before handling the quit event
+    if (bench->path == 3) return;
+    Tilemap *tilemap = bench->tilemap;
+    int nb_tiles = tilemap->nb_rows * tilemap->nb_cols;
+    if (bench->frame == 0) bench->start = SDL_GetPerformanceCounter();
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_GRID * BENCH_GRID; i++) {
+        int id = (i * 7 + bench->frame) % nb_tiles;
+        int x = i % BENCH_GRID * BENCH_TILE_SIZE;
+        int y = i / BENCH_GRID * BENCH_TILE_SIZE;
+        if (bench->path == 0) {
+            draw_tile_id(tilemap, id, x, y);
+        } else if (bench->path == 1) {
+            draw_tile_from_tilemap(tilemap, id / tilemap->nb_cols, id % tilemap->nb_cols, x, y);
+        } else {
+            Tile tile = get_tile(tilemap, id / tilemap->nb_cols, id % tilemap->nb_cols);
+            draw_tile(&tile, x, y);
+        }
+    }
+    bench->draw += seconds_since(start);
+
+    if (++bench->frame < BENCH_FRAMES) return;
+    double tiles = (double)BENCH_GRID * BENCH_GRID * BENCH_FRAMES;
+    printf("%-24s %8.0f tiles/ms submitted %8.0f tiles/ms with present\n", path_names[bench->path], tiles / (bench->draw * 1e3), tiles / (seconds_since(bench->start) * 1e3));
+    bench->frame = 0;
+    bench->draw = 0.0;
+    if (++bench->path == 3) {
+        SDL_Event quit = {SDL_QUIT};
+        SDL_PushEvent(&quit);
+    }
+}
+
+// Tile benchmark: tile_bench
+int main(int argc, char *argv[]) {
+    // Above 1000 frames per second the engine does not wait between frames
+    engine_init("Tile benchmark", BENCH_GRID * BENCH_TILE_SIZE, BENCH_GRID * BENCH_TILE_SIZE, 1000000);
+    char *filename = "tile_bench.bmp";
+    write_tileset(filename);
+    Bench bench = {create_tilemap(filename, BENCH_TILE_SIZE, BENCH_TILE_SIZE, 0, BENCH_TILESET_SIZE, BENCH_TILESET_SIZE), 0, 0, 0.0, 0};
+    remove(filename);
+
+    engine_run(NULL, draw, NULL, &bench);
+
+    destroy_tilemap(bench.tilemap);
+    engine_quit();
+    return 0;
+}
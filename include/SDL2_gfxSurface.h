@@ -0,0 +1,178 @@
+/*
+
+SDL2_gfxSurface.h: graphics primitives drawn in software into SDL surfaces
+
+Copyright (C) 2012-2014  Andreas Schiffler - modified by OJddJO
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+
+Andreas Schiffler -- aschiffler at ferzkopp dot net
+
+*/
+
+#ifndef _SDL2_gfxSurface_h
+#define _SDL2_gfxSurface_h
+
+#include <math.h>
+#ifndef M_PI
+#define M_PI	3.1415926535897932384626433832795
+#endif
+
+#include "SDL2/SDL.h"
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/* ---- Defines */
+
+	/*!
+	\brief Pick the fastest span routines supported by the CPU.
+	*/
+#define GFX_SURFACE_SPANS_AUTO		0
+
+	/*!
+	\brief Use the portable span routines.
+	*/
+#define GFX_SURFACE_SPANS_SCALAR	1
+
+	/*!
+	\brief Use the SSE2 span routines (4 pixels per step).
+	*/
+#define GFX_SURFACE_SPANS_SSE2		2
+
+	/*!
+	\brief Use the AVX2 span routines (8 pixels per step).
+	*/
+#define GFX_SURFACE_SPANS_AVX2		3
+
+	/* ---- Function Prototypes */
+
+#ifdef _MSC_VER
+#  if defined(DLL_EXPORT) && !defined(LIBSDL2_GFX_DLL_IMPORT)
+#    define SDL2_GFXSURFACE_SCOPE __declspec(dllexport)
+#  else
+#    ifdef LIBSDL2_GFX_DLL_IMPORT
+#      define SDL2_GFXSURFACE_SCOPE __declspec(dllimport)
+#    endif
+#  endif
+#endif
+#ifndef SDL2_GFXSURFACE_SCOPE
+#  define SDL2_GFXSURFACE_SCOPE extern
+#endif
+
+	/* Note: all routines only draw on 32bit surfaces and clip against the clip rectangle of the surface */
+
+	/* Span routines */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceSetSpanRoutines(int spans);
+	SDL2_GFXSURFACE_SCOPE int surfaceGetSpanRoutines(void);
+
+	/* Pixel */
+
+	SDL2_GFXSURFACE_SCOPE int surfacePixelRGBA(SDL_Surface * dst, Sint16 x, Sint16 y, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Horizontal line */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceHlineRGBA(SDL_Surface * dst, Sint16 x1, Sint16 x2, Sint16 y, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Vertical line */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceVlineRGBA(SDL_Surface * dst, Sint16 x, Sint16 y1, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Rectangle */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceRectangleRGBA(SDL_Surface * dst, Sint16 x1, Sint16 y1,
+		Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Filled rectangle (Box) */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceBoxRGBA(SDL_Surface * dst, Sint16 x1, Sint16 y1,
+		Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Line */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceLineRGBA(SDL_Surface * dst, Sint16 x1, Sint16 y1,
+		Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Thick Line */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceThickLineRGBA(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2,
+		Uint8 width, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Circle */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceCircleRGBA(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Filled Circle */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceFilledCircleRGBA(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Ellipse */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceEllipseRGBA(SDL_Surface * dst, Sint16 x, Sint16 y,
+		Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Filled Ellipse */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceFilledEllipseRGBA(SDL_Surface * dst, Sint16 x, Sint16 y,
+		Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Thick Ellipse */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceThickEllipseRGBA(SDL_Surface * dst, Sint16 x, Sint16 y,
+		Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a, Uint8 thick);
+
+	/* Filled Polygon */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceFilledPolygonRGBA(SDL_Surface * dst, const Sint16 * vx,
+		const Sint16 * vy, int n, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* AA Filled Polygon */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceAAFilledPolygonRGBA(SDL_Surface * dst, const Sint16 * vx,
+		const Sint16 * vy, int n, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* AA Filled Circle */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceAAFilledCircleRGBA(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* AA Filled Ellipse */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceAAFilledEllipseRGBA(SDL_Surface * dst, Sint16 x, Sint16 y,
+		Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* AA Thick Ellipse */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceAAThickEllipseRGBA(SDL_Surface * dst, Sint16 x, Sint16 y,
+		Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a, Uint8 thick);
+
+	/* AA Thick Line */
+
+	SDL2_GFXSURFACE_SCOPE int surfaceAAThickLineRGBA(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2,
+		Uint8 width, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif				/* _SDL2_gfxSurface_h */
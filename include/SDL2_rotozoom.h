@@ -115,6 +115,16 @@ extern "C" {
 
 	SDL2_ROTOZOOM_SCOPE SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns);
 
+	/* 
+
+	Conversion cache functions
+
+	*/
+
+	SDL2_ROTOZOOM_SCOPE void rotozoomInvalidateSurface(SDL_Surface * src);
+
+	SDL2_ROTOZOOM_SCOPE void rotozoomClearCache(void);
+
 	/* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
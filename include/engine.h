@@ -18,6 +18,8 @@
 #define Color SDL_Color
 // Point structure {x, y} (SDL_Point)
 #define Point SDL_Point
+// Rectangle structure {x, y, w, h} (SDL_Rect)
+#define Rect SDL_Rect
 /**
  * Flip enum (SDL_RendererFlip)
  * \param SDL_FLIP_NONE No flip
@@ -89,6 +91,7 @@ typedef struct _Object {
  * \param spacing The spacing between the tiles
  * \param nb_rows The number of rows in the tilemap
  * \param nb_cols The number of columns in the tilemap
+ * \param tiles The source rectangle of each tile, indexed by tile id
  */
 typedef struct _Tilemap {
     Texture *texture;
@@ -97,20 +100,150 @@ typedef struct _Tilemap {
     int spacing;
     int nb_rows;
     int nb_cols;
+    SDL_Rect *tiles;
 } Tilemap;
 
+// Maximum number of levels of a mip chain, level 0 included
+#define MIP_MAX_LEVELS 8
+
+/**
+ * Mip chain structure (kept by the engine for each texture with more than one level)
+ * \param levels The texture of each level, level 0 is the texture itself and every level is half the size of the previous one
+ * \param nb_levels The number of levels
+ * \param width The width of level 0
+ * \param height The height of level 0
+ */
+typedef struct _MipChain {
+    Texture *levels[MIP_MAX_LEVELS];
+    int nb_levels;
+    int width;
+    int height;
+} MipChain;
+
+/**
+ * Mip chain table structure (open addressing hash map from textures to their mip chain)
+ * \param textures The textures (level 0), NULL for empty slots
+ * \param chains The mip chain of each texture
+ * \param capacity The number of slots, 0 or a power of two
+ * \param count The number of mip chains
+ * \note The user data of the textures is left to the game
+ */
+typedef struct _MipChainTable {
+    Texture **textures;
+    MipChain **chains;
+    int capacity;
+    int count;
+} MipChainTable;
+
 /**
  * Tile structure
  * \param tilemap The tilemap of the tile
  * \param row The row of the tile
  * \param col The column of the tile
+ * \param id The id of the tile in the tilemap
  */
 typedef struct _Tile {
     Tilemap *tilemap;
     int row;
     int col;
+    int id;
 } Tile;
 
+/**
+ * Animation loop mode enum
+ * \param ANIMATION_ONCE The animation stops on its last frame
+ * \param ANIMATION_LOOP The animation restarts from its first frame
+ * \param ANIMATION_PING_PONG The animation plays forward then backward
+ */
+typedef enum _AnimationLoop {
+    ANIMATION_ONCE,
+    ANIMATION_LOOP,
+    ANIMATION_PING_PONG
+} AnimationLoop;
+
+/**
+ * Animation clip structure
+ * \param tilemap The tilemap holding the frames
+ * \param frames The tile id of each frame
+ * \param durations The duration of each frame in milliseconds
+ * \param nb_frames The number of frames
+ * \param loop The loop mode of the clip
+ * \param cycle The time in milliseconds after which a looping animation is back on the same frame and direction
+ */
+typedef struct _AnimationClip {
+    Tilemap *tilemap;
+    int *frames;
+    int *durations;
+    int nb_frames;
+    AnimationLoop loop;
+    int cycle;
+} AnimationClip;
+
+// Animation handle (index in the engine animation states)
+typedef int Animation;
+
+/**
+ * Animation states structure (one slot per animation, stored in contiguous arrays)
+ * \param clips The clip of each animation, NULL for free slots
+ * \param frames The current frame of each animation (index in the clip)
+ * \param elapsed The time spent on the current frame of each animation in milliseconds
+ * \param directions The direction of each animation (1 forward, -1 backward)
+ * \param playing If each animation is playing
+ * \param finished If each animation played the last frame of a clip that plays once
+ * \param next_free The next free slot of each free slot, -1 for the last one
+ * \param count The number of slots in use, including free slots below the last used one
+ * \param capacity The number of allocated slots
+ * \param first_free The first free slot, -1 if there is none
+ */
+typedef struct _AnimationStates {
+    AnimationClip **clips;
+    int *frames;
+    int *elapsed;
+    int *directions;
+    bool *playing;
+    bool *finished;
+    int *next_free;
+    int count;
+    int capacity;
+    int first_free;
+} AnimationStates;
+
+/**
+ * Particle emitter structure (particles are stored as a structure of arrays)
+ * \param texture The texture of the particles, NULL for plain squares
+ * \param size The size of the particles in pixels
+ * \param gravity The vertical acceleration of the particles in pixels per second squared
+ * \param x The x position of each particle
+ * \param y The y position of each particle
+ * \param vx The x velocity of each particle in pixels per second
+ * \param vy The y velocity of each particle in pixels per second
+ * \param life The remaining life of each particle in seconds
+ * \param max_life The initial life of each particle in seconds
+ * \param colors The color of each particle, faded by its remaining life when drawn
+ * \param count The number of living particles
+ * \param capacity The maximum number of particles
+ * \param vertices The vertices used to draw the particles (4 per particle)
+ * \param indices The indices used to draw the particles (6 per particle)
+ * \param next The next particle emitter
+ */
+typedef struct _ParticleEmitter {
+    Texture *texture;
+    float size;
+    float gravity;
+    float *x;
+    float *y;
+    float *vx;
+    float *vy;
+    float *life;
+    float *max_life;
+    Color *colors;
+    int count;
+    int capacity;
+    SDL_Vertex *vertices;
+    int *indices;
+    struct _ParticleEmitter *next;
+} ParticleEmitter;
+
 /**
  * Object template list structure
  * \param name The name of the object template
@@ -118,7 +251,7 @@ typedef struct _Tile {
  * \param next The next object template list item
  */
 typedef struct _ObjectTemplateList {
-    char *name;
+    const char *name;
     ObjectTemplate *object_template;
     struct _ObjectTemplateList *next;
 } ObjectTemplateList;
@@ -130,11 +263,21 @@ typedef struct _ObjectTemplateList {
  * \param next The next object list item
  */
 typedef struct _ObjectList {
-    char *name;
+    const char *name;
     Object *object;
     struct _ObjectList *next;
 } ObjectList;
 
+/**
+ * Object state structure (copy of an object and its name, for snapshots)
+ * \param name The interned name of the object
+ * \param object The fields of the object
+ */
+typedef struct _ObjectState {
+    const char *name;
+    Object object;
+} ObjectState;
+
 /**
  * Texture list structure
  * \param name The name of the texture
@@ -142,11 +285,59 @@ typedef struct _ObjectList {
  * \param next The next texture list item
  */
 typedef struct _TextureList {
-    char *name;
+    const char *name;
     Texture *texture;
     struct _TextureList *next;
 } TextureList;
 
+/**
+ * Texture residency enum (state of a streamed texture)
+ * \param TEXTURE_EVICTED The texture is not on the GPU, only its file data or path is kept
+ * \param TEXTURE_LOADING The image is being decoded by the streaming thread
+ * \param TEXTURE_DECODED The image is decoded and waits to be uploaded by the main thread
+ * \param TEXTURE_RESIDENT The texture is on the GPU
+ * \param TEXTURE_FAILED The image could not be decoded when it was reloaded, the texture is not drawn
+ */
+typedef enum _TextureResidency {
+    TEXTURE_EVICTED,
+    TEXTURE_LOADING,
+    TEXTURE_DECODED,
+    TEXTURE_RESIDENT,
+    TEXTURE_FAILED
+} TextureResidency;
+
+/**
+ * Streamed texture structure (texture evicted from the GPU when the texture budget is exceeded)
+ * \param name The name of the texture
+ * \param path The path to the image
+ * \param file_data The content of the image file, NULL to read it from the path again
+ * \param file_size The size of the file data in bytes
+ * \param texture The texture, NULL when it is not resident
+ * \param decoded The decoded image waiting to be uploaded
+ * \param width The width of the texture
+ * \param height The height of the texture
+ * \param bytes The GPU memory used by the texture and its mip chain when resident
+ * \param last_used The last frame the texture was used
+ * \param state The residency of the texture, written by the streaming thread while loading
+ * \param next_job The next texture waiting to be decoded
+ * \param next The next streamed texture
+ */
+typedef struct _StreamedTexture {
+    const char *name;
+    const char *path;
+    void *file_data;
+    size_t file_size;
+    Texture *texture;
+    SDL_Surface *decoded;
+    int width;
+    int height;
+    size_t bytes;
+    Uint64 last_used;
+    TextureResidency state;
+    struct _StreamedTexture *next_job;
+    struct _StreamedTexture *next;
+} StreamedTexture;
+
 /**
  * Audio list structure
  * \param name The name of the audio
@@ -154,23 +345,268 @@ typedef struct _TextureList {
  * \param next The next audio list item
  */
 typedef struct _Audiolist {
-    char *name;
+    const char *name;
     Mix_Chunk *audio;
     struct _Audiolist *next;
 } Audiolist;
 
+/**
+ * Font face structure (font file read once and shared by every size loaded from it)
+ * \param path The path to the font file
+ * \param data The content of the font file
+ * \param data_size The size of the content in bytes
+ * \param font The font opened on the content, switched between sizes with TTF_SetFontSize
+ * \param current_size The size the font is set to
+ * \param refcount The number of fonts using the face
+ * \param next The next font face
+ */
+typedef struct _FontFace {
+    const char *path;
+    void *data;
+    size_t data_size;
+    TTF_Font *font;
+    int current_size;
+    int refcount;
+    struct _FontFace *next;
+} FontFace;
+
+/**
+ * Text quality enum (how the glyphs of a font are rasterized)
+ * \param TEXT_SOLID Aliased glyphs
+ * \param TEXT_SHADED Antialiased glyphs on an opaque black box
+ * \param TEXT_BLENDED Antialiased glyphs with alpha blending
+ */
+typedef enum _TextQuality {
+    TEXT_SOLID,
+    TEXT_SHADED,
+    TEXT_BLENDED
+} TextQuality;
+
 /**
  * Font structure
  * \param name The name of the font
- * \param font The font
+ * \param face The font face
+ * \param size The size of the font
+ * \param quality The text quality of the font
  * \param next The next font
  */
 typedef struct _Font {
-    char *name;
-    TTF_Font *font;
+    const char *name;
+    FontFace *face;
+    int size;
+    TextQuality quality;
     struct _Font *next;
 } Font;
 
+// Maximum number of shelves of the glyph atlas
+#define GLYPH_MAX_SHELVES 64
+
+/**
+ * Glyph structure (glyph of a font face at a size and quality, rasterized in the glyph atlas)
+ * \param face The font face of the glyph, NULL for empty slots
+ * \param size The size of the glyph
+ * \param quality The text quality of the glyph
+ * \param codepoint The unicode codepoint of the glyph
+ * \param rect The rectangle of the glyph in the atlas, empty for blank glyphs
+ * \param shelf The shelf of the glyph in the atlas, -1 for blank glyphs
+ * \param offset The horizontal offset of the rectangle from the pen position
+ * \param advance The horizontal advance of the glyph
+ */
+typedef struct _Glyph {
+    FontFace *face;
+    int size;
+    TextQuality quality;
+    Uint32 codepoint;
+    SDL_Rect rect;
+    int shelf;
+    int offset;
+    int advance;
+} Glyph;
+
+/**
+ * Glyph shelf structure (row of the glyph atlas, glyphs are added left to right)
+ * \param y The y position of the shelf
+ * \param height The height of the shelf
+ * \param x The x position of the next glyph
+ * \param last_used The last frame a glyph of the shelf was drawn
+ */
+typedef struct _GlyphShelf {
+    int y;
+    int height;
+    int x;
+    Uint64 last_used;
+} GlyphShelf;
+
+/**
+ * Glyph atlas structure (texture holding the glyphs of every font face and size, packed in shelves)
+ * \param texture The texture of the atlas
+ * \param premultiplied Whether the atlas holds premultiplied alpha, false when the renderer has no custom blend modes
+ * \param shelves The shelves of the atlas, from top to bottom
+ * \param nb_shelves The number of shelves
+ * \param used_mask The shelves drawn during the frame `mask_frame`, one bit per shelf
+ * \param mask_frame The frame of `used_mask`
+ * \param glyphs The glyphs in the atlas (open addressing hash table keyed by face, size, quality and codepoint)
+ * \param capacity The number of slots of the table, always a power of two
+ * \param count The number of glyphs in the table
+ * \param generation Incremented every time glyphs are evicted, glyph rectangles of older generations are invalid
+ */
+typedef struct _GlyphAtlas {
+    Texture *texture;
+    bool premultiplied;
+    GlyphShelf shelves[GLYPH_MAX_SHELVES];
+    int nb_shelves;
+    Uint64 used_mask;
+    Uint64 mask_frame;
+    Glyph *glyphs;
+    int capacity;
+    int count;
+    Uint32 generation;
+} GlyphAtlas;
+
+/**
+ * Layout glyph structure (glyph placed in a text layout)
+ * \param codepoint The unicode codepoint of the glyph
+ * \param x The x position of the pen, relative to the layout
+ * \param y The y position of the top of the line, relative to the layout
+ * \param advance The horizontal advance of the glyph
+ */
+typedef struct _LayoutGlyph {
+    Uint32 codepoint;
+    int x;
+    int y;
+    int advance;
+} LayoutGlyph;
+
+/**
+ * Text layout structure (glyph run of a string wrapped to a width, cached between frames)
+ * \param hash The hash of the string
+ * \param font The font of the layout
+ * \param wrap_width The width the text is wrapped to, 0 for no wrapping
+ * \param text The string
+ * \param glyphs The glyphs of the string
+ * \param nb_glyphs The number of glyphs
+ * \param width The width of the layout
+ * \param height The height of the layout
+ * \param vertices The quads of the visible glyphs (4 vertices each), relative to the layout
+ * \param nb_quads The number of quads
+ * \param shelf_mask The atlas shelves holding the glyphs of the quads, one bit per shelf
+ * \param generation The atlas generation the quads were built for
+ * \param last_used The last frame the layout was used
+ * \param next The next layout in the same bucket of the layout cache
+ */
+typedef struct _TextLayout {
+    Uint32 hash;
+    Font *font;
+    int wrap_width;
+    char *text;
+    LayoutGlyph *glyphs;
+    int nb_glyphs;
+    int width;
+    int height;
+    SDL_Vertex *vertices;
+    int nb_quads;
+    Uint64 shelf_mask;
+    Uint32 generation;
+    Uint64 last_used;
+    struct _TextLayout *next;
+} TextLayout;
+
+/**
+ * Frame arena structure (linear allocator reset at the start of every frame)
+ * \param buffer The memory block
+ * \param size The size of the memory block
+ * \param offset The number of bytes used in the memory block
+ * \param overflow The blocks allocated when the memory block was full, freed on reset
+ * \param overflow_size The number of bytes allocated in overflow blocks
+ */
+typedef struct _FrameArena {
+    unsigned char *buffer;
+    size_t size;
+    size_t offset;
+    void *overflow;
+    size_t overflow_size;
+} FrameArena;
+
+/**
+ * Pool structure (allocator for fixed-size items)
+ * \param item_size The size of an item
+ * \param items_per_block The number of items allocated at once when the pool is empty
+ * \param free_list The free items
+ * \param blocks The allocated blocks
+ */
+typedef struct _Pool {
+    size_t item_size;
+    int items_per_block;
+    void *free_list;
+    void *blocks;
+} Pool;
+
+/**
+ * String intern table structure (open addressing hash set of canonical strings)
+ * \param hashes The hashes of the strings, 0 for empty slots
+ * \param strings The canonical strings
+ * \param capacity The number of slots, always a power of two
+ * \param count The number of interned strings
+ * \param block The current storage block of the strings
+ * \param block_size The size of the current storage block
+ * \param block_offset The number of bytes used in the current storage block
+ */
+typedef struct _InternTable {
+    Uint32 *hashes;
+    const char **strings;
+    int capacity;
+    int count;
+    char *block;
+    size_t block_size;
+    size_t block_offset;
+} InternTable;
+
+/**
+ * Geometry buffer structure (colored triangles submitted with SDL_RenderGeometry)
+ * \param vertices The vertices
+ * \param nb_vertices The number of vertices
+ * \param vertices_capacity The number of allocated vertices
+ * \param indices The indices of the triangles
+ * \param nb_indices The number of indices
+ * \param indices_capacity The number of allocated indices
+ */
+typedef struct _GeometryBuffer {
+    SDL_Vertex *vertices;
+    int nb_vertices;
+    int vertices_capacity;
+    int *indices;
+    int nb_indices;
+    int indices_capacity;
+} GeometryBuffer;
+
+/**
+ * Mesh structure (vector shapes tessellated once and drawn many times)
+ * \param geometry The triangles of the mesh, relative to its origin
+ */
+typedef struct _Mesh {
+    GeometryBuffer geometry;
+} Mesh;
+
+/**
+ * Layer structure (render target texture composed once and drawn every frame)
+ * \param name The name of the layer
+ * \param texture The render target of the layer
+ * \param width The width of the layer
+ * \param height The height of the layer
+ * \param valid If the content of the layer is up to date
+ * \param premultiplied Whether the layer is drawn with premultiplied alpha, false when the renderer has no custom blend modes
+ * \param next The next layer
+ */
+typedef struct _Layer {
+    const char *name;
+    Texture *texture;
+    int width;
+    int height;
+    bool valid;
+    bool premultiplied;
+    struct _Layer *next;
+} Layer;
+
 typedef enum _Anchor {
     TOP_LEFT,
     TOP,
@@ -183,6 +619,90 @@ typedef enum _Anchor {
     BOTTOM_RIGHT
 } Anchor;
 
+/**
+ * Input snapshot structure (state of the mouse for the current frame)
+ * \param mouse_x The x position of the mouse
+ * \param mouse_y The y position of the mouse
+ * \param buttons The mouse buttons held down (`SDL_BUTTON_LMASK`, ...)
+ * \param pressed The mouse buttons pressed during the frame
+ * \param released The mouse buttons released during the frame
+ * \param wheel The vertical wheel motion during the frame
+ */
+typedef struct _Input {
+    int mouse_x;
+    int mouse_y;
+    Uint32 buttons;
+    Uint32 pressed;
+    Uint32 released;
+    int wheel;
+} Input;
+
+/**
+ * UI style structure (colors of the UI widgets)
+ * \param panel The color of the panels
+ * \param button The color of the buttons
+ * \param button_hovered The color of the hovered buttons
+ * \param button_pressed The color of the pressed buttons
+ * \param item_hovered The color of the hovered list items
+ * \param item_selected The color of the selected list items
+ * \param text The color of the text
+ */
+typedef struct _UIStyle {
+    Color panel;
+    Color button;
+    Color button_hovered;
+    Color button_pressed;
+    Color item_hovered;
+    Color item_selected;
+    Color text;
+} UIStyle;
+
+/**
+ * UI text structure (text texture cached between frames for a widget)
+ * \param id The id of the widget
+ * \param index The index of the text in the widget (list item)
+ * \param text The text of the texture
+ * \param font The font of the texture
+ * \param color The color of the texture
+ * \param texture The texture
+ * \param width The width of the texture
+ * \param height The height of the texture
+ * \param last_used The last frame the text was drawn
+ */
+typedef struct _UIText {
+    const char *id;
+    int index;
+    char *text;
+    Font *font;
+    Color color;
+    Texture *texture;
+    int width;
+    int height;
+    Uint64 last_used;
+} UIText;
+
+/**
+ * UI text table structure (open addressing hash map from widget id and index to their cached text)
+ * \param texts The cached texts, NULL for empty slots
+ * \param capacity The number of slots, 0 or a power of two
+ * \param count The number of cached texts
+ */
+typedef struct _UITextTable {
+    UIText **texts;
+    int capacity;
+    int count;
+} UITextTable;
+
+/**
+ * UI text draw structure (text drawn when the UI pass ends)
+ * \param texture The texture of the text
+ * \param rect The destination of the text
+ */
+typedef struct _UITextDraw {
+    Texture *texture;
+    SDL_Rect rect;
+} UITextDraw;
+
 
 // Engine functions
 
@@ -190,6 +710,11 @@ void engine_init(const char *title, int width, int height, int fps);
 void engine_quit();
 void engine_run(void (*update)(void *), void (*draw)(void *), void (*event_handler)(SDL_Event, void *), void *game);
 
+// Memory functions
+
+void *engine_frame_alloc(size_t size);
+const char *engine_intern(const char *str);
+
 // Window functions
 
 void set_window_icon(char *filename);
@@ -202,6 +727,8 @@ void manual_update();
 
 Texture *load_texture(char *filename, char *name);
 Texture *get_texture_by_name(char *name);
+Texture *find_texture_by_name(char *name);
+const char *get_texture_name(Texture *texture);
 void draw_texture(Texture *texture, int x, int y, int width, int height);
 void draw_texture_ex(Texture *texture, int x, int y, int width, int height, double angle, Point *center, Flip flip);
 void draw_texture_from_path(char *filename, int x, int y, int width, int height);
@@ -209,16 +736,50 @@ void destroy_texture(char *name);
 void destroy_all_textures();
 void rotate_texture(char *name, double angle); //need to be tested
 
+// Texture streaming functions
+
+StreamedTexture *load_streamed_texture(char *filename, char *name, bool keep_file_data);
+Texture *get_streamed_texture(StreamedTexture *streamed);
+void draw_streamed_texture(StreamedTexture *streamed, int x, int y, int width, int height);
+void set_texture_budget(size_t bytes);
+size_t get_resident_texture_bytes();
+void destroy_streamed_texture(StreamedTexture *streamed);
+void destroy_all_streamed_textures();
+
 // Tilemap functions
 
 Tilemap *create_tilemap(char *filename, int tile_width, int tile_height, int spacing, int nb_rows, int nb_cols);
-Tile *get_tile(Tilemap *tilemap, int tile_row, int tile_col);
+int get_tile_id(Tilemap *tilemap, int tile_row, int tile_col);
+Tile get_tile(Tilemap *tilemap, int tile_row, int tile_col);
 void draw_tile(Tile *tile, int x, int y);
 void draw_tile_with_size(Tile *tile, int x, int y, int width, int height);
 void draw_tile_from_tilemap(Tilemap *tilemap, int tile_row, int tile_col, int x, int y);
-void destroy_tile(Tile *tile);
+void draw_tile_id(Tilemap *tilemap, int id, int x, int y);
 void destroy_tilemap(Tilemap *tilemap);
 
+// Animation functions
+
+AnimationClip *create_animation_clip(Tilemap *tilemap, int *frames, int *durations, int nb_frames, AnimationLoop loop);
+void destroy_animation_clip(AnimationClip *clip);
+Animation create_animation(AnimationClip *clip);
+void set_animation_clip(Animation animation, AnimationClip *clip);
+void pause_animation(Animation animation);
+void resume_animation(Animation animation);
+bool animation_finished(Animation animation);
+int get_animation_tile_id(Animation animation);
+void draw_animation(Animation animation, int x, int y);
+void destroy_animation(Animation animation);
+void destroy_all_animations();
+
+// Particle functions
+
+ParticleEmitter *create_particle_emitter(Texture *texture, int capacity, float size, float gravity);
+void emit_particles(ParticleEmitter *emitter, int count, float x, float y, float speed, int life, Color color);
+void draw_particles(ParticleEmitter *emitter);
+void clear_particles(ParticleEmitter *emitter);
+void destroy_particle_emitter(ParticleEmitter *emitter);
+void destroy_all_particle_emitters();
+
 // Object functions
 
 Object *create_object(char *name, Texture *texture, int x, int y, int width, int height, bool hitbox, void *data);
@@ -228,6 +789,9 @@ void draw_object(Object *object);
 Object *get_object_by_name(char *name);
 void destroy_object_by_name(char *name);
 void destroy_all_objects();
+int get_object_count();
+int save_objects(ObjectState *states, int capacity);
+void restore_objects(const ObjectState *states, int count);
 
 // Object template functions
 
@@ -253,7 +817,23 @@ void draw_rect_thick(int x1, int y1, int x2, int y2, Color color, int thickness)
 void draw_circle_thick(int x, int y, int radius, Color color, int thickness);
 void draw_ellipse_thick(int x, int y, int rx, int ry, Color color, int thickness);
 
+void draw_bezier(Point *points, int count, Color color, int thickness);
+void draw_filled_circle(int x, int y, int radius, Color color);
+void draw_filled_ellipse(int x, int y, int rx, int ry, Color color);
+void draw_filled_rect(int x1, int y1, int x2, int y2, Color color);
+void draw_filled_rects(Rect *rects, int count, Color color);
+void draw_rounded_box(int x1, int y1, int x2, int y2, int radius, Color color);
+
+void flush_geometry();
 void draw_geometry(Texture *texture, int x, int y);
+Mesh *create_mesh();
+void mesh_add_line(Mesh *mesh, int x1, int y1, int x2, int y2, Color color, int thickness);
+void mesh_add_rect(Mesh *mesh, int x1, int y1, int x2, int y2, Color color, int thickness);
+void mesh_add_circle(Mesh *mesh, int x, int y, int radius, Color color, int thickness);
+void mesh_add_ellipse(Mesh *mesh, int x, int y, int rx, int ry, Color color, int thickness);
+void draw_mesh(Mesh *mesh, int x, int y);
+void draw_mesh_ex(Mesh *mesh, int x, int y, double scale, double angle);
+void destroy_mesh(Mesh *mesh);
 Texture *create_line(char *name, int x1, int y1, int x2, int y2, Color color);
 Texture *create_rect(char *name, int x1, int y1, int x2, int y2, Color color);
 Texture *create_circle(char *name, int x, int y, int radius, Color color);
@@ -263,10 +843,23 @@ Texture *create_rect_thick(char *name, int x1, int y1, int x2, int y2, Color col
 Texture *create_circle_thick(char *name, int x, int y, int radius, Color color, int thickness);
 Texture *create_ellipse_thick(char *name, int x, int y, int rx, int ry, Color color, int thickness);
 
+// Layer functions
+
+bool begin_layer(char *name, int width, int height);
+void end_layer();
+void draw_layer(char *name, int x, int y);
+void invalidate_layer(char *name);
+void invalidate_all_layers();
+void destroy_layer(char *name);
+void destroy_all_layers();
+
 // Utility functions
 
 void set_color(Color color);
 void set_background_color(Color color);
+void set_antialiasing(bool antialiasing);
+void set_render_surface(SDL_Surface *surface);
+void set_mipmaps(bool mipmaps);
 void delay(int ms);
 
 // Event functions
@@ -275,14 +868,29 @@ void get_mouse_position(int *x, int *y);
 bool any_key_pressed();
 bool object_is_hovered(Object *object);
 bool object_is_hovered_by_name(char *name);
+const Input *get_input();
 
 // Text functions
 
 void load_font(char *filename, int size, char *name);
+void set_font_quality(char *font_name, TextQuality quality);
 void draw_text(char *font_name, char *text, int x, int y, Color color, Anchor anchor);
+void draw_text_wrapped(char *font_name, char *text, int x, int y, int width, Color color, Anchor anchor);
+void measure_text(char *font_name, char *text, int width, int *text_width, int *text_height);
 void close_font(char *name);
 void close_all_fonts();
 
+// UI functions
+
+void ui_begin(char *font_name);
+void ui_end();
+void ui_set_style(UIStyle style);
+bool ui_panel(int x, int y, int width, int height);
+void ui_label(char *id, char *text, int x, int y, Anchor anchor);
+bool ui_button(char *id, char *text, int x, int y, int width, int height);
+int ui_list(char *id, char **items, int count, int x, int y, int width, int item_height, int selected);
+void ui_clear_cache();
+
 // Audio functions
 
 Audio *load_audio(char *filename, char *name);
@@ -2,6 +2,8 @@
 #define __GAME_H__
 
 #include "engine.h"
+#include "lockstep.h"
+#include "save.h"
 
 #define FPS 60
 #define TILE_SIZE 128
@@ -15,6 +17,13 @@
 #define WIN_W MAP_W * TILE_SIZE
 #define WIN_H MAP_H * TILE_SIZE
 
+#define INPUT_DELAY 3
+#define SAVE_FILE "save.bin"
+
+// Command types of the game
+#define COMMAND_PLAY 1
+#define COMMAND_RESET 2
+
 typedef struct _Game {
     int matrix[3][3];
     int current_player;
@@ -24,5 +33,7 @@ typedef struct _Game {
 
 void init_game(Game *game);
 int check_winner(Game *game);
+bool game_apply_command(Game *game, int player, const Command *command);
+Uint32 game_checksum(Game *game);
 
 #endif // __GAME_H__
\ No newline at end of file
@@ -0,0 +1,114 @@
+#ifndef __LOCKSTEP_H__
+#define __LOCKSTEP_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+
+// Number of players of a lockstep session
+#define LOCKSTEP_PLAYERS 2
+// Number of ticks kept in the command and checksum buffers (power of two)
+#define LOCKSTEP_WINDOW 64
+// Maximum input delay in ticks
+#define LOCKSTEP_MAX_DELAY 16
+// Maximum size of a datagram
+#define LOCKSTEP_PACKET_SIZE 512
+// Type of the empty command, scheduled for ticks without input
+#define COMMAND_NONE 0
+
+/**
+ * Command structure (input of a player for a tick, the types are defined by the game)
+ * \param type The type of the command, COMMAND_NONE for no input
+ * \param x The first argument of the command
+ * \param y The second argument of the command
+ */
+typedef struct _Command {
+    Uint8 type;
+    Uint8 x;
+    Uint8 y;
+} Command;
+
+/**
+ * Transport structure (unreliable datagram channel to the other player)
+ * \param send Sends a datagram, it may be dropped
+ * \param receive Receives a datagram without blocking, returns its size or 0 if there is none
+ * \param close Closes the transport and frees it
+ * \param data The data of the transport
+ */
+typedef struct _Transport {
+    void (*send)(struct _Transport *transport, const void *data, int size);
+    int (*receive)(struct _Transport *transport, void *buffer, int size);
+    void (*close)(struct _Transport *transport);
+    void *data;
+} Transport;
+
+// Applies the command of a player to the simulation state, called in player order every tick
+typedef void (*LockstepApply)(void *state, int player, const Command *command);
+// Hashes the simulation state, called after every tick
+typedef Uint32 (*LockstepChecksum)(void *state);
+
+/**
+ * Lockstep structure (deterministic simulation shared by two players)
+ * \param transport The transport to the other player
+ * \param local_player The index of the local player (0 or 1)
+ * \param input_delay The number of ticks between an input and its simulation
+ * \param tick The next tick to simulate
+ * \param input_tick The next tick to schedule the local input for
+ * \param input The pending local input
+ * \param commands The commands of every player, indexed by tick modulo `LOCKSTEP_WINDOW`
+ * \param remote_tick The next tick missing from the other player
+ * \param remote_ack The next tick the other player is missing from us
+ * \param checksums The checksums of the simulated ticks, indexed by tick modulo `LOCKSTEP_WINDOW`
+ * \param remote_checksum The checksum of the other player waiting to be compared
+ * \param remote_checksum_tick The tick of `remote_checksum`
+ * \param remote_checksum_pending Whether `remote_checksum` waits to be compared
+ * \param desync Whether the checksums of the players differed
+ * \param desync_tick The first tick whose checksums differed
+ * \param apply The function applying commands
+ * \param checksum The function hashing the state
+ * \param state The simulation state
+ * \param bytes_sent The number of bytes sent
+ * \param bytes_received The number of bytes received
+ * \param packets_sent The number of datagrams sent
+ * \param packets_received The number of datagrams received
+ */
+typedef struct _Lockstep {
+    Transport *transport;
+    int local_player;
+    int input_delay;
+    Uint32 tick;
+    Uint32 input_tick;
+    Command input;
+    Command commands[LOCKSTEP_WINDOW][LOCKSTEP_PLAYERS];
+    Uint32 remote_tick;
+    Uint32 remote_ack;
+    Uint32 checksums[LOCKSTEP_WINDOW];
+    Uint32 remote_checksum;
+    Uint32 remote_checksum_tick;
+    bool remote_checksum_pending;
+    bool desync;
+    Uint32 desync_tick;
+    LockstepApply apply;
+    LockstepChecksum checksum;
+    void *state;
+    Uint64 bytes_sent;
+    Uint64 bytes_received;
+    Uint32 packets_sent;
+    Uint32 packets_received;
+} Lockstep;
+
+// Transport functions
+
+Transport *transport_udp_open(Uint16 local_port, const char *peer_host, Uint16 peer_port);
+void transport_loopback_pair(Transport **first, Transport **second, int drop_percent);
+
+// Lockstep functions
+
+Lockstep *lockstep_create(Transport *transport, int local_player, int input_delay, LockstepApply apply, LockstepChecksum checksum, void *state);
+void lockstep_set_input(Lockstep *lockstep, Command command);
+int lockstep_update(Lockstep *lockstep);
+void lockstep_destroy(Lockstep *lockstep);
+
+#endif // __LOCKSTEP_H__
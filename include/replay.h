@@ -0,0 +1,85 @@
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include "engine.h"
+#include "save.h"
+
+// Version of the replay format, files of other versions are rejected
+#define REPLAY_VERSION 1
+
+/**
+ * Replay tick structure (encoded save of a tick)
+ * \param offset The offset of the encoded save in the replay data
+ * \param size The size of the encoded save
+ * \param save_size The size of the decoded save
+ */
+typedef struct _ReplayTick {
+    Uint32 offset;
+    Uint32 size;
+    Uint32 save_size;
+} ReplayTick;
+
+/**
+ * Replay header structure (start of a replay file, followed by the ticks and the data)
+ * \param magic The characters "TWRP"
+ * \param version The version of the format
+ * \param keyframe_interval The number of ticks between keyframes
+ * \param state_size The size of the game state
+ * \param nb_ticks The number of ticks
+ * \param data_size The size of the data
+ */
+typedef struct _ReplayHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 keyframe_interval;
+    Uint32 state_size;
+    Uint32 nb_ticks;
+    Uint32 data_size;
+} ReplayHeader;
+
+/**
+ * Replay structure (save of every tick, keyframes are encoded alone and other ticks as the difference with the previous tick)
+ * \param state The game state
+ * \param state_size The size of the game state
+ * \param keyframe_interval The number of ticks between keyframes
+ * \param ticks The ticks
+ * \param nb_ticks The number of ticks
+ * \param ticks_capacity The capacity of the ticks
+ * \param data The encoded saves
+ * \param data_size The size of the data
+ * \param data_capacity The capacity of the data
+ * \param save The decoded save of `save_tick`, kept to encode or decode the next tick
+ * \param save_size The size of `save`
+ * \param save_capacity The capacity of `save`
+ * \param save_tick The tick of `save`, -1 if none
+ * \param scratch The copy of `save` whose offsets are replaced when loading
+ * \param scratch_capacity The capacity of `scratch`
+ */
+typedef struct _Replay {
+    void *state;
+    size_t state_size;
+    int keyframe_interval;
+    ReplayTick *ticks;
+    Uint32 nb_ticks;
+    Uint32 ticks_capacity;
+    Uint8 *data;
+    size_t data_size;
+    size_t data_capacity;
+    Uint8 *save;
+    size_t save_size;
+    size_t save_capacity;
+    Sint64 save_tick;
+    Uint8 *scratch;
+    size_t scratch_capacity;
+} Replay;
+
+// Replay functions
+
+Replay *replay_create(void *state, size_t state_size, int keyframe_interval);
+void replay_record(Replay *replay);
+bool replay_seek(Replay *replay, Uint32 tick);
+void replay_save(Replay *replay, char *filename);
+Replay *replay_load(char *filename, void *state, size_t state_size);
+void replay_destroy(Replay *replay);
+
+#endif // __REPLAY_H__
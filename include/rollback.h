@@ -0,0 +1,72 @@
+#ifndef __ROLLBACK_H__
+#define __ROLLBACK_H__
+
+#include "engine.h"
+#include "lockstep.h"
+
+// Maximum number of frames a rollback session can rewind
+#define ROLLBACK_MAX_FRAMES 16
+// Number of frames of the input buffer, inputs are accepted up to `ROLLBACK_MAX_FRAMES` frames ahead
+#define ROLLBACK_INPUT_FRAMES (ROLLBACK_MAX_FRAMES * 2)
+
+// Simulates one frame of the state with the inputs of every player (COMMAND_NONE for missing inputs)
+typedef void (*RollbackAdvance)(void *state, const Command inputs[LOCKSTEP_PLAYERS]);
+
+/**
+ * Rollback snapshot structure (state at the start of a frame)
+ * \param frame The frame of the snapshot
+ * \param nb_objects The number of saved objects
+ * \param state The copy of the simulation state
+ * \param objects The copy of the objects
+ */
+typedef struct _RollbackSnapshot {
+    Uint32 frame;
+    int nb_objects;
+    void *state;
+    ObjectState *objects;
+} RollbackSnapshot;
+
+/**
+ * Rollback structure (simulation predicting missing inputs and rewinding when they arrive)
+ * \param state The simulation state, contiguous and without pointers
+ * \param state_size The size of the state
+ * \param max_objects The maximum number of saved objects, 0 to leave the objects out of the snapshots
+ * \param max_frames The number of frames that can be rewound, up to `ROLLBACK_MAX_FRAMES`
+ * \param advance The function simulating a frame
+ * \param memory The preallocated memory of the snapshots
+ * \param snapshots The snapshots, indexed by frame modulo `max_frames`
+ * \param inputs The inputs of every player, indexed by frame modulo `ROLLBACK_INPUT_FRAMES`
+ * \param confirmed Whether each input was received, missing inputs are predicted as COMMAND_NONE
+ * \param frame The next frame to simulate
+ * \param rollback_pending Whether a received input contradicts a prediction
+ * \param rollback_frame The first frame to simulate again
+ * \param rollbacks The number of rollbacks
+ * \param resimulated_frames The number of frames simulated again
+ */
+typedef struct _Rollback {
+    void *state;
+    size_t state_size;
+    int max_objects;
+    int max_frames;
+    RollbackAdvance advance;
+    Uint8 *memory;
+    RollbackSnapshot snapshots[ROLLBACK_MAX_FRAMES];
+    Command inputs[ROLLBACK_INPUT_FRAMES][LOCKSTEP_PLAYERS];
+    bool confirmed[ROLLBACK_INPUT_FRAMES][LOCKSTEP_PLAYERS];
+    Uint32 frame;
+    bool rollback_pending;
+    Uint32 rollback_frame;
+    Uint32 rollbacks;
+    Uint64 resimulated_frames;
+} Rollback;
+
+// Rollback functions
+
+Rollback *rollback_create(void *state, size_t state_size, int max_objects, int max_frames, RollbackAdvance advance);
+bool rollback_add_input(Rollback *rollback, int player, Uint32 frame, Command command);
+void rollback_save(Rollback *rollback);
+bool rollback_load(Rollback *rollback, Uint32 frame);
+int rollback_advance_frame(Rollback *rollback);
+void rollback_destroy(Rollback *rollback);
+
+#endif // __ROLLBACK_H__
@@ -0,0 +1,43 @@
+#ifndef __SAVE_H__
+#define __SAVE_H__
+
+#include "engine.h"
+
+// Version of the save format, files of other versions are rejected
+#define SAVE_VERSION 1
+
+/**
+ * Save header structure (start of a save file)
+ * \param magic The characters "TWSV"
+ * \param version The version of the format
+ * \param byte_order 0x01020304 in the byte order of the machine that saved
+ * \param pointer_size The size of a pointer on the machine that saved
+ * \param object_size The size of an object state on the machine that saved
+ * \param state_size The size of the game state
+ * \param nb_objects The number of objects
+ * \param objects_offset The offset of the objects from the start of the file
+ * \param strings_offset The offset of the names from the start of the file
+ * \param file_size The size of the file
+ * \note The game state follows the header, the objects are object states whose pointers are stored as offsets
+ */
+typedef struct _SaveHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 byte_order;
+    Uint32 pointer_size;
+    Uint32 object_size;
+    Uint32 state_size;
+    Uint32 nb_objects;
+    Uint32 objects_offset;
+    Uint32 strings_offset;
+    Uint32 file_size;
+} SaveHeader;
+
+// Save functions
+
+Uint8 *save_game_to_memory(const void *state, size_t state_size, size_t *size);
+void save_game(char *filename, const void *state, size_t state_size);
+bool load_game_from_memory(Uint8 *data, size_t size, void *state, size_t state_size);
+bool load_game(char *filename, void *state, size_t state_size);
+
+#endif // __SAVE_H__
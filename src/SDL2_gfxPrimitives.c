@@ -35,6 +35,7 @@ Andreas Schiffler -- aschiffler at ferzkopp dot net
 #include "SDL2_gfxPrimitives.h"
 #include "SDL2_rotozoom.h"
 #include "SDL2_gfxPrimitives_font.h"
+#include "SDL2_gfxSurface.h"
 
 /* ---- Structures */
 
@@ -3938,9 +3939,145 @@ int bezierColor(SDL_Renderer *renderer, const Sint16 *vx, const Sint16 *vy, int
 	return bezierRGBA(renderer, vx, vy, n, s, c[0], c[1], c[2], c[3]);
 }
 
+/*!
+\brief Number of points kept on the stack when drawing a bezier curve.
+*/
+#define BEZIER_STACK_POINTS 512
+
+/*!
+\brief Maximum depth of the adaptive subdivision of a bezier curve (at most 65536 segments).
+*/
+#define BEZIER_MAX_DEPTH 16
+
+/*!
+\brief Internal function to sample a bezier curve at regular steps.
+
+Note: Quadratic and cubic curves are sampled by forward differencing (3 additions per point and
+coordinate). Higher degrees use the Bernstein form with binomial weights computed once, and
+powers built incrementally instead of calling pow().
+
+\param vx Vertex array containing X coordinates of the control points.
+\param vy Vertex array containing Y coordinates of the control points.
+\param n Number of control points. Minimum number is 3.
+\param steps Number of segments of the curve.
+\param points Output array, must hold steps + 1 points.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+static int _bezierSample(const Sint16 *vx, const Sint16 *vy, int n, int steps, SDL_Point *points)
+{
+	double h, x, y, dx, dy, ddx, ddy, dddx, dddy, ax, ay, bx, by, cx, cy;
+	double mu, nu, px, py;
+	double *binomial, *muk, *nuk;
+	int i, k;
+
+	h = 1.0 / (double)steps;
+
+	if (n == 3)
+	{
+		/* P(t) = a t^2 + b t + c */
+		ax = vx[0] - 2.0 * vx[1] + vx[2];
+		ay = vy[0] - 2.0 * vy[1] + vy[2];
+		bx = 2.0 * (vx[1] - vx[0]);
+		by = 2.0 * (vy[1] - vy[0]);
+		x = vx[0];
+		y = vy[0];
+		dx = ax * h * h + bx * h;
+		dy = ay * h * h + by * h;
+		ddx = 2.0 * ax * h * h;
+		ddy = 2.0 * ay * h * h;
+		for (i = 0; i <= steps; i++)
+		{
+			points[i].x = (int)lrint(x);
+			points[i].y = (int)lrint(y);
+			x += dx;
+			y += dy;
+			dx += ddx;
+			dy += ddy;
+		}
+		points[steps].x = vx[2];
+		points[steps].y = vy[2];
+		return (0);
+	}
+
+	if (n == 4)
+	{
+		/* P(t) = a t^3 + b t^2 + c t + d */
+		ax = -vx[0] + 3.0 * vx[1] - 3.0 * vx[2] + vx[3];
+		ay = -vy[0] + 3.0 * vy[1] - 3.0 * vy[2] + vy[3];
+		bx = 3.0 * vx[0] - 6.0 * vx[1] + 3.0 * vx[2];
+		by = 3.0 * vy[0] - 6.0 * vy[1] + 3.0 * vy[2];
+		cx = 3.0 * (vx[1] - vx[0]);
+		cy = 3.0 * (vy[1] - vy[0]);
+		x = vx[0];
+		y = vy[0];
+		dx = ax * h * h * h + bx * h * h + cx * h;
+		dy = ay * h * h * h + by * h * h + cy * h;
+		ddx = 6.0 * ax * h * h * h + 2.0 * bx * h * h;
+		ddy = 6.0 * ay * h * h * h + 2.0 * by * h * h;
+		dddx = 6.0 * ax * h * h * h;
+		dddy = 6.0 * ay * h * h * h;
+		for (i = 0; i <= steps; i++)
+		{
+			points[i].x = (int)lrint(x);
+			points[i].y = (int)lrint(y);
+			x += dx;
+			y += dy;
+			dx += ddx;
+			dy += ddy;
+			ddx += dddx;
+			ddy += dddy;
+		}
+		points[steps].x = vx[3];
+		points[steps].y = vy[3];
+		return (0);
+	}
+
+	binomial = (double *)malloc(3 * sizeof(double) * n);
+	if (binomial == NULL)
+	{
+		return (-1);
+	}
+	muk = binomial + n;
+	nuk = muk + n;
+
+	binomial[0] = 1.0;
+	for (k = 1; k < n; k++)
+	{
+		binomial[k] = binomial[k - 1] * (double)(n - k) / (double)k;
+	}
+
+	for (i = 0; i <= steps; i++)
+	{
+		mu = (double)i * h;
+		nu = 1.0 - mu;
+		muk[0] = 1.0;
+		nuk[n - 1] = 1.0;
+		for (k = 1; k < n; k++)
+		{
+			muk[k] = muk[k - 1] * mu;
+			nuk[n - 1 - k] = nuk[n - k] * nu;
+		}
+		px = 0.0;
+		py = 0.0;
+		for (k = 0; k < n; k++)
+		{
+			px += vx[k] * binomial[k] * muk[k] * nuk[k];
+			py += vy[k] * binomial[k] * muk[k] * nuk[k];
+		}
+		points[i].x = (int)lrint(px);
+		points[i].y = (int)lrint(py);
+	}
+
+	free(binomial);
+	return (0);
+}
+
 /*!
 \brief Draw a bezier curve with alpha blending.
 
+Note: The curve is drawn as a single polyline of n * s segments.
+
 \param renderer The renderer to draw on.
 \param vx Vertex array containing X coordinates of the points of the bezier curve.
 \param vy Vertex array containing Y coordinates of the points of the bezier curve.
@@ -3955,10 +4092,9 @@ int bezierColor(SDL_Renderer *renderer, const Sint16 *vx, const Sint16 *vy, int
 */
 int bezierRGBA(SDL_Renderer *renderer, const Sint16 *vx, const Sint16 *vy, int n, int s, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
-	int result;
-	int i;
-	double *x, *y, t, stepsize;
-	Sint16 x1, y1, x2, y2;
+	SDL_Point stackPoints[BEZIER_STACK_POINTS];
+	SDL_Point *points;
+	int result, steps;
 
 	/*
 	 * Sanity check
@@ -3972,56 +4108,224 @@ int bezierRGBA(SDL_Renderer *renderer, const Sint16 *vx, const Sint16 *vy, int n
 		return (-1);
 	}
 
-	/*
-	 * Variable setup
-	 */
-	stepsize = (double)1.0 / (double)s;
+	steps = n * s;
+	points = stackPoints;
+	if (steps + 1 > BEZIER_STACK_POINTS)
+	{
+		points = (SDL_Point *)malloc(sizeof(SDL_Point) * (steps + 1));
+		if (points == NULL)
+		{
+			return (-1);
+		}
+	}
+
+	result = _bezierSample(vx, vy, n, steps, points);
+	if (result == 0)
+	{
+		result |= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+		result |= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+		result |= SDL_RenderDrawLines(renderer, points, steps + 1);
+	}
+
+	if (points != stackPoints)
+	{
+		free(points);
+	}
+	return (result);
+}
+
+/*!
+\brief Internal function testing if the control polygon of a bezier curve is flat enough.
+
+\param px X coordinates of the control points.
+\param py Y coordinates of the control points.
+\param n Number of control points.
+\param tolerance2 Squared maximum distance of the control points to the chord.
+
+\returns Returns 1 if every inner control point is within the tolerance of the chord, 0 otherwise.
+*/
+static int _bezierFlat(const double *px, const double *py, int n, double tolerance2)
+{
+	double cx, cy, len2, t, ex, ey;
+	int i;
+
+	cx = px[n - 1] - px[0];
+	cy = py[n - 1] - py[0];
+	len2 = cx * cx + cy * cy;
+	for (i = 1; i < n - 1; i++)
+	{
+		/* Distance to the chord segment, so control points beyond the ends count too */
+		t = (len2 > 0.0) ? ((px[i] - px[0]) * cx + (py[i] - py[0]) * cy) / len2 : 0.0;
+		if (t < 0.0)
+		{
+			t = 0.0;
+		}
+		else if (t > 1.0)
+		{
+			t = 1.0;
+		}
+		ex = px[0] + t * cx - px[i];
+		ey = py[0] + t * cy - py[i];
+		if (ex * ex + ey * ey > tolerance2)
+		{
+			return (0);
+		}
+	}
+	return (1);
+}
+
+/*!
+\brief Internal function to flatten a bezier curve by recursive de Casteljau subdivision.
+
+\param px X coordinates of the control points.
+\param py Y coordinates of the control points.
+\param n Number of control points.
+\param tolerance2 Squared flatness tolerance.
+\param depth Current depth of the subdivision.
+\param work Scratch memory, 4 * n doubles per remaining level.
+\param points Output array.
+\param max_points Size of the output array.
+\param count Number of points produced so far.
+*/
+static void _bezierSubdivide(const double *px, const double *py, int n, double tolerance2, int depth, double *work,
+	SDL_FPoint *points, int max_points, int *count)
+{
+	double *lx, *ly, *rx, *ry;
+	int i, k;
+
+	if (depth >= BEZIER_MAX_DEPTH || _bezierFlat(px, py, n, tolerance2))
+	{
+		if (*count < max_points)
+		{
+			points[*count].x = (float)px[n - 1];
+			points[*count].y = (float)py[n - 1];
+		}
+		(*count)++;
+		return;
+	}
+
+	lx = work;
+	ly = lx + n;
+	rx = ly + n;
+	ry = rx + n;
 
-	/* Transfer vertices into float arrays */
-	if ((x = (double *)malloc(sizeof(double) * (n + 1))) == NULL)
+	/* Split at t = 0.5, the right half is computed in place */
+	memcpy(rx, px, sizeof(double) * n);
+	memcpy(ry, py, sizeof(double) * n);
+	lx[0] = rx[0];
+	ly[0] = ry[0];
+	for (k = 1; k < n; k++)
+	{
+		for (i = 0; i < n - k; i++)
+		{
+			rx[i] = 0.5 * (rx[i] + rx[i + 1]);
+			ry[i] = 0.5 * (ry[i] + ry[i + 1]);
+		}
+		lx[k] = rx[0];
+		ly[k] = ry[0];
+	}
+
+	_bezierSubdivide(lx, ly, n, tolerance2, depth + 1, work + 4 * n, points, max_points, count);
+	_bezierSubdivide(rx, ry, n, tolerance2, depth + 1, work + 4 * n, points, max_points, count);
+}
+
+/*!
+\brief Flatten a bezier curve into a polyline whose segments follow the curvature.
+
+Note: Flat parts of the curve get few segments and tight bends get many, the polyline never
+strays further than the tolerance from the curve.
+
+\param vx Vertex array containing X coordinates of the points of the bezier curve.
+\param vy Vertex array containing Y coordinates of the points of the bezier curve.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param tolerance Maximum distance in pixels between the polyline and the curve. Must be >0.
+\param points Output array of the points of the polyline, may be NULL when max_points is 0.
+\param max_points Size of the output array.
+
+\returns Returns the number of points of the polyline (only the first max_points are written), -1 on failure.
+*/
+int bezierFlatten(const Sint16 *vx, const Sint16 *vy, int n, double tolerance, SDL_FPoint *points, int max_points)
+{
+	double *px, *py, *work;
+	int i, count;
+
+	if (vx == NULL || vy == NULL || n < 3 || tolerance <= 0.0)
 	{
 		return (-1);
 	}
-	if ((y = (double *)malloc(sizeof(double) * (n + 1))) == NULL)
+
+	px = (double *)malloc(sizeof(double) * (2 * n + 4 * n * (BEZIER_MAX_DEPTH + 1)));
+	if (px == NULL)
 	{
-		free(x);
 		return (-1);
 	}
+	py = px + n;
+	work = py + n;
 	for (i = 0; i < n; i++)
 	{
-		x[i] = (double)vx[i];
-		y[i] = (double)vy[i];
+		px[i] = (double)vx[i];
+		py[i] = (double)vy[i];
+	}
+
+	count = 1;
+	if (max_points > 0)
+	{
+		points[0].x = (float)px[0];
+		points[0].y = (float)py[0];
+	}
+	_bezierSubdivide(px, py, n, tolerance * tolerance, 0, work, points, max_points, &count);
+
+	free(px);
+	return (count);
+}
+
+/*!
+\brief Draw a bezier curve with alpha blending, with a number of segments that follows the curvature.
+
+\param renderer The renderer to draw on.
+\param vx Vertex array containing X coordinates of the points of the bezier curve.
+\param vy Vertex array containing Y coordinates of the points of the bezier curve.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param tolerance Maximum distance in pixels between the drawn polyline and the curve. Must be >0.
+\param r The red value of the bezier curve to draw.
+\param g The green value of the bezier curve to draw.
+\param b The blue value of the bezier curve to draw.
+\param a The alpha value of the bezier curve to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int adaptiveBezierRGBA(SDL_Renderer *renderer, const Sint16 *vx, const Sint16 *vy, int n, double tolerance, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL_FPoint stackPoints[BEZIER_STACK_POINTS];
+	SDL_FPoint *points;
+	int result, count;
+
+	count = bezierFlatten(vx, vy, n, tolerance, stackPoints, BEZIER_STACK_POINTS);
+	if (count < 0)
+	{
+		return (-1);
+	}
+
+	points = stackPoints;
+	if (count > BEZIER_STACK_POINTS)
+	{
+		points = (SDL_FPoint *)malloc(sizeof(SDL_FPoint) * count);
+		if (points == NULL)
+		{
+			return (-1);
+		}
+		bezierFlatten(vx, vy, n, tolerance, points, count);
 	}
-	x[n] = (double)vx[0];
-	y[n] = (double)vy[0];
 
-	/*
-	 * Set color
-	 */
 	result = 0;
 	result |= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
 	result |= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	result |= SDL_RenderDrawLinesF(renderer, points, count);
 
-	/*
-	 * Draw
-	 */
-	t = 0.0;
-	x1 = (Sint16)lrint(_evaluateBezier(x, n + 1, t));
-	y1 = (Sint16)lrint(_evaluateBezier(y, n + 1, t));
-	for (i = 0; i <= (n * s); i++)
-	{
-		t += stepsize;
-		x2 = (Sint16)_evaluateBezier(x, n, t);
-		y2 = (Sint16)_evaluateBezier(y, n, t);
-		result |= line(renderer, x1, y1, x2, y2);
-		x1 = x2;
-		y1 = y2;
+	if (points != stackPoints)
+	{
+		free(points);
 	}
-
-	/* Clean up temporary array */
-	free(x);
-	free(y);
-
 	return (result);
 }
 
@@ -4118,9 +4422,47 @@ int thickLineRGBA(SDL_Renderer *renderer, Sint16 x1, Sint16 y1, Sint16 x2, Sint1
 	return filledPolygonRGBA(renderer, px, py, 4, r, g, b, a);
 }
 
+/*!
+\brief Internal function computing the half extents of an ellipse along one axis, without floating point.
+
+Note: ext[k] is the value of floor(s * sqrt(1 - k^2 / t^2) + 0.5), found as the largest X with
+(2X - 1)^2 t^2 <= 4 s^2 (t^2 - k^2). Both sides are updated incrementally with additions only.
+
+\param s Radius of the ellipse along the spans.
+\param t Radius of the ellipse across the spans.
+\param count Number of extents to compute, at most t + 1.
+\param ext Output array of the half extents.
+*/
+static void _ellipseExtents(int s, int t, int count, int *ext)
+{
+	Sint64 t2 = (Sint64)t * t;
+	Sint64 left = (Sint64)(2 * s - 1) * (2 * s - 1) * t2;	/* (2X - 1)^2 t^2 */
+	Sint64 leftStep = 8 * (Sint64)(s - 1) * t2;			/* decrease of left when X decreases */
+	Sint64 right = 4 * (Sint64)s * s * t2;				/* 4 s^2 (t^2 - k^2) */
+	Sint64 rightStep = 4 * (Sint64)s * s;				/* decrease of right when k increases */
+	Sint64 rightStepStep = 8 * (Sint64)s * s;
+	int x = s;
+	int k;
+
+	for (k = 0; k < count; k++)
+	{
+		while (x > 0 && left > right)
+		{
+			left -= leftStep;
+			leftStep -= 8 * t2;
+			x--;
+		}
+		ext[k] = x;
+		right -= rightStep;
+		rightStep += rightStepStep;
+	}
+}
+
 /*!
 \brief Draw thick ellipse with blending.
 
+Note: The spans of the ring are computed with integers only and drawn with a single call.
+
 \param renderer The renderer to draw on.
 \param xc X coordinate of the center of the ellipse.
 \param yc Y coordinate of the center of the ellipse.
@@ -4137,8 +4479,10 @@ int thickLineRGBA(SDL_Renderer *renderer, Sint16 x1, Sint16 y1, Sint16 x2, Sint1
 int thickEllipseRGBA(SDL_Renderer *renderer, Sint16 xc, Sint16 yc, Sint16 xr, Sint16 yr, Uint8 r, Uint8 g, Uint8 b, Uint8 a, Uint8 thick)
 {
 	int result = 0;
-	int xi, yi, xo, yo, x, y, z;
-	double xi2, yi2, xo2, yo2;
+	int xi, yi, xo, yo, so, si, to, ti;
+	int k, d, count, *outer, *inner;
+	int columns;
+	SDL_Rect *rects, *rect;
 
 	if (thick <= 1)
 		return ellipseRGBA(renderer, xc, yc, xr, yr, r, g, b, a);
@@ -4151,55 +4495,70 @@ int thickEllipseRGBA(SDL_Renderer *renderer, Sint16 xc, Sint16 yc, Sint16 xr, Si
 	if ((xi <= 0) || (yi <= 0))
 		return -1;
 
-	xi2 = xi * xi;
-	yi2 = yi * yi;
-	xo2 = xo * xo;
-	yo2 = yo * yo;
+	/* Tall ellipses are drawn in columns, wide ones in rows */
+	columns = (xr < yr);
+	so = columns ? yo : xo;
+	si = columns ? yi : xi;
+	to = columns ? xo : yo;
+	ti = columns ? xi : yi;
 
-	if (a != 255)
-		result |= SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-	result |= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	outer = (int *)malloc((to + 1 + ti) * sizeof(int) + 4 * (to + 1) * sizeof(SDL_Rect));
+	if (outer == NULL)
+		return -1;
+	inner = outer + to + 1;
+	rects = (SDL_Rect *)(inner + ti);
+	_ellipseExtents(so, to, to + 1, outer);
+	_ellipseExtents(si, ti, ti, inner);
 
-	if (xr < yr)
+	/* Same spans as the original rows/columns of lines, in the same order of coverage */
+	count = 0;
+	for (k = -to; k <= to; k++)
 	{
-		for (x = -xo; x <= -xi; x++)
-		{
-			y = sqrt(yo2 * (1.0 - x * x / xo2)) + 0.5;
-			result |= SDL_RenderDrawLine(renderer, xc + x, yc - y, xc + x, yc + y);
-		}
-		for (x = -xi + 1; x <= xi - 1; x++)
+		d = k < 0 ? -k : k;
+		if (d >= ti)
 		{
-			y = sqrt(yo2 * (1.0 - x * x / xo2)) + 0.5;
-			z = sqrt(yi2 * (1.0 - x * x / xi2)) + 0.5;
-			result |= SDL_RenderDrawLine(renderer, xc + x, yc + z, xc + x, yc + y);
-			result |= SDL_RenderDrawLine(renderer, xc + x, yc - z, xc + x, yc - y);
+			rect = &rects[count++];
+			rect->x = -outer[d];
+			rect->y = k;
+			rect->w = 2 * outer[d] + 1;
 		}
-		for (x = xo; x >= xi; x--)
+		else
 		{
-			y = sqrt(yo2 * (1.0 - x * x / xo2)) + 0.5;
-			result |= SDL_RenderDrawLine(renderer, xc + x, yc - y, xc + x, yc + y);
+			rect = &rects[count++];
+			rect->x = inner[d];
+			rect->y = k;
+			rect->w = outer[d] - inner[d] + 1;
+			rect = &rects[count++];
+			rect->x = -outer[d];
+			rect->y = k;
+			rect->w = outer[d] - inner[d] + 1;
 		}
 	}
-	else
+	for (k = 0; k < count; k++)
 	{
-		for (y = -yo; y <= -yi; y++)
+		rect = &rects[k];
+		if (columns)
 		{
-			x = sqrt(xo2 * (1.0 - y * y / yo2)) + 0.5;
-			result |= SDL_RenderDrawLine(renderer, xc - x, yc + y, xc + x, yc + y);
+			d = rect->x;
+			rect->x = xc + rect->y;
+			rect->y = yc + d;
+			rect->h = rect->w;
+			rect->w = 1;
 		}
-		for (y = -yi + 1; y <= yi - 1; y++)
-		{
-			x = sqrt(xo2 * (1.0 - y * y / yo2)) + 0.5;
-			z = sqrt(xi2 * (1.0 - y * y / yi2)) + 0.5;
-			result |= SDL_RenderDrawLine(renderer, xc + z, yc + y, xc + x, yc + y);
-			result |= SDL_RenderDrawLine(renderer, xc - z, yc + y, xc - x, yc + y);
-		}
-		for (y = yo; y >= yi; y--)
+		else
 		{
-			x = sqrt(xo2 * (1.0 - y * y / yo2)) + 0.5;
-			result |= SDL_RenderDrawLine(renderer, xc - x, yc + y, xc + x, yc + y);
+			rect->x += xc;
+			rect->y += yc;
+			rect->h = 1;
 		}
 	}
+
+	if (a != 255)
+		result |= SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	result |= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	result |= SDL_RenderFillRects(renderer, rects, count);
+
+	free(outer);
 	return result;
 }
 
@@ -4208,3 +4567,292 @@ int thickCircleRGBA(SDL_Renderer * renderer, Sint16 x, Sint16 y, Sint16 rad, Uin
 {
 	return thickEllipseRGBA(renderer, x, y, rad, rad, r, g, b, a, thick);
 }
+
+/* ---- AA Filled shapes */
+
+/*!
+\brief Streaming texture the anti-aliased shapes are uploaded to, shared by every call.
+*/
+static SDL_Texture *aaFilledTexture = NULL;
+
+/*!
+\brief Renderer of the cached texture.
+*/
+static SDL_Renderer *aaFilledRenderer = NULL;
+
+/*!
+\brief Surface the anti-aliased shapes are rasterized into, the size of the cached texture.
+*/
+static SDL_Surface *aaFilledSurface = NULL;
+
+/*!
+\brief Destroys the texture and the surface cached by the anti-aliased filled shapes.
+
+Note: Must be called before the renderer the shapes were drawn on is destroyed.
+*/
+void aaFilledClearCache(void)
+{
+	if (aaFilledTexture)
+	{
+		SDL_DestroyTexture(aaFilledTexture);
+		aaFilledTexture = NULL;
+	}
+	if (aaFilledSurface)
+	{
+		SDL_FreeSurface(aaFilledSurface);
+		aaFilledSurface = NULL;
+	}
+	aaFilledRenderer = NULL;
+}
+
+/*!
+\brief Internal function to prepare the cached surface an anti-aliased shape is rasterized into.
+
+Note: The cached texture and surface only grow, doubling their size, and are recreated when the
+renderer changes. The part of the surface covering the shape is cleared to the color of the
+shape with a zero alpha, so blending the shape into it leaves the color untouched and stores
+the coverage in the alpha channel. The clipping rectangle of the surface is set to that part.
+
+\param renderer The renderer the shape will be drawn on.
+\param left X coordinate of the left edge of the bounding box of the shape.
+\param top Y coordinate of the top edge of the bounding box of the shape.
+\param right X coordinate of the right edge of the bounding box of the shape.
+\param bottom Y coordinate of the bottom edge of the bounding box of the shape.
+\param r The red value of the shape.
+\param g The green value of the shape.
+\param b The blue value of the shape.
+
+\returns Returns the surface, or NULL on failure.
+*/
+static SDL_Surface *_aaFilledBegin(SDL_Renderer *renderer, int left, int top, int right, int bottom, Uint8 r, Uint8 g, Uint8 b)
+{
+	SDL_Rect area;
+	int w, h;
+
+	if (right < left || bottom < top)
+	{
+		return NULL;
+	}
+	area.x = 0;
+	area.y = 0;
+	area.w = right - left + 1;
+	area.h = bottom - top + 1;
+
+	if (aaFilledRenderer != renderer || aaFilledSurface == NULL || aaFilledSurface->w < area.w || aaFilledSurface->h < area.h)
+	{
+		w = 64;
+		h = 64;
+		if (aaFilledRenderer == renderer && aaFilledSurface != NULL)
+		{
+			w = aaFilledSurface->w;
+			h = aaFilledSurface->h;
+		}
+		while (w < area.w) w *= 2;
+		while (h < area.h) h *= 2;
+		aaFilledClearCache();
+		aaFilledSurface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+		aaFilledTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+		if (aaFilledSurface == NULL || aaFilledTexture == NULL)
+		{
+			aaFilledClearCache();
+			return NULL;
+		}
+		SDL_SetTextureBlendMode(aaFilledTexture, SDL_BLENDMODE_BLEND);
+		aaFilledRenderer = renderer;
+	}
+
+	SDL_SetClipRect(aaFilledSurface, &area);
+	SDL_FillRect(aaFilledSurface, &area, SDL_MapRGBA(aaFilledSurface->format, r, g, b, 0));
+	return aaFilledSurface;
+}
+
+/*!
+\brief Internal function to upload the rasterized part of the cached surface and draw it.
+
+Note: Updating the texture makes the renderer flush the draws still using it.
+
+\param renderer The renderer to draw on.
+\param surface The surface the shape was rasterized into.
+\param left X coordinate of the left edge of the shape area.
+\param top Y coordinate of the top edge of the shape area.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+static int _aaFilledEnd(SDL_Renderer *renderer, SDL_Surface *surface, int left, int top)
+{
+	SDL_Rect src, dst;
+
+	src = surface->clip_rect;
+	if (SDL_UpdateTexture(aaFilledTexture, &src, surface->pixels, surface->pitch) != 0)
+	{
+		return -1;
+	}
+	dst.x = left;
+	dst.y = top;
+	dst.w = src.w;
+	dst.h = src.h;
+	return SDL_RenderCopy(renderer, aaFilledTexture, &src, &dst);
+}
+
+/*!
+\brief Draw anti-aliased filled polygon with alpha blending.
+
+Note: The coverage of every pixel is computed exactly in a single pass (see surfaceAAFilledPolygonRGBA).
+
+\param renderer The renderer to draw on.
+\param vx Vertex array containing X coordinates of the points of the filled polygon.
+\param vy Vertex array containing Y coordinates of the points of the filled polygon.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param r The red value of the filled polygon to draw.
+\param g The green value of the filled polygon to draw.
+\param b The blue value of the filled polygon to draw.
+\param a The alpha value of the filled polygon to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int aaFilledPolygonRGBA(SDL_Renderer *renderer, const Sint16 *vx, const Sint16 *vy, int n, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL_Surface *surface;
+	Sint16 *px, *py;
+	int i, minx, miny, maxx, maxy, result;
+
+	if (vx == NULL || vy == NULL || n < 3)
+	{
+		return -1;
+	}
+
+	minx = maxx = vx[0];
+	miny = maxy = vy[0];
+	for (i = 1; i < n; i++)
+	{
+		if (vx[i] < minx) minx = vx[i];
+		if (vx[i] > maxx) maxx = vx[i];
+		if (vy[i] < miny) miny = vy[i];
+		if (vy[i] > maxy) maxy = vy[i];
+	}
+
+	px = (Sint16 *)malloc(2 * sizeof(Sint16) * n);
+	if (px == NULL)
+	{
+		return -1;
+	}
+	py = px + n;
+	for (i = 0; i < n; i++)
+	{
+		px[i] = vx[i] - minx;
+		py[i] = vy[i] - miny;
+	}
+
+	surface = _aaFilledBegin(renderer, minx, miny, maxx + 1, maxy + 1, r, g, b);
+	if (surface == NULL)
+	{
+		free(px);
+		return -1;
+	}
+	result = surfaceAAFilledPolygonRGBA(surface, px, py, n, r, g, b, a);
+	free(px);
+	if (result < 0)
+	{
+		return -1;
+	}
+	return _aaFilledEnd(renderer, surface, minx, miny);
+}
+
+/*!
+\brief Draw anti-aliased filled ellipse with alpha blending.
+
+\param renderer The renderer to draw on.
+\param x X coordinate of the center of the filled ellipse.
+\param y Y coordinate of the center of the filled ellipse.
+\param rx Horizontal radius in pixels of the filled ellipse.
+\param ry Vertical radius in pixels of the filled ellipse.
+\param r The red value of the filled ellipse to draw.
+\param g The green value of the filled ellipse to draw.
+\param b The blue value of the filled ellipse to draw.
+\param a The alpha value of the filled ellipse to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int aaFilledEllipseRGBA(SDL_Renderer *renderer, Sint16 x, Sint16 y, Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL_Surface *surface;
+	int left, top;
+
+	if (rx < 0 || ry < 0)
+	{
+		return -1;
+	}
+
+	left = x - rx - 1;
+	top = y - ry - 1;
+	surface = _aaFilledBegin(renderer, left, top, x + rx + 1, y + ry + 1, r, g, b);
+	if (surface == NULL)
+	{
+		return -1;
+	}
+	if (surfaceAAFilledEllipseRGBA(surface, x - left, y - top, rx, ry, r, g, b, a) < 0)
+	{
+		return -1;
+	}
+	return _aaFilledEnd(renderer, surface, left, top);
+}
+
+/*!
+\brief Draw anti-aliased filled circle with alpha blending.
+
+\param renderer The renderer to draw on.
+\param x X coordinate of the center of the filled circle.
+\param y Y coordinate of the center of the filled circle.
+\param rad Radius in pixels of the filled circle.
+\param r The red value of the filled circle to draw.
+\param g The green value of the filled circle to draw.
+\param b The blue value of the filled circle to draw.
+\param a The alpha value of the filled circle to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int aaFilledCircleRGBA(SDL_Renderer *renderer, Sint16 x, Sint16 y, Sint16 rad, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	return aaFilledEllipseRGBA(renderer, x, y, rad, rad, r, g, b, a);
+}
+
+/*!
+\brief Draw anti-aliased thick line with alpha blending.
+
+\param renderer The renderer to draw on.
+\param x1 X coordinate of the first point of the line.
+\param y1 Y coordinate of the first point of the line.
+\param x2 X coordinate of the second point of the line.
+\param y2 Y coordinate of the second point of the line.
+\param width Width of the line in pixels. Must be >0.
+\param r The red value of the line to draw.
+\param g The green value of the line to draw.
+\param b The blue value of the line to draw.
+\param a The alpha value of the line to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int aaThickLineRGBA(SDL_Renderer *renderer, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 width, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL_Surface *surface;
+	int left, top, margin;
+
+	if (width < 1)
+	{
+		return -1;
+	}
+
+	margin = width / 2 + 1;
+	left = (x1 < x2 ? x1 : x2) - margin;
+	top = (y1 < y2 ? y1 : y2) - margin;
+	surface = _aaFilledBegin(renderer, left, top, (x1 > x2 ? x1 : x2) + margin, (y1 > y2 ? y1 : y2) + margin, r, g, b);
+	if (surface == NULL)
+	{
+		return -1;
+	}
+	if (surfaceAAThickLineRGBA(surface, x1 - left, y1 - top, x2 - left, y2 - top, width, r, g, b, a) < 0)
+	{
+		return -1;
+	}
+	return _aaFilledEnd(renderer, surface, left, top);
+}
@@ -0,0 +1,1669 @@
+/*
+
+SDL2_gfxSurface.c: graphics primitives drawn in software into SDL surfaces
+
+Copyright (C) 2012-2014  Andreas Schiffler - modified by OJddJO
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+
+Andreas Schiffler -- aschiffler at ferzkopp dot net
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "SDL2_gfxSurface.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GFX_SURFACE_X86
+#include <immintrin.h>
+#define GFX_SURFACE_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+/* ---- Structures */
+
+/*!
+\brief Fills a span of pixels with an opaque color.
+*/
+typedef void (*SDL2_gfxSpanFill)(Uint32 *pixels, int n, Uint32 color);
+
+/*!
+\brief Blends a premultiplied color over a span of pixels.
+*/
+typedef void (*SDL2_gfxSpanBlend)(Uint32 *pixels, int n, Uint32 color, Uint32 inv);
+
+/*!
+\brief The structure passed to the internal span routines.
+
+The color is mapped to the format of the surface once per primitive. When blending, the color
+channels are premultiplied by the alpha so every byte of a pixel is blended the same way
+(dst = color + dst * inv / 255), whatever the channel order of the surface.
+*/
+typedef struct
+{
+	SDL_Surface *dst;
+	Uint32 color;		/* mapped color, premultiplied when blending */
+	Uint32 inv;			/* 255 - alpha */
+	int blend;
+} SDL2_gfxSurfacePaint;
+
+/* ---- Span routines */
+
+/*!
+\brief Portable opaque span fill.
+*/
+static void _spanFillScalar(Uint32 *pixels, int n, Uint32 color)
+{
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		pixels[i] = color;
+	}
+}
+
+/*!
+\brief Scales every byte of a pixel by k / 255, two channels at a time in 16bit lanes.
+*/
+static Uint32 _scalePixel(Uint32 d, Uint32 k)
+{
+	Uint32 rb = (d & 0x00FF00FF) * k + 0x00800080;
+	Uint32 ag = ((d >> 8) & 0x00FF00FF) * k + 0x00800080;
+	rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+	ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+	return rb + ag;
+}
+
+/*!
+\brief Blends a premultiplied color over one pixel.
+*/
+static Uint32 _blendPixel(Uint32 d, Uint32 color, Uint32 inv)
+{
+	return color + _scalePixel(d, inv);
+}
+
+/*!
+\brief Portable span blend.
+*/
+static void _spanBlendScalar(Uint32 *pixels, int n, Uint32 color, Uint32 inv)
+{
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		pixels[i] = _blendPixel(pixels[i], color, inv);
+	}
+}
+
+#ifdef GFX_SURFACE_X86
+
+/*!
+\brief SSE2 opaque span fill, 4 pixels per step.
+*/
+GFX_SURFACE_TARGET("sse2")
+static void _spanFillSSE2(Uint32 *pixels, int n, Uint32 color)
+{
+	__m128i c = _mm_set1_epi32((int)color);
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		_mm_storeu_si128((__m128i *)(pixels + i), c);
+	}
+	for (; i < n; i++)
+	{
+		pixels[i] = color;
+	}
+}
+
+/*!
+\brief SSE2 span blend, 4 pixels per step.
+*/
+GFX_SURFACE_TARGET("sse2")
+static void _spanBlendSSE2(Uint32 *pixels, int n, Uint32 color, Uint32 inv)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i c = _mm_set1_epi32((int)color);
+	__m128i k = _mm_set1_epi16((short)inv);
+	__m128i half = _mm_set1_epi16(128);
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128i d = _mm_loadu_si128((__m128i *)(pixels + i));
+		__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), k), half);
+		__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), k), half);
+		lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+		_mm_storeu_si128((__m128i *)(pixels + i), _mm_add_epi8(_mm_packus_epi16(lo, hi), c));
+	}
+	for (; i < n; i++)
+	{
+		pixels[i] = _blendPixel(pixels[i], color, inv);
+	}
+}
+
+/*!
+\brief AVX2 opaque span fill, 8 pixels per step.
+*/
+GFX_SURFACE_TARGET("avx2")
+static void _spanFillAVX2(Uint32 *pixels, int n, Uint32 color)
+{
+	__m256i c = _mm256_set1_epi32((int)color);
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		_mm256_storeu_si256((__m256i *)(pixels + i), c);
+	}
+	for (; i < n; i++)
+	{
+		pixels[i] = color;
+	}
+}
+
+/*!
+\brief AVX2 span blend, 8 pixels per step.
+
+Note: unpack and pack both work within 128bit lanes, so the pixel order is preserved.
+*/
+GFX_SURFACE_TARGET("avx2")
+static void _spanBlendAVX2(Uint32 *pixels, int n, Uint32 color, Uint32 inv)
+{
+	__m256i zero = _mm256_setzero_si256();
+	__m256i c = _mm256_set1_epi32((int)color);
+	__m256i k = _mm256_set1_epi16((short)inv);
+	__m256i half = _mm256_set1_epi16(128);
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256i d = _mm256_loadu_si256((__m256i *)(pixels + i));
+		__m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), k), half);
+		__m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), k), half);
+		lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+		hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+		_mm256_storeu_si256((__m256i *)(pixels + i), _mm256_add_epi8(_mm256_packus_epi16(lo, hi), c));
+	}
+	for (; i < n; i++)
+	{
+		pixels[i] = _blendPixel(pixels[i], color, inv);
+	}
+}
+
+#endif
+
+static int _spanRoutines = -1;
+static SDL2_gfxSpanFill _spanFill = _spanFillScalar;
+static SDL2_gfxSpanBlend _spanBlend = _spanBlendScalar;
+
+/*!
+\brief Selects the span routines used by all surface primitives.
+
+\param spans One of GFX_SURFACE_SPANS_AUTO, GFX_SURFACE_SPANS_SCALAR, GFX_SURFACE_SPANS_SSE2 or GFX_SURFACE_SPANS_AVX2.
+
+\returns Returns 0 on success, -1 if the CPU does not support the requested routines.
+*/
+int surfaceSetSpanRoutines(int spans)
+{
+	if (spans == GFX_SURFACE_SPANS_AUTO)
+	{
+		spans = GFX_SURFACE_SPANS_SCALAR;
+#ifdef GFX_SURFACE_X86
+		if (SDL_HasAVX2())
+		{
+			spans = GFX_SURFACE_SPANS_AVX2;
+		}
+		else if (SDL_HasSSE2())
+		{
+			spans = GFX_SURFACE_SPANS_SSE2;
+		}
+#endif
+	}
+
+	switch (spans)
+	{
+	case GFX_SURFACE_SPANS_SCALAR:
+		_spanFill = _spanFillScalar;
+		_spanBlend = _spanBlendScalar;
+		break;
+#ifdef GFX_SURFACE_X86
+	case GFX_SURFACE_SPANS_SSE2:
+		if (!SDL_HasSSE2())
+		{
+			return (-1);
+		}
+		_spanFill = _spanFillSSE2;
+		_spanBlend = _spanBlendSSE2;
+		break;
+	case GFX_SURFACE_SPANS_AVX2:
+		if (!SDL_HasAVX2())
+		{
+			return (-1);
+		}
+		_spanFill = _spanFillAVX2;
+		_spanBlend = _spanBlendAVX2;
+		break;
+#endif
+	default:
+		return (-1);
+	}
+
+	_spanRoutines = spans;
+	return (0);
+}
+
+/*!
+\brief Returns the span routines used by all surface primitives.
+
+Note: The fastest routines are selected on first use unless surfaceSetSpanRoutines was called.
+
+\returns Returns GFX_SURFACE_SPANS_SCALAR, GFX_SURFACE_SPANS_SSE2 or GFX_SURFACE_SPANS_AVX2.
+*/
+int surfaceGetSpanRoutines(void)
+{
+	if (_spanRoutines < 0)
+	{
+		surfaceSetSpanRoutines(GFX_SURFACE_SPANS_AUTO);
+	}
+	return (_spanRoutines);
+}
+
+/* ---- Paint setup */
+
+/*!
+\brief Internal function to map the color of a primitive and lock the surface.
+
+\param paint The paint to set up.
+\param dst The surface to draw on.
+\param r The red value of the primitive.
+\param g The green value of the primitive.
+\param b The blue value of the primitive.
+\param a The alpha value of the primitive.
+
+\returns Returns 0 on success, 1 if there is nothing to draw, -1 on failure.
+*/
+static int _paintBegin(SDL2_gfxSurfacePaint *paint, SDL_Surface *dst, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	if (dst == NULL || dst->format->BytesPerPixel != 4)
+	{
+		return (-1);
+	}
+	if (a == 0)
+	{
+		return (1);
+	}
+	if (_spanRoutines < 0)
+	{
+		surfaceSetSpanRoutines(GFX_SURFACE_SPANS_AUTO);
+	}
+
+	paint->dst = dst;
+	if (a == 255)
+	{
+		paint->color = SDL_MapRGBA(dst->format, r, g, b, 255);
+		paint->inv = 0;
+		paint->blend = 0;
+	}
+	else
+	{
+		paint->color = SDL_MapRGBA(dst->format, (r * a + 127) / 255, (g * a + 127) / 255, (b * a + 127) / 255, a);
+		paint->inv = 255 - a;
+		paint->blend = 1;
+	}
+
+	if (SDL_MUSTLOCK(dst))
+	{
+		if (SDL_LockSurface(dst) < 0)
+		{
+			return (-1);
+		}
+	}
+	return (0);
+}
+
+/*!
+\brief Internal function to unlock the surface after drawing a primitive.
+
+\param paint The paint used to draw.
+*/
+static void _paintEnd(SDL2_gfxSurfacePaint *paint)
+{
+	if (SDL_MUSTLOCK(paint->dst))
+	{
+		SDL_UnlockSurface(paint->dst);
+	}
+}
+
+/*!
+\brief Internal function to draw a clipped horizontal span.
+
+\param paint The paint to draw with.
+\param x1 X coordinate of the first pixel of the span.
+\param x2 X coordinate of the last pixel of the span.
+\param y Y coordinate of the span.
+*/
+static void _paintSpan(SDL2_gfxSurfacePaint *paint, int x1, int x2, int y)
+{
+	SDL_Rect *clip = &paint->dst->clip_rect;
+	Uint32 *row;
+	int tmp;
+
+	if (x1 > x2)
+	{
+		tmp = x1;
+		x1 = x2;
+		x2 = tmp;
+	}
+	if (y < clip->y || y >= clip->y + clip->h)
+	{
+		return;
+	}
+	if (x1 < clip->x)
+	{
+		x1 = clip->x;
+	}
+	if (x2 >= clip->x + clip->w)
+	{
+		x2 = clip->x + clip->w - 1;
+	}
+	if (x1 > x2)
+	{
+		return;
+	}
+
+	row = (Uint32 *)((Uint8 *)paint->dst->pixels + y * paint->dst->pitch) + x1;
+	if (paint->blend)
+	{
+		_spanBlend(row, x2 - x1 + 1, paint->color, paint->inv);
+	}
+	else
+	{
+		_spanFill(row, x2 - x1 + 1, paint->color);
+	}
+}
+
+/*!
+\brief Internal function to draw a filled box with a paint.
+*/
+static void _paintBox(SDL2_gfxSurfacePaint *paint, int x1, int y1, int x2, int y2)
+{
+	int y, tmp;
+
+	if (y1 > y2)
+	{
+		tmp = y1;
+		y1 = y2;
+		y2 = tmp;
+	}
+	if (y1 < paint->dst->clip_rect.y)
+	{
+		y1 = paint->dst->clip_rect.y;
+	}
+	if (y2 >= paint->dst->clip_rect.y + paint->dst->clip_rect.h)
+	{
+		y2 = paint->dst->clip_rect.y + paint->dst->clip_rect.h - 1;
+	}
+	for (y = y1; y <= y2; y++)
+	{
+		_paintSpan(paint, x1, x2, y);
+	}
+}
+
+/*!
+\brief Internal function to draw a line with a paint using the Bresenham algorithm.
+*/
+static void _paintLine(SDL2_gfxSurfacePaint *paint, int x1, int y1, int x2, int y2)
+{
+	int dx = abs(x2 - x1), sx = (x1 < x2) ? 1 : -1;
+	int dy = -abs(y2 - y1), sy = (y1 < y2) ? 1 : -1;
+	int error = dx + dy, e2;
+
+	if (y1 == y2)
+	{
+		_paintSpan(paint, x1, x2, y1);
+		return;
+	}
+
+	for (;;)
+	{
+		_paintSpan(paint, x1, x1, y1);
+		if (x1 == x2 && y1 == y2)
+		{
+			break;
+		}
+		e2 = 2 * error;
+		if (e2 >= dy)
+		{
+			error += dy;
+			x1 += sx;
+		}
+		if (e2 <= dx)
+		{
+			error += dx;
+			y1 += sy;
+		}
+	}
+}
+
+/*!
+\brief Internal comparison function for qsort of the polygon intersections.
+*/
+static int _compareInt(const void *a, const void *b)
+{
+	return (*(const int *)a) - (*(const int *)b);
+}
+
+/*!
+\brief Internal function to draw a filled polygon with a paint.
+
+Note: Uses the same scanline rules as filledPolygonRGBA so both backends cover the same pixels.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+static int _paintFilledPolygon(SDL2_gfxSurfacePaint *paint, const Sint16 *vx, const Sint16 *vy, int n)
+{
+	int i, y, xa, xb;
+	int miny, maxy;
+	int x1, y1, x2, y2;
+	int ind1, ind2;
+	int ints;
+	int *polyInts;
+
+	if (vx == NULL || vy == NULL || n < 3)
+	{
+		return (-1);
+	}
+
+	polyInts = (int *)malloc(sizeof(int) * n);
+	if (polyInts == NULL)
+	{
+		return (-1);
+	}
+
+	miny = vy[0];
+	maxy = vy[0];
+	for (i = 1; i < n; i++)
+	{
+		if (vy[i] < miny)
+		{
+			miny = vy[i];
+		}
+		else if (vy[i] > maxy)
+		{
+			maxy = vy[i];
+		}
+	}
+	if (miny < paint->dst->clip_rect.y)
+	{
+		miny = paint->dst->clip_rect.y;
+	}
+	if (maxy >= paint->dst->clip_rect.y + paint->dst->clip_rect.h)
+	{
+		maxy = paint->dst->clip_rect.y + paint->dst->clip_rect.h - 1;
+	}
+
+	for (y = miny; y <= maxy; y++)
+	{
+		ints = 0;
+		for (i = 0; i < n; i++)
+		{
+			ind1 = i ? i - 1 : n - 1;
+			ind2 = i;
+			y1 = vy[ind1];
+			y2 = vy[ind2];
+			if (y1 < y2)
+			{
+				x1 = vx[ind1];
+				x2 = vx[ind2];
+			}
+			else if (y1 > y2)
+			{
+				y2 = vy[ind1];
+				y1 = vy[ind2];
+				x2 = vx[ind1];
+				x1 = vx[ind2];
+			}
+			else
+			{
+				continue;
+			}
+			if (((y >= y1) && (y < y2)) || ((y == maxy) && (y > y1) && (y <= y2)))
+			{
+				polyInts[ints++] = ((65536 * (y - y1)) / (y2 - y1)) * (x2 - x1) + (65536 * x1);
+			}
+		}
+
+		qsort(polyInts, ints, sizeof(int), _compareInt);
+
+		for (i = 0; i + 1 < ints; i += 2)
+		{
+			xa = polyInts[i] + 1;
+			xa = (xa >> 16) + ((xa & 32768) >> 15);
+			xb = polyInts[i + 1] - 1;
+			xb = (xb >> 16) + ((xb & 32768) >> 15);
+			_paintSpan(paint, xa, xb, y);
+		}
+	}
+
+	free(polyInts);
+	return (0);
+}
+
+/*!
+\brief Internal function returning the half width of an ellipse on a row.
+
+Note: A pixel is inside the ellipse if its center is inside the ellipse grown by half a pixel,
+so the row of the radius still has a flat run of pixels instead of a single one.
+
+\param rx Horizontal radius of the ellipse.
+\param ry Vertical radius of the ellipse.
+\param dy Distance of the row to the center of the ellipse.
+
+\returns Returns the half width in pixels, or -1 if the row is outside the ellipse.
+*/
+static int _ellipseHalfWidth(int rx, int ry, int dy)
+{
+	double t;
+
+	if (dy > ry)
+	{
+		return (-1);
+	}
+	t = (double)dy / ((double)ry + 0.5);
+	return ((int)((rx + 0.5) * sqrt(1.0 - t * t)));
+}
+
+/*!
+\brief Internal function to draw an elliptical ring with a paint, row by row.
+
+Note: The ring covers the pixels between the inner and outer ellipses. Each row is extended
+to meet the row above it, so thin rings stay connected where the ellipse is flat.
+
+\param paint The paint to draw with.
+\param x X coordinate of the center of the ring.
+\param y Y coordinate of the center of the ring.
+\param xi Inner horizontal radius, 0 for a filled ellipse.
+\param yi Inner vertical radius, 0 for a filled ellipse.
+\param xo Outer horizontal radius.
+\param yo Outer vertical radius.
+*/
+static void _paintRing(SDL2_gfxSurfacePaint *paint, int x, int y, int xi, int yi, int xo, int yo)
+{
+	int dy, wo, wi, next;
+
+	for (dy = 0; dy <= yo; dy++)
+	{
+		wo = _ellipseHalfWidth(xo, yo, dy);
+		wi = (xi > 0 && yi > 0 && dy < yi) ? _ellipseHalfWidth(xi, yi, dy) : 0;
+		next = _ellipseHalfWidth(xo, yo, dy + 1);
+		if (wi > next + 1)
+		{
+			wi = next + 1;
+		}
+
+		if (wi <= 0)
+		{
+			_paintSpan(paint, x - wo, x + wo, y + dy);
+			if (dy > 0)
+			{
+				_paintSpan(paint, x - wo, x + wo, y - dy);
+			}
+		}
+		else
+		{
+			_paintSpan(paint, x - wo, x - wi, y + dy);
+			_paintSpan(paint, x + wi, x + wo, y + dy);
+			if (dy > 0)
+			{
+				_paintSpan(paint, x - wo, x - wi, y - dy);
+				_paintSpan(paint, x + wi, x + wo, y - dy);
+			}
+		}
+	}
+}
+
+/* ---- Coverage rasterizer */
+
+/*!
+\brief Internal function to accumulate the signed area of an edge into a coverage buffer.
+
+Note: Each row of the buffer holds, for every pixel, the change in coverage from the pixel on its
+left. The area of the edge is split exactly between the pixels it crosses, so the running sum of
+a row is the exact coverage of each pixel by the shape.
+
+\param acc The coverage buffer.
+\param stride The number of cells in a row of the buffer, at least the width plus 2.
+\param h The number of rows of the buffer.
+\param x0 X coordinate of the first point of the edge, relative to the buffer.
+\param y0 Y coordinate of the first point of the edge, relative to the buffer.
+\param x1 X coordinate of the second point of the edge, relative to the buffer.
+\param y1 Y coordinate of the second point of the edge, relative to the buffer.
+*/
+static void _coverageEdge(float *acc, int stride, int h, float x0, float y0, float x1, float y1)
+{
+	float dir, dxdy, x, xnext, dy, d, xa, xb, s, a0, a1, a2, am, xaf, xbf;
+	float *row;
+	int y, yend, xai, xbi, xi;
+
+	if (y0 == y1)
+	{
+		return;
+	}
+	if (y0 < y1)
+	{
+		dir = 1.0f;
+	}
+	else
+	{
+		dir = -1.0f;
+		x = x0; x0 = x1; x1 = x;
+		x = y0; y0 = y1; y1 = x;
+	}
+	if (y1 <= 0.0f || y0 >= (float)h)
+	{
+		return;
+	}
+
+	dxdy = (x1 - x0) / (y1 - y0);
+	x = x0;
+	y = (int)y0;
+	if (y0 < 0.0f)
+	{
+		x -= y0 * dxdy;
+		y = 0;
+	}
+	yend = (int)ceilf(y1);
+	if (yend > h)
+	{
+		yend = h;
+	}
+
+	for (; y < yend; y++)
+	{
+		row = acc + y * stride;
+		dy = ((y + 1.0f < y1) ? y + 1.0f : y1) - ((y > y0) ? (float)y : y0);
+		xnext = x + dxdy * dy;
+		d = dy * dir;
+		if (x < xnext)
+		{
+			xa = x;
+			xb = xnext;
+		}
+		else
+		{
+			xa = xnext;
+			xb = x;
+		}
+		/* Interpolation may drift out of the buffer by a rounding error */
+		if (xa < 0.0f)
+		{
+			xa = 0.0f;
+		}
+		if (xb > (float)(stride - 2))
+		{
+			xb = (float)(stride - 2);
+		}
+		xaf = floorf(xa);
+		xai = (int)xaf;
+		xbi = (int)ceilf(xb);
+
+		if (xbi <= xai + 1)
+		{
+			/* The edge stays in one pixel on this row */
+			am = 0.5f * (xa + xb) - xaf;
+			row[xai] += d - d * am;
+			row[xai + 1] += d * am;
+		}
+		else
+		{
+			s = 1.0f / (xb - xa);
+			xaf = xa - xaf;
+			a0 = 0.5f * s * (1.0f - xaf) * (1.0f - xaf);
+			xbf = xb - (float)xbi + 1.0f;
+			am = 0.5f * s * xbf * xbf;
+			row[xai] += d * a0;
+			if (xbi == xai + 2)
+			{
+				row[xai + 1] += d * (1.0f - a0 - am);
+			}
+			else
+			{
+				a1 = s * (1.5f - xaf);
+				row[xai + 1] += d * (a1 - a0);
+				for (xi = xai + 2; xi < xbi - 1; xi++)
+				{
+					row[xi] += d * s;
+				}
+				a2 = a1 + (float)(xbi - xai - 3) * s;
+				row[xbi - 1] += d * (1.0f - a2 - am);
+			}
+			row[xbi] += d * am;
+		}
+		x = xnext;
+	}
+}
+
+/*!
+\brief Internal function to fill closed contours with exact anti-aliasing, in a single pass.
+
+Note: The contours follow the non-zero rule, a contour wound the other way cuts a hole.
+
+\param paint The paint to draw with.
+\param px X coordinates of the points of all contours.
+\param py Y coordinates of the points of all contours.
+\param counts Number of points of each contour.
+\param contours Number of contours.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+static int _paintCoverage(SDL2_gfxSurfacePaint *paint, const float *px, const float *py, const int *counts, int contours)
+{
+	SDL_Rect *clip = &paint->dst->clip_rect;
+	float minx, miny, maxx, maxy, sum, coverage;
+	float *acc;
+	Uint32 *pixels;
+	Uint32 k, alpha, a;
+	int bx, by, bw, bh, stride;
+	int c, i, j, first, n, x, y;
+
+	n = 0;
+	for (c = 0; c < contours; c++)
+	{
+		n += counts[c];
+	}
+	if (n < 3)
+	{
+		return (-1);
+	}
+
+	minx = maxx = px[0];
+	miny = maxy = py[0];
+	for (i = 1; i < n; i++)
+	{
+		if (px[i] < minx) minx = px[i];
+		if (px[i] > maxx) maxx = px[i];
+		if (py[i] < miny) miny = py[i];
+		if (py[i] > maxy) maxy = py[i];
+	}
+
+	/* Columns cover the whole shape so the running sums stay exact, rows are clipped */
+	bx = (int)floorf(minx);
+	bw = (int)ceilf(maxx) - bx + 1;
+	by = (int)floorf(miny);
+	bh = (int)ceilf(maxy) - by;
+	if (by < clip->y)
+	{
+		bh -= clip->y - by;
+		by = clip->y;
+	}
+	if (by + bh > clip->y + clip->h)
+	{
+		bh = clip->y + clip->h - by;
+	}
+	if (bh <= 0 || bx >= clip->x + clip->w || bx + bw <= clip->x)
+	{
+		return (0);
+	}
+
+	stride = bw + 2;
+	acc = (float *)calloc((size_t)stride * bh, sizeof(float));
+	if (acc == NULL)
+	{
+		return (-1);
+	}
+
+	first = 0;
+	for (c = 0; c < contours; c++)
+	{
+		for (i = 0; i < counts[c]; i++)
+		{
+			j = (i + 1 < counts[c]) ? i + 1 : 0;
+			_coverageEdge(acc, stride, bh,
+				px[first + i] - bx, py[first + i] - by,
+				px[first + j] - bx, py[first + j] - by);
+		}
+		first += counts[c];
+	}
+
+	a = 255 - paint->inv;
+	for (y = 0; y < bh; y++)
+	{
+		pixels = (Uint32 *)((Uint8 *)paint->dst->pixels + (by + y) * paint->dst->pitch);
+		sum = 0.0f;
+		for (x = 0; x < bw; x++)
+		{
+			sum += acc[y * stride + x];
+			if (bx + x < clip->x || bx + x >= clip->x + clip->w)
+			{
+				continue;
+			}
+			coverage = fabsf(sum);
+			if (coverage > 1.0f)
+			{
+				coverage = 1.0f;
+			}
+			k = (Uint32)(coverage * 255.0f + 0.5f);
+			if (k == 0)
+			{
+				continue;
+			}
+			if (k == 255 && !paint->blend)
+			{
+				pixels[bx + x] = paint->color;
+				continue;
+			}
+			/* Scaling the premultiplied color scales its alpha too */
+			alpha = a * k + 128;
+			alpha = (alpha + (alpha >> 8)) >> 8;
+			pixels[bx + x] = _scalePixel(paint->color, k) + _scalePixel(pixels[bx + x], 255 - alpha);
+		}
+	}
+
+	free(acc);
+	return (0);
+}
+
+/*!
+\brief Internal function returning the number of segments to approximate an ellipse for anti-aliasing.
+
+\param rad The largest radius of the ellipse.
+
+\returns Returns the number of segments, the error to the true curve stays under 1/16 of a pixel.
+*/
+static int _coverageSegments(double rad)
+{
+	int segments;
+
+	if (rad <= 1.0)
+	{
+		return (16);
+	}
+	segments = (int)ceil(M_PI / acos(1.0 - 0.0625 / rad));
+	if (segments < 16)
+	{
+		segments = 16;
+	}
+	if (segments > 4096)
+	{
+		segments = 4096;
+	}
+	return (segments);
+}
+
+/*!
+\brief Internal function to build the contour of an ellipse.
+
+\param px X coordinates of the points, must hold the number of segments.
+\param py Y coordinates of the points, must hold the number of segments.
+\param segments Number of segments.
+\param x X coordinate of the center of the ellipse.
+\param y Y coordinate of the center of the ellipse.
+\param rx Horizontal radius of the ellipse.
+\param ry Vertical radius of the ellipse.
+\param reverse Flag indicating if the contour should be wound backwards (=1) to cut a hole.
+*/
+static void _coverageEllipse(float *px, float *py, int segments, double x, double y, double rx, double ry, int reverse)
+{
+	double step, angle, scale;
+	int i;
+
+	/* Grow the inscribed polygon so its area matches the area of the ellipse */
+	step = 2.0 * M_PI / segments;
+	scale = sqrt(step / sin(step));
+	rx *= scale;
+	ry *= scale;
+	if (reverse)
+	{
+		step = -step;
+	}
+	for (i = 0; i < segments; i++)
+	{
+		angle = step * i;
+		px[i] = (float)(x + rx * cos(angle));
+		py[i] = (float)(y + ry * sin(angle));
+	}
+}
+
+/* ---- Pixel */
+
+/*!
+\brief Draw pixel with blending into a surface.
+
+\param dst The surface to draw on.
+\param x X (horizontal) coordinate of the pixel.
+\param y Y (vertical) coordinate of the pixel.
+\param r The red color value of the pixel to draw.
+\param g The green color value of the pixel to draw.
+\param b The blue color value of the pixel to draw.
+\param a The alpha value of the pixel to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfacePixelRGBA(SDL_Surface *dst, Sint16 x, Sint16 y, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	int result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+	_paintSpan(&paint, x, x, y);
+	_paintEnd(&paint);
+	return (0);
+}
+
+/* ---- Hline */
+
+/*!
+\brief Draw horizontal line with blending into a surface.
+
+\param dst The surface to draw on.
+\param x1 X coordinate of the first point (i.e. left) of the line.
+\param x2 X coordinate of the second point (i.e. right) of the line.
+\param y Y coordinate of the points of the line.
+\param r The red value of the line to draw.
+\param g The green value of the line to draw.
+\param b The blue value of the line to draw.
+\param a The alpha value of the line to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceHlineRGBA(SDL_Surface *dst, Sint16 x1, Sint16 x2, Sint16 y, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	int result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+	_paintSpan(&paint, x1, x2, y);
+	_paintEnd(&paint);
+	return (0);
+}
+
+/* ---- Vline */
+
+/*!
+\brief Draw vertical line with blending into a surface.
+
+\param dst The surface to draw on.
+\param x X coordinate of the points of the line.
+\param y1 Y coordinate of the first point (i.e. top) of the line.
+\param y2 Y coordinate of the second point (i.e. bottom) of the line.
+\param r The red value of the line to draw.
+\param g The green value of the line to draw.
+\param b The blue value of the line to draw.
+\param a The alpha value of the line to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceVlineRGBA(SDL_Surface *dst, Sint16 x, Sint16 y1, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	int result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+	_paintBox(&paint, x, y1, x, y2);
+	_paintEnd(&paint);
+	return (0);
+}
+
+/* ---- Rectangle */
+
+/*!
+\brief Draw rectangle with blending into a surface.
+
+\param dst The surface to draw on.
+\param x1 X coordinate of the first point (i.e. top right) of the rectangle.
+\param y1 Y coordinate of the first point (i.e. top right) of the rectangle.
+\param x2 X coordinate of the second point (i.e. bottom left) of the rectangle.
+\param y2 Y coordinate of the second point (i.e. bottom left) of the rectangle.
+\param r The red value of the rectangle to draw.
+\param g The green value of the rectangle to draw.
+\param b The blue value of the rectangle to draw.
+\param a The alpha value of the rectangle to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceRectangleRGBA(SDL_Surface *dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	Sint16 tmp;
+	int result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+
+	if (x1 > x2)
+	{
+		tmp = x1;
+		x1 = x2;
+		x2 = tmp;
+	}
+	if (y1 > y2)
+	{
+		tmp = y1;
+		y1 = y2;
+		y2 = tmp;
+	}
+
+	/* The corners are drawn once so blended rectangles have no darker corners */
+	_paintSpan(&paint, x1, x2, y1);
+	if (y2 > y1)
+	{
+		_paintSpan(&paint, x1, x2, y2);
+	}
+	if (y2 - y1 > 1)
+	{
+		_paintBox(&paint, x1, y1 + 1, x1, y2 - 1);
+		if (x2 > x1)
+		{
+			_paintBox(&paint, x2, y1 + 1, x2, y2 - 1);
+		}
+	}
+
+	_paintEnd(&paint);
+	return (0);
+}
+
+/* ---- Box */
+
+/*!
+\brief Draw box (filled rectangle) with blending into a surface.
+
+\param dst The surface to draw on.
+\param x1 X coordinate of the first point (i.e. top right) of the box.
+\param y1 Y coordinate of the first point (i.e. top right) of the box.
+\param x2 X coordinate of the second point (i.e. bottom left) of the box.
+\param y2 Y coordinate of the second point (i.e. bottom left) of the box.
+\param r The red value of the box to draw.
+\param g The green value of the box to draw.
+\param b The blue value of the box to draw.
+\param a The alpha value of the box to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceBoxRGBA(SDL_Surface *dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	int result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+	_paintBox(&paint, x1, y1, x2, y2);
+	_paintEnd(&paint);
+	return (0);
+}
+
+/* ---- Line */
+
+/*!
+\brief Draw line with blending into a surface.
+
+\param dst The surface to draw on.
+\param x1 X coordinate of the first point of the line.
+\param y1 Y coordinate of the first point of the line.
+\param x2 X coordinate of the second point of the line.
+\param y2 Y coordinate of the second point of the line.
+\param r The red value of the line to draw.
+\param g The green value of the line to draw.
+\param b The blue value of the line to draw.
+\param a The alpha value of the line to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceLineRGBA(SDL_Surface *dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	int result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+	_paintLine(&paint, x1, y1, x2, y2);
+	_paintEnd(&paint);
+	return (0);
+}
+
+/* ---- Thick Line */
+
+/*!
+\brief Draw a thick line with blending into a surface.
+
+\param dst The surface to draw on.
+\param x1 X coordinate of the first point of the line.
+\param y1 Y coordinate of the first point of the line.
+\param x2 X coordinate of the second point of the line.
+\param y2 Y coordinate of the second point of the line.
+\param width Width of the line in pixels. Must be >0.
+\param r The red value of the line to draw.
+\param g The green value of the line to draw.
+\param b The blue value of the line to draw.
+\param a The alpha value of the line to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceThickLineRGBA(SDL_Surface *dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 width, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	int result;
+	int wh;
+	double dx, dy, dx1, dy1, dx2, dy2, l, wl2, nx, ny, ang, adj;
+	Sint16 px[4], py[4];
+
+	if (width < 1)
+	{
+		return (-1);
+	}
+
+	result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+
+	if (x1 == x2 && y1 == y2)
+	{
+		wh = width / 2;
+		_paintBox(&paint, x1 - wh, y1 - wh, x2 + width - wh - 1, y2 + width - wh - 1);
+		_paintEnd(&paint);
+		return (0);
+	}
+	if (width == 1)
+	{
+		_paintLine(&paint, x1, y1, x2, y2);
+		_paintEnd(&paint);
+		return (0);
+	}
+
+	/* Same quad as thickLineRGBA */
+	dx = (double)(x2 - x1);
+	dy = (double)(y2 - y1);
+	l = SDL_sqrt(dx * dx + dy * dy);
+	ang = SDL_atan2(dx, dy);
+	adj = 0.1 + 0.9 * SDL_fabs(SDL_cos(2.0 * ang));
+	wl2 = ((double)width - adj) / (2.0 * l);
+	nx = dx * wl2;
+	ny = dy * wl2;
+
+	dx1 = (double)x1;
+	dy1 = (double)y1;
+	dx2 = (double)x2;
+	dy2 = (double)y2;
+	px[0] = (Sint16)(dx1 + ny);
+	px[1] = (Sint16)(dx1 - ny);
+	px[2] = (Sint16)(dx2 - ny);
+	px[3] = (Sint16)(dx2 + ny);
+	py[0] = (Sint16)(dy1 - nx);
+	py[1] = (Sint16)(dy1 + nx);
+	py[2] = (Sint16)(dy2 + nx);
+	py[3] = (Sint16)(dy2 - nx);
+
+	result = _paintFilledPolygon(&paint, px, py, 4);
+	_paintEnd(&paint);
+	return (result);
+}
+
+/* ---- Circle */
+
+/*!
+\brief Draw circle with blending into a surface.
+
+\param dst The surface to draw on.
+\param x X coordinate of the center of the circle.
+\param y Y coordinate of the center of the circle.
+\param rad Radius in pixels of the circle.
+\param r The red value of the circle to draw.
+\param g The green value of the circle to draw.
+\param b The blue value of the circle to draw.
+\param a The alpha value of the circle to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceCircleRGBA(SDL_Surface *dst, Sint16 x, Sint16 y, Sint16 rad, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	return surfaceThickEllipseRGBA(dst, x, y, rad, rad, r, g, b, a, 1);
+}
+
+/* ---- Filled Circle */
+
+/*!
+\brief Draw filled circle with blending into a surface.
+
+\param dst The surface to draw on.
+\param x X coordinate of the center of the filled circle.
+\param y Y coordinate of the center of the filled circle.
+\param rad Radius in pixels of the filled circle.
+\param r The red value of the filled circle to draw.
+\param g The green value of the filled circle to draw.
+\param b The blue value of the filled circle to draw.
+\param a The alpha value of the filled circle to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceFilledCircleRGBA(SDL_Surface *dst, Sint16 x, Sint16 y, Sint16 rad, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	return surfaceFilledEllipseRGBA(dst, x, y, rad, rad, r, g, b, a);
+}
+
+/* ---- Ellipse */
+
+/*!
+\brief Draw ellipse with blending into a surface.
+
+\param dst The surface to draw on.
+\param x X coordinate of the center of the ellipse.
+\param y Y coordinate of the center of the ellipse.
+\param rx Horizontal radius in pixels of the ellipse.
+\param ry Vertical radius in pixels of the ellipse.
+\param r The red value of the ellipse to draw.
+\param g The green value of the ellipse to draw.
+\param b The blue value of the ellipse to draw.
+\param a The alpha value of the ellipse to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceEllipseRGBA(SDL_Surface *dst, Sint16 x, Sint16 y, Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	return surfaceThickEllipseRGBA(dst, x, y, rx, ry, r, g, b, a, 1);
+}
+
+/* ---- Filled Ellipse */
+
+/*!
+\brief Draw filled ellipse with blending into a surface.
+
+\param dst The surface to draw on.
+\param x X coordinate of the center of the filled ellipse.
+\param y Y coordinate of the center of the filled ellipse.
+\param rx Horizontal radius in pixels of the filled ellipse.
+\param ry Vertical radius in pixels of the filled ellipse.
+\param r The red value of the filled ellipse to draw.
+\param g The green value of the filled ellipse to draw.
+\param b The blue value of the filled ellipse to draw.
+\param a The alpha value of the filled ellipse to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceFilledEllipseRGBA(SDL_Surface *dst, Sint16 x, Sint16 y, Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	int result;
+
+	if (rx < 0 || ry < 0)
+	{
+		return (-1);
+	}
+
+	result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+	_paintRing(&paint, x, y, 0, 0, rx, ry);
+	_paintEnd(&paint);
+	return (0);
+}
+
+/* ---- Thick Ellipse */
+
+/*!
+\brief Draw thick ellipse with blending into a surface.
+
+Note: The thickness is centered on the radii, like thickEllipseRGBA.
+
+\param dst The surface to draw on.
+\param x X coordinate of the center of the ellipse.
+\param y Y coordinate of the center of the ellipse.
+\param rx Horizontal radius in pixels of the ellipse.
+\param ry Vertical radius in pixels of the ellipse.
+\param r The red value of the ellipse to draw.
+\param g The green value of the ellipse to draw.
+\param b The blue value of the ellipse to draw.
+\param a The alpha value of the ellipse to draw.
+\param thick The line thickness in pixels.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceThickEllipseRGBA(SDL_Surface *dst, Sint16 x, Sint16 y, Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a, Uint8 thick)
+{
+	SDL2_gfxSurfacePaint paint;
+	int result;
+	int xi, yi, xo, yo;
+
+	if (rx < 0 || ry < 0 || thick < 1)
+	{
+		return (-1);
+	}
+
+	result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+
+	xi = rx - thick / 2;
+	yi = ry - thick / 2;
+	xo = xi + thick - 1;
+	yo = yi + thick - 1;
+	if (xi < 0)
+	{
+		xi = 0;
+	}
+	if (yi < 0)
+	{
+		yi = 0;
+	}
+	_paintRing(&paint, x, y, xi, yi, xo, yo);
+
+	_paintEnd(&paint);
+	return (0);
+}
+
+/* ---- Filled Polygon */
+
+/*!
+\brief Draw filled polygon with blending into a surface.
+
+\param dst The surface to draw on.
+\param vx Vertex array containing X coordinates of the points of the filled polygon.
+\param vy Vertex array containing Y coordinates of the points of the filled polygon.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param r The red value of the filled polygon to draw.
+\param g The green value of the filled polygon to draw.
+\param b The blue value of the filled polygon to draw.
+\param a The alpha value of the filled polygon to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceFilledPolygonRGBA(SDL_Surface *dst, const Sint16 *vx, const Sint16 *vy, int n, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	int result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+	result = _paintFilledPolygon(&paint, vx, vy, n);
+	_paintEnd(&paint);
+	return (result);
+}
+
+/* ---- AA Filled Polygon */
+
+/*!
+\brief Draw anti-aliased filled polygon with blending into a surface.
+
+Note: The edges go through the centers of the pixels of the vertices.
+
+\param dst The surface to draw on.
+\param vx Vertex array containing X coordinates of the points of the filled polygon.
+\param vy Vertex array containing Y coordinates of the points of the filled polygon.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param r The red value of the filled polygon to draw.
+\param g The green value of the filled polygon to draw.
+\param b The blue value of the filled polygon to draw.
+\param a The alpha value of the filled polygon to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceAAFilledPolygonRGBA(SDL_Surface *dst, const Sint16 *vx, const Sint16 *vy, int n, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	float *px, *py;
+	int i, result;
+
+	if (vx == NULL || vy == NULL || n < 3)
+	{
+		return (-1);
+	}
+
+	result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+
+	px = (float *)malloc(2 * sizeof(float) * n);
+	if (px == NULL)
+	{
+		_paintEnd(&paint);
+		return (-1);
+	}
+	py = px + n;
+	for (i = 0; i < n; i++)
+	{
+		px[i] = vx[i] + 0.5f;
+		py[i] = vy[i] + 0.5f;
+	}
+
+	result = _paintCoverage(&paint, px, py, &n, 1);
+	free(px);
+	_paintEnd(&paint);
+	return (result);
+}
+
+/* ---- AA Filled Circle */
+
+/*!
+\brief Draw anti-aliased filled circle with blending into a surface.
+
+\param dst The surface to draw on.
+\param x X coordinate of the center of the filled circle.
+\param y Y coordinate of the center of the filled circle.
+\param rad Radius in pixels of the filled circle.
+\param r The red value of the filled circle to draw.
+\param g The green value of the filled circle to draw.
+\param b The blue value of the filled circle to draw.
+\param a The alpha value of the filled circle to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceAAFilledCircleRGBA(SDL_Surface *dst, Sint16 x, Sint16 y, Sint16 rad, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	return surfaceAAFilledEllipseRGBA(dst, x, y, rad, rad, r, g, b, a);
+}
+
+/* ---- AA Filled Ellipse */
+
+/*!
+\brief Draw anti-aliased filled ellipse with blending into a surface.
+
+Note: The ellipse covers the same pixels as surfaceFilledEllipseRGBA, with smooth edges.
+
+\param dst The surface to draw on.
+\param x X coordinate of the center of the filled ellipse.
+\param y Y coordinate of the center of the filled ellipse.
+\param rx Horizontal radius in pixels of the filled ellipse.
+\param ry Vertical radius in pixels of the filled ellipse.
+\param r The red value of the filled ellipse to draw.
+\param g The green value of the filled ellipse to draw.
+\param b The blue value of the filled ellipse to draw.
+\param a The alpha value of the filled ellipse to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceAAFilledEllipseRGBA(SDL_Surface *dst, Sint16 x, Sint16 y, Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	float *px, *py;
+	int segments, result;
+
+	if (rx < 0 || ry < 0)
+	{
+		return (-1);
+	}
+
+	result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+
+	segments = _coverageSegments((rx > ry ? rx : ry) + 0.5);
+	px = (float *)malloc(2 * sizeof(float) * segments);
+	if (px == NULL)
+	{
+		_paintEnd(&paint);
+		return (-1);
+	}
+	py = px + segments;
+	_coverageEllipse(px, py, segments, x + 0.5, y + 0.5, rx + 0.5, ry + 0.5, 0);
+
+	result = _paintCoverage(&paint, px, py, &segments, 1);
+	free(px);
+	_paintEnd(&paint);
+	return (result);
+}
+
+/* ---- AA Thick Ellipse */
+
+/*!
+\brief Draw anti-aliased thick ellipse with blending into a surface.
+
+Note: The thickness is centered on the radii, the ring is filled in a single pass as an outer
+contour and an inner contour wound backwards.
+
+\param dst The surface to draw on.
+\param x X coordinate of the center of the ellipse.
+\param y Y coordinate of the center of the ellipse.
+\param rx Horizontal radius in pixels of the ellipse.
+\param ry Vertical radius in pixels of the ellipse.
+\param r The red value of the ellipse to draw.
+\param g The green value of the ellipse to draw.
+\param b The blue value of the ellipse to draw.
+\param a The alpha value of the ellipse to draw.
+\param thick The line thickness in pixels.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceAAThickEllipseRGBA(SDL_Surface *dst, Sint16 x, Sint16 y, Sint16 rx, Sint16 ry, Uint8 r, Uint8 g, Uint8 b, Uint8 a, Uint8 thick)
+{
+	SDL2_gfxSurfacePaint paint;
+	float *px, *py;
+	double half;
+	int counts[2], segments, result;
+
+	if (rx < 0 || ry < 0 || thick < 1)
+	{
+		return (-1);
+	}
+
+	result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+
+	half = thick / 2.0;
+	segments = _coverageSegments((rx > ry ? rx : ry) + half);
+	px = (float *)malloc(4 * sizeof(float) * segments);
+	if (px == NULL)
+	{
+		_paintEnd(&paint);
+		return (-1);
+	}
+	py = px + 2 * segments;
+	counts[0] = segments;
+	counts[1] = 0;
+	_coverageEllipse(px, py, segments, x + 0.5, y + 0.5, rx + half, ry + half, 0);
+	if (rx > half && ry > half)
+	{
+		counts[1] = segments;
+		_coverageEllipse(px + segments, py + segments, segments, x + 0.5, y + 0.5, rx - half, ry - half, 1);
+	}
+
+	result = _paintCoverage(&paint, px, py, counts, counts[1] ? 2 : 1);
+	free(px);
+	_paintEnd(&paint);
+	return (result);
+}
+
+/* ---- AA Thick Line */
+
+/*!
+\brief Draw anti-aliased thick line with blending into a surface.
+
+\param dst The surface to draw on.
+\param x1 X coordinate of the first point of the line.
+\param y1 Y coordinate of the first point of the line.
+\param x2 X coordinate of the second point of the line.
+\param y2 Y coordinate of the second point of the line.
+\param width Width of the line in pixels. Must be >0.
+\param r The red value of the line to draw.
+\param g The green value of the line to draw.
+\param b The blue value of the line to draw.
+\param a The alpha value of the line to draw.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+int surfaceAAThickLineRGBA(SDL_Surface *dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 width, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSurfacePaint paint;
+	float px[4], py[4];
+	double dx, dy, l, nx, ny;
+	int n = 4, result;
+
+	if (width < 1)
+	{
+		return (-1);
+	}
+
+	result = _paintBegin(&paint, dst, r, g, b, a);
+	if (result != 0)
+	{
+		return (result < 0 ? -1 : 0);
+	}
+
+	dx = (double)(x2 - x1);
+	dy = (double)(y2 - y1);
+	l = sqrt(dx * dx + dy * dy);
+	if (l == 0.0)
+	{
+		/* Thick "point" */
+		dx = 1.0;
+		dy = 0.0;
+		l = 1.0;
+	}
+	nx = -dy / l * width / 2.0;
+	ny = dx / l * width / 2.0;
+
+	px[0] = (float)(x1 + 0.5 + nx);
+	py[0] = (float)(y1 + 0.5 + ny);
+	px[1] = (float)(x2 + 0.5 + nx);
+	py[1] = (float)(y2 + 0.5 + ny);
+	px[2] = (float)(x2 + 0.5 - nx);
+	py[2] = (float)(y2 + 0.5 - ny);
+	px[3] = (float)(x1 + 0.5 - nx);
+	py[3] = (float)(y1 + 0.5 - ny);
+	if (x1 == x2 && y1 == y2)
+	{
+		px[0] -= width / 2.0f;
+		px[3] -= width / 2.0f;
+		px[1] += width / 2.0f;
+		px[2] += width / 2.0f;
+	}
+
+	result = _paintCoverage(&paint, px, py, &n, 1);
+	_paintEnd(&paint);
+	return (result);
+}
@@ -36,6 +36,11 @@ Andreas Schiffler -- aschiffler at ferzkopp dot net
 
 #include "SDL2_rotozoom.h"
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ROTOZOOM_X86
+#include <emmintrin.h>
+#endif
+
 /* ---- Internally used structures */
 
 /*!
@@ -77,6 +82,14 @@ to a situation where the program can segfault.
 */
 #define VALUE_LIMIT	0.001
 
+/*!
+\brief Width in bytes of the square tiles used by the 90 degree rotator.
+
+A tile row fills one cache line on both sides of the transpose. The destination lines of a tile
+stay in cache while it is copied, so neither side is read or written with a cold stride.
+*/
+#define ROTATE_TILE_BYTES 64
+
 /*!
 \brief Returns colorkey info for a surface
 */
@@ -87,6 +100,254 @@ Uint32 _colorkey(SDL_Surface *src)
 	return key;
 }
 
+/*!
+\brief Number of 32 bit conversions kept by the conversion cache.
+*/
+#define CONVERT_CACHE_SIZE 16
+
+/*!
+\brief A cached 32 bit copy of a surface that is neither 8 bit nor 32 bit.
+
+The entry holds a reference on the source surface so its address cannot be reused while it
+is cached. The pixel pointer, size, pitch and format are kept as a signature of the source,
+the pixel values are not: a source redrawn in place must be passed to rotozoomInvalidateSurface().
+*/
+typedef struct tConvertCache {
+	SDL_Surface *src;
+	SDL_Surface *dst;
+	void *pixels;
+	Uint32 format;
+	int w;
+	int h;
+	int pitch;
+	Uint32 used;
+} tConvertCache;
+
+/*!
+\brief The conversion cache, its LRU clock and the mutex guarding both.
+*/
+static tConvertCache _convertCache[CONVERT_CACHE_SIZE];
+static Uint32 _convertClock = 0;
+static SDL_mutex *_convertMutex = NULL;
+static SDL_SpinLock _convertMutexLock = 0;
+
+/*!
+\brief Locks the conversion cache, creating its mutex on first use.
+
+\return 0 on success or -1 if the mutex cannot be created.
+*/
+static int _convertLock(void)
+{
+	SDL_mutex *mutex;
+
+	SDL_AtomicLock(&_convertMutexLock);
+	if (_convertMutex == NULL) {
+		_convertMutex = SDL_CreateMutex();
+	}
+	mutex = _convertMutex;
+	SDL_AtomicUnlock(&_convertMutexLock);
+	if (mutex == NULL) {
+		return (-1);
+	}
+	return (SDL_LockMutex(mutex));
+}
+
+/*!
+\brief Drops a conversion cache entry and the reference it holds on its source.
+*/
+static void _convertRelease(tConvertCache *entry)
+{
+	SDL_FreeSurface(entry->dst);
+	SDL_FreeSurface(entry->src);
+	memset(entry, 0, sizeof(tConvertCache));
+}
+
+/*!
+\brief Returns a 32 bit RGBA copy of 'src', converting it only when no valid copy is cached.
+
+Entries whose source was freed by the caller (only the cache reference is left) are released
+first. An entry whose source changed its pixels, size, pitch or format is converted again.
+The returned surface holds a reference for the caller, who frees it with SDL_FreeSurface()
+once done, so another thread evicting the entry meanwhile cannot free it.
+
+\param src The surface to convert.
+
+\return The converted surface or NULL on error.
+*/
+static SDL_Surface *_convertSurface(SDL_Surface * src)
+{
+	tConvertCache *entry, *slot;
+	SDL_Surface *dst;
+	int i;
+
+	if (_convertLock() < 0) {
+		return (NULL);
+	}
+	slot = NULL;
+	for (i = 0; i < CONVERT_CACHE_SIZE; i++) {
+		entry = &_convertCache[i];
+		if ((entry->src != NULL) && (entry->src->refcount <= 1)) {
+			_convertRelease(entry);
+		}
+		if (entry->src == src) {
+			slot = entry;
+		}
+	}
+
+	_convertClock++;
+	if (slot != NULL) {
+		if ((slot->pixels == src->pixels) && (slot->format == src->format->format) &&
+			(slot->w == src->w) && (slot->h == src->h) && (slot->pitch == src->pitch)) {
+			slot->used = _convertClock;
+			slot->dst->refcount++;
+			dst = slot->dst;
+			SDL_UnlockMutex(_convertMutex);
+			return (dst);
+		}
+		_convertRelease(slot);
+	} else {
+		/*
+		* Take a free entry or evict the least recently used one
+		*/
+		slot = &_convertCache[0];
+		for (i = 0; i < CONVERT_CACHE_SIZE; i++) {
+			entry = &_convertCache[i];
+			if (entry->src == NULL) {
+				slot = entry;
+				break;
+			}
+			if (entry->used < slot->used) {
+				slot = entry;
+			}
+		}
+		if (slot->src != NULL) {
+			_convertRelease(slot);
+		}
+	}
+
+	/*
+	* New surface is 32bit with a defined RGBA ordering
+	*/
+	slot->dst = SDL_CreateRGBSurface(SDL_SWSURFACE, src->w, src->h, 32, 
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+		0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#else
+		0xff000000,  0x00ff0000, 0x0000ff00, 0x000000ff
+#endif
+		);
+	if (slot->dst == NULL) {
+		SDL_UnlockMutex(_convertMutex);
+		return (NULL);
+	}
+	SDL_BlitSurface(src, NULL, slot->dst, NULL);
+
+	src->refcount++;
+	slot->src = src;
+	slot->pixels = src->pixels;
+	slot->format = src->format->format;
+	slot->w = src->w;
+	slot->h = src->h;
+	slot->pitch = src->pitch;
+	slot->used = _convertClock;
+	slot->dst->refcount++;
+	dst = slot->dst;
+	SDL_UnlockMutex(_convertMutex);
+
+	return (dst);
+}
+
+/*!
+\brief Drops the cached 32 bit conversion of a surface.
+
+rotozoomSurfaceXY(), zoomSurface() and shrinkSurface() keep the 32 bit copy of sources that
+are neither 8 bit nor 32 bit. Changes to the pixel values are not detected: this must be
+called after writing new pixels into such a source, otherwise the next call uses the old
+pixels. Freeing the source afterwards releases it at once instead of at the next call.
+
+\param src The surface whose conversion should be dropped.
+*/
+void rotozoomInvalidateSurface(SDL_Surface * src)
+{
+	int i;
+
+	if ((src == NULL) || (_convertLock() < 0)) {
+		return;
+	}
+	for (i = 0; i < CONVERT_CACHE_SIZE; i++) {
+		if (_convertCache[i].src == src) {
+			_convertRelease(&_convertCache[i]);
+		}
+	}
+	SDL_UnlockMutex(_convertMutex);
+}
+
+/*!
+\brief Drops every cached 32 bit conversion and the references held on their sources.
+
+A cached source freed by the caller stays allocated until the next rotozoomSurfaceXY(),
+zoomSurface() or shrinkSurface() call, or until this is called.
+*/
+void rotozoomClearCache(void)
+{
+	int i;
+
+	if (_convertLock() < 0) {
+		return;
+	}
+	for (i = 0; i < CONVERT_CACHE_SIZE; i++) {
+		if (_convertCache[i].src != NULL) {
+			_convertRelease(&_convertCache[i]);
+		}
+	}
+	SDL_UnlockMutex(_convertMutex);
+}
+
+
+#ifdef ROTOZOOM_X86
+/*!
+\brief Internal 32 bit 2x2 averaging shrinker using SSE2.
+
+Handles the common halving case of _shrinkSurfaceRGBA(), two destination pixels per step.
+The channel sums are divided by 4 with a truncating shift, so the result matches the
+portable shrinker exactly.
+
+\param src The surface to shrink (input).
+\param dst The shrunken surface (output).
+*/
+__attribute__((target("sse2")))
+static void _shrinkSurface2x2RGBASSE2(SDL_Surface * src, SDL_Surface * dst)
+{
+	int x, y, i, sum;
+	const Uint8 *sp0, *sp1;
+	Uint8 *dp;
+	__m128i zero, a, b, lo, hi;
+
+	zero = _mm_setzero_si128();
+	for (y = 0; y < dst->h; y++) {
+		sp0 = (const Uint8 *) src->pixels + (2 * y) * src->pitch;
+		sp1 = sp0 + src->pitch;
+		dp = (Uint8 *) dst->pixels + y * dst->pitch;
+
+		for (x = 0; x + 2 <= dst->w; x += 2) {
+			a = _mm_loadu_si128((const __m128i *) (sp0 + 8 * x));
+			b = _mm_loadu_si128((const __m128i *) (sp1 + 8 * x));
+			lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+			hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+			lo = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+			lo = _mm_srli_epi16(lo, 2);
+			_mm_storel_epi64((__m128i *) (dp + 4 * x), _mm_packus_epi16(lo, lo));
+		}
+
+		/* Odd last column */
+		for (; x < dst->w; x++) {
+			for (i = 0; i < 4; i++) {
+				sum = sp0[8 * x + i] + sp0[8 * x + 4 + i] + sp1[8 * x + i] + sp1[8 * x + 4 + i];
+				dp[4 * x + i] = (Uint8) (sum >> 2);
+			}
+		}
+	}
+}
+#endif
 
 /*! 
 \brief Internal 32 bit integer-factor averaging Shrinker.
@@ -110,6 +371,16 @@ int _shrinkSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int factorx, int fa
 	tColorRGBA *sp, *osp, *oosp;
 	tColorRGBA *dp;
 
+#ifdef ROTOZOOM_X86
+	/*
+	* Halving fast path (mip chains)
+	*/
+	if ((factorx == 2) && (factory == 2) && SDL_HasSSE2()) {
+		_shrinkSurface2x2RGBASSE2(src, dst);
+		return (0);
+	}
+#endif
+
 	/*
 	* Averaging integer shrink
 	*/
@@ -787,6 +1058,137 @@ void transformSurfaceY(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int
 	}
 }
 
+/*!
+\brief Internal tiled 90 degree rotators for 8, 16 and 32 bit pixels.
+
+Copies the 'w' x 'h' pixels of 'src' so that the source pixel at (col, row) lands at
+'origin' + col * 'dcol' + row * 'drow' in the destination, one 'tile' x 'tile' block at a time.
+*/
+#define ROTATE_TILED(NAME, TYPE) \
+static void NAME(const Uint8 *src, int spitch, int w, int h, Uint8 *origin, int dcol, int drow, int tile) \
+{ \
+	int bx, by, row, col, ex, ey; \
+	const TYPE *sp; \
+	Uint8 *dp; \
+	for (by = 0; by < h; by += tile) { \
+		ey = (by + tile < h) ? by + tile : h; \
+		for (bx = 0; bx < w; bx += tile) { \
+			ex = (bx + tile < w) ? bx + tile : w; \
+			for (row = by; row < ey; row++) { \
+				sp = (const TYPE *)(src + row * spitch) + bx; \
+				dp = origin + row * drow + bx * dcol; \
+				for (col = bx; col < ex; col++) { \
+					*(TYPE *)dp = *sp++; \
+					dp += dcol; \
+				} \
+			} \
+		} \
+	} \
+}
+
+ROTATE_TILED(_rotateTiled8, Uint8)
+ROTATE_TILED(_rotateTiled16, Uint16)
+ROTATE_TILED(_rotateTiled32, Uint32)
+
+/*!
+\brief Internal tiled 90 degree rotator for 24 bit pixels.
+
+Same as the other tiled rotators, with pixels copied as 3 bytes.
+*/
+static void _rotateTiled24(const Uint8 *src, int spitch, int w, int h, Uint8 *origin, int dcol, int drow, int tile)
+{
+	int bx, by, row, col, ex, ey;
+	const Uint8 *sp;
+	Uint8 *dp;
+	for (by = 0; by < h; by += tile) {
+		ey = (by + tile < h) ? by + tile : h;
+		for (bx = 0; bx < w; bx += tile) {
+			ex = (bx + tile < w) ? bx + tile : w;
+			for (row = by; row < ey; row++) {
+				sp = src + row * spitch + bx * 3;
+				dp = origin + row * drow + bx * dcol;
+				for (col = bx; col < ex; col++) {
+					dp[0] = sp[0];
+					dp[1] = sp[1];
+					dp[2] = sp[2];
+					sp += 3;
+					dp += dcol;
+				}
+			}
+		}
+	}
+}
+
+#ifdef ROTOZOOM_X86
+/*!
+\brief Internal tiled 90 degree rotator for 32 bit pixels using SSE2 4x4 transposes.
+
+Only valid for quarter turns, where consecutive source rows land in neighbouring destination
+pixels ('drow' is 4 or -4) and 'tile' is a multiple of 4. The borders of tiles that do not hold whole 4x4 blocks are copied
+one pixel at a time.
+*/
+__attribute__((target("sse2")))
+static void _rotateTiled32SSE2(const Uint8 *src, int spitch, int w, int h, Uint8 *origin, int dcol, int drow, int tile)
+{
+	int bx, by, row, col, ex, ey, ex4, ey4, i;
+	__m128i a, b, c, d, t0, t1, t2, t3, v[4];
+	const Uint8 *sp;
+	Uint8 *dp;
+	for (by = 0; by < h; by += tile) {
+		ey = (by + tile < h) ? by + tile : h;
+		ey4 = by + ((ey - by) & ~3);
+		for (bx = 0; bx < w; bx += tile) {
+			ex = (bx + tile < w) ? bx + tile : w;
+			ex4 = bx + ((ex - bx) & ~3);
+			for (row = by; row < ey4; row += 4) {
+				for (col = bx; col < ex4; col += 4) {
+					sp = src + row * spitch + col * 4;
+					a = _mm_loadu_si128((const __m128i *)sp);
+					b = _mm_loadu_si128((const __m128i *)(sp + spitch));
+					c = _mm_loadu_si128((const __m128i *)(sp + 2 * spitch));
+					d = _mm_loadu_si128((const __m128i *)(sp + 3 * spitch));
+					t0 = _mm_unpacklo_epi32(a, b);
+					t1 = _mm_unpacklo_epi32(c, d);
+					t2 = _mm_unpackhi_epi32(a, b);
+					t3 = _mm_unpackhi_epi32(c, d);
+					/* v[i] holds source column col + i, rows row to row + 3 */
+					v[0] = _mm_unpacklo_epi64(t0, t1);
+					v[1] = _mm_unpackhi_epi64(t0, t1);
+					v[2] = _mm_unpacklo_epi64(t2, t3);
+					v[3] = _mm_unpackhi_epi64(t2, t3);
+					for (i = 0; i < 4; i++) {
+						dp = origin + row * drow + (col + i) * dcol;
+						if (drow < 0) {
+							_mm_storeu_si128((__m128i *)(dp + 3 * drow), _mm_shuffle_epi32(v[i], _MM_SHUFFLE(0, 1, 2, 3)));
+						} else {
+							_mm_storeu_si128((__m128i *)dp, v[i]);
+						}
+					}
+				}
+				for (i = 0; i < 4; i++) {
+					sp = src + (row + i) * spitch + ex4 * 4;
+					dp = origin + (row + i) * drow + ex4 * dcol;
+					for (col = ex4; col < ex; col++) {
+						*(Uint32 *)dp = *(const Uint32 *)sp;
+						sp += 4;
+						dp += dcol;
+					}
+				}
+			}
+			for (row = ey4; row < ey; row++) {
+				sp = src + row * spitch + bx * 4;
+				dp = origin + row * drow + bx * dcol;
+				for (col = bx; col < ex; col++) {
+					*(Uint32 *)dp = *(const Uint32 *)sp;
+					sp += 4;
+					dp += dcol;
+				}
+			}
+		}
+	}
+}
+#endif
+
 /*!
 \brief Rotates a 8/16/24/32 bit surface in increments of 90 degrees.
 
@@ -802,8 +1204,8 @@ no scanning or interpolation takes place. Input surface must be 8/16/24/32 bit.
 */
 SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns) 
 {
-	int row, col, newWidth, newHeight;
-	int bpp, bpr;
+	int row, newWidth, newHeight;
+	int bpp, bpr, dcol, drow, tile;
 	SDL_Surface* dst;
 	Uint8* srcBuf;
 	Uint8* dstBuf;
@@ -882,50 +1284,52 @@ SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns)
 		break;
 
 		/* rotate clockwise */
-	case 1: /* rotated 90 degrees clockwise */
-		{
-			for (row = 0; row < src->h; ++row) {
-				srcBuf = (Uint8*)(src->pixels) + (row * src->pitch);
-				dstBuf = (Uint8*)(dst->pixels) + (dst->w - row - 1) * bpp;
-				for (col = 0; col < src->w; ++col) {
-					memcpy (dstBuf, srcBuf, bpp);
-					srcBuf += bpp;
-					dstBuf += dst->pitch;
-				} 
-			} 
-		}
+	case 1: /* rotated 90 degrees clockwise: source (col, row) goes to (h - 1 - row, col) */
+		dstBuf = (Uint8*)(dst->pixels) + (dst->w - 1) * bpp;
+		dcol = dst->pitch;
+		drow = -bpp;
 		break;
 
-	case 2: /* rotated 180 degrees clockwise */
-		{
-			for (row = 0; row < src->h; ++row) {
-				srcBuf = (Uint8*)(src->pixels) + (row * src->pitch);
-				dstBuf = (Uint8*)(dst->pixels) + ((dst->h - row - 1) * dst->pitch) + (dst->w - 1) * bpp;
-				for (col = 0; col < src->w; ++col) {
-					memcpy (dstBuf, srcBuf, bpp);
-					srcBuf += bpp;
-					dstBuf -= bpp;
-				} 
-			} 
-		}
+	case 2: /* rotated 180 degrees clockwise: source (col, row) goes to (w - 1 - col, h - 1 - row) */
+		dstBuf = (Uint8*)(dst->pixels) + ((dst->h - 1) * dst->pitch) + (dst->w - 1) * bpp;
+		dcol = -bpp;
+		drow = -dst->pitch;
 		break;
 
-	case 3: /* rotated 270 degrees clockwise */
-		{
-			for (row = 0; row < src->h; ++row) {
-				srcBuf = (Uint8*)(src->pixels) + (row * src->pitch);
-				dstBuf = (Uint8*)(dst->pixels) + (row * bpp) + ((dst->h - 1) * dst->pitch);
-				for (col = 0; col < src->w; ++col) {
-					memcpy (dstBuf, srcBuf, bpp);
-					srcBuf += bpp;
-					dstBuf -= dst->pitch;
-				} 
-			} 
-		}
+	case 3: /* rotated 270 degrees clockwise: source (col, row) goes to (row, w - 1 - col) */
+		dstBuf = (Uint8*)(dst->pixels) + ((dst->h - 1) * dst->pitch);
+		dcol = -dst->pitch;
+		drow = bpp;
 		break;
 	} 
 	/* end switch */
 
+	if (normalizedClockwiseTurns != 0) {
+		/* Half turns keep rows contiguous and need no tiling */
+		srcBuf = (Uint8*)(src->pixels);
+		tile = (normalizedClockwiseTurns == 2) ? MAX(src->w, src->h) : ROTATE_TILE_BYTES / bpp;
+		switch (bpp) {
+		case 1:
+			_rotateTiled8(srcBuf, src->pitch, src->w, src->h, dstBuf, dcol, drow, tile);
+			break;
+		case 2:
+			_rotateTiled16(srcBuf, src->pitch, src->w, src->h, dstBuf, dcol, drow, tile);
+			break;
+		case 3:
+			_rotateTiled24(srcBuf, src->pitch, src->w, src->h, dstBuf, dcol, drow, tile);
+			break;
+		case 4:
+#ifdef ROTOZOOM_X86
+			if (normalizedClockwiseTurns != 2 && SDL_HasSSE2()) {
+				_rotateTiled32SSE2(srcBuf, src->pitch, src->w, src->h, dstBuf, dcol, drow, tile);
+				break;
+			}
+#endif
+			_rotateTiled32(srcBuf, src->pitch, src->w, src->h, dstBuf, dcol, drow, tile);
+			break;
+		}
+	}
+
 	if (SDL_MUSTLOCK(src)) {
 		SDL_UnlockSurface(src);
 	}
@@ -1023,7 +1427,9 @@ void rotozoomSurfaceSize(int width, int height, double angle, double zoom, int *
 Rotates and zoomes a 32bit or 8bit 'src' surface to newly created 'dst' surface.
 'angle' is the rotation in degrees and 'zoom' a scaling factor. If 'smooth' is set
 then the destination 32bit surface is anti-aliased. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format once and the
+conversion is cached until the source is resized or rotozoomInvalidateSurface() is called.
+The cache does not see pixels written in place, see rotozoomInvalidateSurface().
 
 \param src The surface to rotozoom.
 \param angle The angle to rotate in degrees.
@@ -1043,7 +1449,9 @@ SDL_Surface *rotozoomSurface(SDL_Surface * src, double angle, double zoom, int s
 Rotates and zooms a 32bit or 8bit 'src' surface to newly created 'dst' surface.
 'angle' is the rotation in degrees, 'zoomx and 'zoomy' scaling factors. If 'smooth' is set
 then the destination 32bit surface is anti-aliased. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format once and the
+conversion is cached until the source is resized or rotozoomInvalidateSurface() is called.
+The cache does not see pixels written in place, see rotozoomInvalidateSurface().
 
 \param src The surface to rotozoom.
 \param angle The angle to rotate in degrees.
@@ -1083,19 +1491,12 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 		src_converted = 0;
 	} else {
 		/*
-		* New source surface is 32bit with a defined RGBA ordering 
+		* Use the cached 32bit RGBA conversion of the source surface 
 		*/
-		rz_src =
-			SDL_CreateRGBSurface(SDL_SWSURFACE, src->w, src->h, 32, 
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-			0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
-#else
-			0xff000000,  0x00ff0000, 0x0000ff00, 0x000000ff
-#endif
-			);
-
-		SDL_BlitSurface(src, NULL, rz_src, NULL);
-
+		rz_src = _convertSurface(src);
+		if (rz_src == NULL) {
+			return (NULL);
+		}
 		src_converted = 1;
 		is32bit = 1;
 	}
@@ -1158,8 +1559,12 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 		}
 
 		/* Check target */
-		if (rz_dst == NULL)
+		if (rz_dst == NULL) {
+			if (src_converted) {
+				SDL_FreeSurface(rz_src);
+			}
 			return NULL;
+		}
 
 		/* Adjust for guard rows */
 		rz_dst->h = dstheight;
@@ -1238,8 +1643,12 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 		}
 
 		/* Check target */
-		if (rz_dst == NULL)
+		if (rz_dst == NULL) {
+			if (src_converted) {
+				SDL_FreeSurface(rz_src);
+			}
 			return NULL;
+		}
 
 		/* Adjust for guard rows */
 		rz_dst->h = dstheight;
@@ -1284,7 +1693,7 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 	}
 
 	/*
-	* Cleanup temp surface 
+	* Release the cached conversion 
 	*/
 	if (src_converted) {
 		SDL_FreeSurface(rz_src);
@@ -1348,7 +1757,9 @@ void zoomSurfaceSize(int width, int height, double zoomx, double zoomy, int *dst
 Zooms a 32bit or 8bit 'src' surface to newly created 'dst' surface.
 'zoomx' and 'zoomy' are scaling factors for width and height. If 'smooth' is on
 then the destination 32bit surface is anti-aliased. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format once and the
+conversion is cached until the source is resized or rotozoomInvalidateSurface() is called.
+The cache does not see pixels written in place, see rotozoomInvalidateSurface().
 If zoom factors are negative, the image is flipped on the axes.
 
 \param src The surface to zoom.
@@ -1385,20 +1796,12 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 		src_converted = 0;
 	} else {
 		/*
-		* New source surface is 32bit with a defined RGBA ordering 
+		* Use the cached 32bit RGBA conversion of the source surface 
 		*/
-		rz_src =
-			SDL_CreateRGBSurface(SDL_SWSURFACE, src->w, src->h, 32, 
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-			0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
-#else
-			0xff000000,  0x00ff0000, 0x0000ff00, 0x000000ff
-#endif
-			);
+		rz_src = _convertSurface(src);
 		if (rz_src == NULL) {
 			return NULL;
 		}
-		SDL_BlitSurface(src, NULL, rz_src, NULL);
 		src_converted = 1;
 		is32bit = 1;
 	}
@@ -1432,12 +1835,9 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 
 	/* Check target */
 	if (rz_dst == NULL) {
-		/*
-		* Cleanup temp surface 
-		*/
 		if (src_converted) {
 			SDL_FreeSurface(rz_src);
-		}		
+		}
 		return NULL;
 	}
 
@@ -1480,7 +1880,7 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 	}
 
 	/*
-	* Cleanup temp surface 
+	* Release the cached conversion 
 	*/
 	if (src_converted) {
 		SDL_FreeSurface(rz_src);
@@ -1499,7 +1899,9 @@ Shrinks a 32bit or 8bit 'src' surface to a newly created 'dst' surface.
 'factorx' and 'factory' are the shrinking ratios (i.e. 2=1/2 the size,
 3=1/3 the size, etc.) The destination surface is antialiased by averaging
 the source box RGBA or Y information. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format once and the
+conversion is cached until the source is resized or rotozoomInvalidateSurface() is called.
+The cache does not see pixels written in place, see rotozoomInvalidateSurface().
 The input surface is not modified. The output surface is newly allocated.
 
 \param src The surface to shrink.
@@ -1516,8 +1918,9 @@ SDL_Surface *shrinkSurface(SDL_Surface *src, int factorx, int factory)
 	SDL_Surface *rz_dst = NULL;
 	int dstwidth, dstheight;
 	int is32bit;
-	int i, src_converted;
+	int i;
 	int haveError = 0;
+	int src_converted = 0;
 
 	/*
 	* Sanity check 
@@ -1535,24 +1938,15 @@ SDL_Surface *shrinkSurface(SDL_Surface *src, int factorx, int factory)
 		* Use source surface 'as is' 
 		*/
 		rz_src = src;
-		src_converted = 0;
 	} else {
 		/*
-		* New source surface is 32bit with a defined RGBA ordering 
+		* Use the cached 32bit RGBA conversion of the source surface 
 		*/
-		rz_src = SDL_CreateRGBSurface(SDL_SWSURFACE, src->w, src->h, 32, 
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-			0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
-#else
-			0xff000000,  0x00ff0000, 0x0000ff00, 0x000000ff
-#endif
-			);
+		rz_src = _convertSurface(src);
 		if (rz_src==NULL) {
 			haveError = 1;
 			goto exitShrinkSurface;
 		}
-
-		SDL_BlitSurface(src, NULL, rz_src, NULL);
 		src_converted = 1;
 		is32bit = 1;
 	}
@@ -1641,7 +2035,7 @@ exitShrinkSurface:
 		}
 
 		/*
-		* Cleanup temp surface 
+		* Release the cached conversion 
 		*/
 		if (src_converted==1) {
 			SDL_FreeSurface(rz_src);
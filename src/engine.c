@@ -1,16 +1,88 @@
 #include "engine.h"
+#include "SDL2_gfxSurface.h"
+#include "SDL2_rotozoom.h"
+#include <math.h>
+
+#define FRAME_ARENA_SIZE 65536
+#define FRAME_ARENA_ALIGN 16
+#define INTERN_BLOCK_SIZE 65536
+#define INTERN_TABLE_SIZE 1024
+#define ANIMATION_STATES_SIZE 64
+#define GEOMETRY_BUFFER_SIZE 1024
+#define UI_DRAWS_SIZE 64
+#define UI_TEXT_LIFETIME 120
+#define GLYPH_ATLAS_SIZE 1024
+#define GLYPH_TABLE_SIZE 512
+#define GLYPH_SHELF_ROUND 8
+#define LAYOUT_CACHE_SIZE 256
+#define LAYOUT_LIFETIME 120
 
 static Engine *_engine = NULL;
 static ObjectList *_object_list = NULL;
+static int _object_count = 0;
 static ObjectTemplateList *_object_template_list = NULL;
 static TextureList *_texture_list = NULL;
 static Audiolist *_audio_list = NULL;
 static Font *_font = NULL;
+static FontFace *_font_faces = NULL;
 static SDL_Event _event;
 static Color _color = {0, 0, 0, 255};
 static Color _clear_color = {0, 0, 0, 255};
 static bool _manual_update_frame = false;
 static bool _update_frame = true; // set to true to draw the first frame
+static FrameArena _frame_arena = {NULL, 0, 0, NULL, 0};
+static Pool _texture_list_pool = {sizeof(TextureList), 64, NULL, NULL};
+static Pool _object_list_pool = {sizeof(ObjectList), 256, NULL, NULL};
+static Pool _object_template_list_pool = {sizeof(ObjectTemplateList), 64, NULL, NULL};
+static Pool _audio_list_pool = {sizeof(Audiolist), 32, NULL, NULL};
+static Pool _font_pool = {sizeof(Font), 16, NULL, NULL};
+static Pool _layer_pool = {sizeof(Layer), 16, NULL, NULL};
+static InternTable _intern_table = {NULL, NULL, 0, 0, NULL, 0, 0};
+static AnimationStates _animations = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, -1};
+static ParticleEmitter *_particle_emitters = NULL;
+static GeometryBuffer _geometry_batch = {NULL, 0, 0, NULL, 0, 0};
+static bool _antialiasing = false;
+static SDL_Surface *_render_surface = NULL;
+static bool _mipmaps = true;
+static MipChainTable _mip_chains = {NULL, NULL, 0, 0};
+static Uint64 _frame_count = 0;
+static StreamedTexture *_streamed_textures = NULL;
+static StreamedTexture *_stream_jobs = NULL;
+static StreamedTexture *_stream_jobs_tail = NULL;
+static StreamedTexture *_stream_current = NULL;
+static SDL_Thread *_stream_thread = NULL;
+static SDL_mutex *_stream_mutex = NULL;
+static SDL_cond *_stream_cond = NULL;
+static bool _stream_quit = false;
+static size_t _texture_budget = (size_t)256 * 1024 * 1024;
+static size_t _resident_texture_bytes = 0;
+static Layer *_layers = NULL;
+static Layer *_active_layer = NULL;
+static Input _input = {0, 0, 0, 0, 0, 0};
+static UIStyle _ui_style = {{32, 32, 40, 224}, {64, 64, 80, 255}, {88, 88, 108, 255}, {48, 48, 60, 255}, {72, 72, 90, 255}, {56, 96, 160, 255}, {235, 235, 235, 255}};
+static UITextTable _ui_texts = {NULL, 0, 0};
+static UITextDraw *_ui_draws = NULL;
+static int _ui_nb_draws = 0;
+static int _ui_draws_capacity = 0;
+static Font *_ui_font = NULL;
+static const char *_ui_active = NULL;
+static int _ui_active_index = -1;
+static GlyphAtlas _glyph_atlas;
+static TextLayout *_text_layouts[LAYOUT_CACHE_SIZE];
+static Uint64 _text_layouts_swept = 0;
+static int *_text_indices = NULL;
+static int _text_indices_capacity = 0;
+
+
+static void _update_animations(int dt);
+static void _update_particles(int dt);
+static void _update_texture_residency();
+static void _stream_thread_quit();
+static void _mip_chain_table_destroy();
+static void _input_handle_event(const SDL_Event *event);
+static void _text_cache_destroy();
+static void _glyph_atlas_clear();
+static void _ui_purge_texts(Font *font);
 
 static void _assert_engine_init() {
     if (_engine == NULL) {
@@ -19,6 +91,281 @@ static void _assert_engine_init() {
     }
 }
 
+/***********************************************
+ * Memory functions
+ ***********************************************/
+
+/**
+ * Allocates the memory block of the frame arena
+ * \param size The size of the memory block
+ */
+static void _frame_arena_init(size_t size) {
+    _frame_arena.buffer = (unsigned char *)malloc(size);
+    if (_frame_arena.buffer == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for frame arena\n");
+        exit(1);
+    }
+    _frame_arena.size = size;
+    _frame_arena.offset = 0;
+    _frame_arena.overflow = NULL;
+    _frame_arena.overflow_size = 0;
+}
+
+/**
+ * Resets the frame arena, invalidating every pointer returned by `engine_frame_alloc`
+ * \note If the last frame overflowed, the memory block is grown to fit it, so steady-state frames never touch the heap
+ */
+static void _frame_arena_reset() {
+    size_t used = _frame_arena.offset + _frame_arena.overflow_size;
+
+    while (_frame_arena.overflow != NULL) {
+        void *next = *(void **)_frame_arena.overflow;
+        free(_frame_arena.overflow);
+        _frame_arena.overflow = next;
+    }
+    _frame_arena.overflow_size = 0;
+    _frame_arena.offset = 0;
+
+    if (used > _frame_arena.size) {
+        size_t size = _frame_arena.size;
+        while (size < used) size *= 2;
+        free(_frame_arena.buffer);
+        _frame_arena_init(size);
+    }
+}
+
+/**
+ * Frees the memory of the frame arena
+ */
+static void _frame_arena_destroy() {
+    _frame_arena_reset();
+    free(_frame_arena.buffer);
+    _frame_arena.buffer = NULL;
+    _frame_arena.size = 0;
+}
+
+/**
+ * Allocates an item from a pool
+ * \param pool The pool to allocate from
+ * \return The item
+ */
+static void *_pool_alloc(Pool *pool) {
+    if (pool->free_list == NULL) {
+        // A block is a pointer to the next block followed by the items
+        size_t header = (sizeof(void *) + FRAME_ARENA_ALIGN - 1) & ~(size_t)(FRAME_ARENA_ALIGN - 1);
+        unsigned char *block = (unsigned char *)malloc(header + pool->item_size * pool->items_per_block);
+        if (block == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to allocate memory for pool block\n");
+            exit(1);
+        }
+        *(void **)block = pool->blocks;
+        pool->blocks = block;
+
+        for (int i = pool->items_per_block - 1; i >= 0; i--) {
+            void *item = block + header + pool->item_size * i;
+            *(void **)item = pool->free_list;
+            pool->free_list = item;
+        }
+    }
+
+    void *item = pool->free_list;
+    pool->free_list = *(void **)item;
+    return item;
+}
+
+/**
+ * Returns an item to its pool
+ * \param pool The pool of the item
+ * \param item The item to free
+ */
+static void _pool_free(Pool *pool, void *item) {
+    if (item == NULL) return;
+    *(void **)item = pool->free_list;
+    pool->free_list = item;
+}
+
+/**
+ * Frees every block of a pool
+ * \param pool The pool to destroy
+ * \warning Every item allocated from the pool becomes invalid
+ */
+static void _pool_destroy(Pool *pool) {
+    while (pool->blocks != NULL) {
+        void *next = *(void **)pool->blocks;
+        free(pool->blocks);
+        pool->blocks = next;
+    }
+    pool->free_list = NULL;
+}
+
+/**
+ * Allocates transient memory from the frame arena
+ * \param size The number of bytes to allocate
+ * \return The allocated memory, aligned to 16 bytes
+ * \note The memory is released automatically at the start of the next frame, it must not be freed
+ * \warning Do not keep pointers to this memory across frames
+ */
+void *engine_frame_alloc(size_t size) {
+    _assert_engine_init();
+    size = (size + FRAME_ARENA_ALIGN - 1) & ~(size_t)(FRAME_ARENA_ALIGN - 1);
+
+    if (_frame_arena.offset + size <= _frame_arena.size) {
+        void *ptr = _frame_arena.buffer + _frame_arena.offset;
+        _frame_arena.offset += size;
+        return ptr;
+    }
+
+    // The arena is full, fall back to the heap until the next reset grows it
+    unsigned char *block = (unsigned char *)malloc(FRAME_ARENA_ALIGN + size);
+    if (block == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for frame arena overflow\n");
+        exit(1);
+    }
+    *(void **)block = _frame_arena.overflow;
+    _frame_arena.overflow = block;
+    _frame_arena.overflow_size += size;
+    return block + FRAME_ARENA_ALIGN;
+}
+
+/**
+ * Hashes a string (FNV-1a)
+ * \param str The string to hash
+ * \param len The variable to store the length of the string
+ * \return The hash, never 0 as 0 marks empty slots of the intern table
+ */
+static Uint32 _hash_string(const char *str, size_t *len) {
+    Uint32 hash = 2166136261u;
+    const char *c = str;
+    while (*c) {
+        hash ^= (unsigned char)*c++;
+        hash *= 16777619u;
+    }
+    *len = c - str;
+    return hash ? hash : 1;
+}
+
+/**
+ * Finds the slot of a string in the intern table
+ * \param str The string to find
+ * \param hash The hash of the string
+ * \return The index of the slot holding the string, or of the empty slot where it belongs
+ */
+static int _intern_slot(const char *str, Uint32 hash) {
+    int mask = _intern_table.capacity - 1;
+    int i = hash & mask;
+    while (_intern_table.hashes[i] != 0) {
+        if (_intern_table.hashes[i] == hash && strcmp(_intern_table.strings[i], str) == 0) {
+            return i;
+        }
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/**
+ * Resizes the slots of the intern table
+ * \param capacity The new number of slots, must be a power of two
+ */
+static void _intern_table_resize(int capacity) {
+    Uint32 *old_hashes = _intern_table.hashes;
+    const char **old_strings = _intern_table.strings;
+    int old_capacity = _intern_table.capacity;
+
+    _intern_table.hashes = (Uint32 *)calloc(capacity, sizeof(Uint32));
+    _intern_table.strings = (const char **)malloc(sizeof(char *) * capacity);
+    if (_intern_table.hashes == NULL || _intern_table.strings == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for intern table\n");
+        exit(1);
+    }
+    _intern_table.capacity = capacity;
+
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_hashes[i] == 0) continue;
+        int slot = _intern_slot(old_strings[i], old_hashes[i]);
+        _intern_table.hashes[slot] = old_hashes[i];
+        _intern_table.strings[slot] = old_strings[i];
+    }
+    free(old_hashes);
+    free(old_strings);
+}
+
+/**
+ * Finds the canonical pointer of a string without interning it
+ * \param str The string to find
+ * \return The canonical pointer, or NULL if the string was never interned
+ */
+static const char *_intern_find(const char *str) {
+    if (_intern_table.capacity == 0) return NULL;
+    size_t len;
+    Uint32 hash = _hash_string(str, &len);
+    int slot = _intern_slot(str, hash);
+    return _intern_table.hashes[slot] != 0 ? _intern_table.strings[slot] : NULL;
+}
+
+/**
+ * Frees the intern table and every interned string
+ */
+static void _intern_table_destroy() {
+    while (_intern_table.block != NULL) {
+        char *prev = *(char **)_intern_table.block;
+        free(_intern_table.block);
+        _intern_table.block = prev;
+    }
+    free(_intern_table.hashes);
+    free(_intern_table.strings);
+    _intern_table = (InternTable){NULL, NULL, 0, 0, NULL, 0, 0};
+}
+
+/**
+ * Interns a string
+ * \param str The string to intern
+ * \return The canonical pointer of the string, equal strings always return the same pointer
+ * \note Interned strings are stored back to back in large blocks and stay valid until `engine_quit`
+ * \note Names passed to the engine are interned, so registry lookups compare pointers instead of strings
+ */
+const char *engine_intern(const char *str) {
+    if (_intern_table.capacity == 0) {
+        _intern_table_resize(INTERN_TABLE_SIZE);
+    }
+
+    size_t len;
+    Uint32 hash = _hash_string(str, &len);
+    int slot = _intern_slot(str, hash);
+    if (_intern_table.hashes[slot] != 0) {
+        return _intern_table.strings[slot];
+    }
+
+    // Blocks start with a pointer to the previous block, so strings never move
+    if (_intern_table.block == NULL || _intern_table.block_offset + len + 1 > _intern_table.block_size) {
+        size_t size = INTERN_BLOCK_SIZE;
+        if (size < sizeof(char *) + len + 1) size = sizeof(char *) + len + 1;
+        char *block = (char *)malloc(size);
+        if (block == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to allocate memory for interned strings\n");
+            exit(1);
+        }
+        *(char **)block = _intern_table.block;
+        _intern_table.block = block;
+        _intern_table.block_size = size;
+        _intern_table.block_offset = sizeof(char *);
+    }
+
+    char *interned = _intern_table.block + _intern_table.block_offset;
+    memcpy(interned, str, len + 1);
+    _intern_table.block_offset += len + 1;
+
+    _intern_table.hashes[slot] = hash;
+    _intern_table.strings[slot] = interned;
+    _intern_table.count++;
+
+    // Keep the load factor under 1/2
+    if (_intern_table.count * 2 > _intern_table.capacity) {
+        _intern_table_resize(_intern_table.capacity * 2);
+    }
+
+    return interned;
+}
+
 /***********************************************
  * Engine functions
  ***********************************************/
@@ -85,22 +432,44 @@ void engine_init(const char *title, int width, int height, int fps) {
     _engine->width = width;
     _engine->height = height;
     _engine->fps = fps;
+
+    _frame_arena_init(FRAME_ARENA_SIZE);
 }
 
 /**
  * Quits the engine
  * \warning This function DOES NOT free the memory allocated for objects, object templates, and textures
  * \warning You must free them manually, using the destroy functions
+ * \note Streamed textures are destroyed, waiting for the streaming thread if it is decoding one
+ * \warning Interned names and memory from `engine_frame_alloc` are released and must not be used afterwards
  * \note This function must be called at the end of the program
  */
 void engine_quit() {
     _assert_engine_init();
+    destroy_all_streamed_textures();
+    ui_clear_cache();
+    aaFilledClearCache();
+    _text_cache_destroy();
     SDL_DestroyRenderer(_engine->renderer);
     SDL_DestroyWindow(_engine->window);
+    _stream_thread_quit();
     Mix_CloseAudio();
     Mix_Quit();
     SDL_Quit();
     free(_engine);
+
+    _frame_arena_destroy();
+    _pool_destroy(&_texture_list_pool);
+    _pool_destroy(&_object_list_pool);
+    _pool_destroy(&_object_template_list_pool);
+    _pool_destroy(&_audio_list_pool);
+    _pool_destroy(&_font_pool);
+    _pool_destroy(&_layer_pool);
+    _intern_table_destroy();
+    _mip_chain_table_destroy();
+    free(_geometry_batch.vertices);
+    free(_geometry_batch.indices);
+    _geometry_batch = (GeometryBuffer){NULL, 0, 0, NULL, 0, 0};
 }
 
 /**
@@ -110,34 +479,51 @@ void engine_quit() {
  * \param event_handler The event handler function. Should takes a `SDL_Event` and a `void *` as arguments and returns `void`.
  * \param data The data to pass to the functions (update, draw, event_handler)
  * \warning The engine runs in an infinite loop until the window is closed
- * \note The order of execution is as follows: Event handling, Update, (Clear screen), Draw
+ * \note The order of execution is as follows: Event handling, Update, Animations and particles, (Clear screen), Draw
  */
 void engine_run(void (*update)(void *), void (*draw)(void *), void (*event_handler)(SDL_Event, void *), void *data) {
     _assert_engine_init();
 
     Uint32 frameStart;
+    Uint32 lastFrameStart = SDL_GetTicks();
     int frameTime;
 
     while (_engine->isRunning) {
         frameStart = SDL_GetTicks();
+        _frame_count++;
+        _frame_arena_reset();
+        _input.pressed = 0;
+        _input.released = 0;
+        _input.wheel = 0;
 
         while (SDL_PollEvent(&_event)) {
             if (_event.type == SDL_QUIT) {
                 _engine->isRunning = 0;
             }
+            _input_handle_event(&_event);
+            if (_event.type == SDL_RENDER_TARGETS_RESET || _event.type == SDL_RENDER_DEVICE_RESET) {
+                invalidate_all_layers();
+            }
             if (event_handler) event_handler(_event, data);
         }
+        _input.buttons = SDL_GetMouseState(&_input.mouse_x, &_input.mouse_y);
 
         if (update) update(data);
+        _update_animations(frameStart - lastFrameStart);
+        _update_particles(frameStart - lastFrameStart);
+        lastFrameStart = frameStart;
+
         if (_update_frame || !_manual_update_frame) {
             SDL_SetRenderDrawColor(_engine->renderer, _clear_color.r, _clear_color.g, _clear_color.b, _clear_color.a);
             SDL_RenderClear(_engine->renderer);
             SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
             if (draw) draw(data);
+            flush_geometry();
             _update_frame = false;
         }
 
         SDL_RenderPresent(_engine->renderer);
+        _update_texture_residency();
 
         frameTime = SDL_GetTicks() - frameStart;
         if (frameTime < 1000 / _engine->fps) {
@@ -216,18 +602,9 @@ void manual_update() {
  * \param name The name of the texture
  */
 static void _add_to_texture_list(Texture *texture, char *name) {
-    char *texture_name = (char *)malloc(sizeof(char) * strlen(name) + 1);
-    if (texture_name == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for texture name\n");
-        exit(1);
-    }
-    strcpy(texture_name, name);
+    const char *texture_name = engine_intern(name);
 
-    TextureList *texture_list_item = (TextureList *)malloc(sizeof(TextureList));
-    if (texture_list_item == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for texture list item\n");
-        exit(1);
-    }
+    TextureList *texture_list_item = (TextureList *)_pool_alloc(&_texture_list_pool);
     texture_list_item->texture = texture;
     texture_list_item->name = texture_name;
     texture_list_item->next = NULL;
@@ -237,7 +614,7 @@ static void _add_to_texture_list(Texture *texture, char *name) {
     } else {
         TextureList *current = _texture_list;
         while (current->next != NULL) {
-            if (current->name == name) {
+            if (current->name == texture_name) {
                 fprintf(stderr, "[ENGINE] Texture name already exists: %s\n", name);
                 exit(1);
             }
@@ -247,22 +624,257 @@ static void _add_to_texture_list(Texture *texture, char *name) {
     }
 }
 
+/**
+ * Finds the slot of a texture in the mip chain table
+ * \param texture The texture to find
+ * \return The index of the slot holding the texture, or of the empty slot where it belongs
+ */
+static int _mip_chain_slot(Texture *texture) {
+    int mask = _mip_chains.capacity - 1;
+    int i = (int)((((uintptr_t)texture >> 4) * 2654435761u) & mask);
+    while (_mip_chains.textures[i] != NULL && _mip_chains.textures[i] != texture) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/**
+ * Gets the mip chain of a texture
+ * \param texture The texture (level 0)
+ * \return The mip chain, NULL if the texture has a single level
+ */
+static MipChain *_mip_chain(Texture *texture) {
+    if (_mip_chains.count == 0) return NULL;
+    int slot = _mip_chain_slot(texture);
+    return _mip_chains.textures[slot] != NULL ? _mip_chains.chains[slot] : NULL;
+}
+
+/**
+ * Adds the mip chain of a texture to the mip chain table
+ * \param texture The texture (level 0)
+ * \param chain The mip chain
+ * \note The table is kept at most half full
+ */
+static void _mip_chain_add(Texture *texture, MipChain *chain) {
+    if ((_mip_chains.count + 1) * 2 > _mip_chains.capacity) {
+        Texture **old_textures = _mip_chains.textures;
+        MipChain **old_chains = _mip_chains.chains;
+        int old_capacity = _mip_chains.capacity;
+        _mip_chains.capacity = old_capacity > 0 ? old_capacity * 2 : 64;
+        _mip_chains.textures = (Texture **)calloc(_mip_chains.capacity, sizeof(Texture *));
+        _mip_chains.chains = (MipChain **)malloc(sizeof(MipChain *) * _mip_chains.capacity);
+        if (_mip_chains.textures == NULL || _mip_chains.chains == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to allocate memory for mip chain table\n");
+            exit(1);
+        }
+        for (int i = 0; i < old_capacity; i++) {
+            if (old_textures[i] == NULL) continue;
+            int slot = _mip_chain_slot(old_textures[i]);
+            _mip_chains.textures[slot] = old_textures[i];
+            _mip_chains.chains[slot] = old_chains[i];
+        }
+        free(old_textures);
+        free(old_chains);
+    }
+    int slot = _mip_chain_slot(texture);
+    _mip_chains.textures[slot] = texture;
+    _mip_chains.chains[slot] = chain;
+    _mip_chains.count++;
+}
+
+/**
+ * Removes the mip chain of a texture from the mip chain table
+ * \param texture The texture (level 0)
+ * \note The following textures of the probe sequence are moved back, so lookups never need tombstones
+ */
+static void _mip_chain_remove(Texture *texture) {
+    if (_mip_chains.count == 0) return;
+    int mask = _mip_chains.capacity - 1;
+    int hole = _mip_chain_slot(texture);
+    if (_mip_chains.textures[hole] == NULL) return;
+    _mip_chains.textures[hole] = NULL;
+    _mip_chains.count--;
+    for (int i = (hole + 1) & mask; _mip_chains.textures[i] != NULL; i = (i + 1) & mask) {
+        Texture *moved = _mip_chains.textures[i];
+        MipChain *chain = _mip_chains.chains[i];
+        _mip_chains.textures[i] = NULL;
+        int slot = _mip_chain_slot(moved);
+        _mip_chains.textures[slot] = moved;
+        _mip_chains.chains[slot] = chain;
+    }
+}
+
+/**
+ * Frees the mip chain table, the mip chains left are freed by the textures destroyed with the renderer
+ */
+static void _mip_chain_table_destroy() {
+    for (int i = 0; i < _mip_chains.capacity; i++) {
+        if (_mip_chains.textures[i] != NULL) free(_mip_chains.chains[i]);
+    }
+    free(_mip_chains.textures);
+    free(_mip_chains.chains);
+    _mip_chains = (MipChainTable){NULL, NULL, 0, 0};
+}
+
+/**
+ * Creates a texture and its mip chain from a surface
+ * \param surface The surface to upload, it is not freed
+ * \param max_levels The maximum number of levels of the mip chain, level 0 included
+ * \return The texture (level 0), its mip chain is added to the mip chain table when it has more than one level
+ * \note Every level is shrunk from the previous one with a 2x2 box filter
+ */
+static Texture *_create_mipmapped_texture(SDL_Surface *surface, int max_levels) {
+    Texture *texture = SDL_CreateTextureFromSurface(_engine->renderer, surface);
+    if (texture == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to create texture: %s\n", SDL_GetError());
+        exit(1);
+    }
+    if (!_mipmaps || max_levels < 2 || surface->w < 2 || surface->h < 2) return texture;
+
+    MipChain *chain = (MipChain *)malloc(sizeof(MipChain));
+    if (chain == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for mip chain\n");
+        exit(1);
+    }
+    chain->levels[0] = texture;
+    chain->nb_levels = 1;
+    chain->width = surface->w;
+    chain->height = surface->h;
+
+    SDL_BlendMode blend_mode;
+    SDL_ScaleMode scale_mode;
+    SDL_GetTextureBlendMode(texture, &blend_mode);
+    SDL_GetTextureScaleMode(texture, &scale_mode);
+
+    // 32 bits copy, shrinkSurface would convert it on every level otherwise
+    SDL_Surface *level = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (level == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to convert surface: %s\n", SDL_GetError());
+        exit(1);
+    }
+    if (max_levels > MIP_MAX_LEVELS) max_levels = MIP_MAX_LEVELS;
+    while (chain->nb_levels < max_levels && level->w >= 2 && level->h >= 2) {
+        SDL_Surface *next = shrinkSurface(level, 2, 2);
+        SDL_FreeSurface(level);
+        if (next == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to shrink surface: %s\n", SDL_GetError());
+            exit(1);
+        }
+        level = next;
+
+        Texture *level_texture = SDL_CreateTextureFromSurface(_engine->renderer, level);
+        if (level_texture == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to create texture: %s\n", SDL_GetError());
+            exit(1);
+        }
+        SDL_SetTextureBlendMode(level_texture, blend_mode);
+        SDL_SetTextureScaleMode(level_texture, scale_mode);
+        chain->levels[chain->nb_levels++] = level_texture;
+    }
+    SDL_FreeSurface(level);
+
+    _mip_chain_add(texture, chain);
+    return texture;
+}
+
+/**
+ * Loads an image and creates a texture with its mip chain
+ * \param filename The path to the image
+ * \param max_levels The maximum number of levels of the mip chain, level 0 included
+ * \return The texture
+ */
+static Texture *_load_mipmapped_texture(char *filename, int max_levels) {
+    SDL_Surface *surface = IMG_Load(filename);
+    if (surface == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to load image: %s\n", IMG_GetError());
+        exit(1);
+    }
+    Texture *texture = _create_mipmapped_texture(surface, max_levels);
+    SDL_FreeSurface(surface);
+    return texture;
+}
+
+/**
+ * Picks the mip level of a texture to draw a source rectangle at a destination size
+ * \param texture The texture (level 0)
+ * \param src_w The width of the source rectangle in level 0
+ * \param src_h The height of the source rectangle in level 0
+ * \param dst_w The width of the destination rectangle
+ * \param dst_h The height of the destination rectangle
+ * \param level The level picked, 0 for textures without a mip chain
+ * \return The texture of the level
+ * \note The destination size is multiplied by the renderer scale, the smallest level still covering it is picked
+ * \note Color and alpha modulation and blend mode are copied from level 0 to the level picked
+ */
+static Texture *_mip_level(Texture *texture, int src_w, int src_h, int dst_w, int dst_h, int *level) {
+    *level = 0;
+    MipChain *chain = _mip_chain(texture);
+    if (chain == NULL) return texture;
+
+    float scale_x, scale_y;
+    SDL_RenderGetScale(_engine->renderer, &scale_x, &scale_y);
+    float width = fabsf(dst_w * scale_x);
+    float height = fabsf(dst_h * scale_y);
+    while (*level + 1 < chain->nb_levels && (src_w >> (*level + 1)) >= width && (src_h >> (*level + 1)) >= height) {
+        (*level)++;
+    }
+    if (*level == 0) return texture;
+
+    Texture *level_texture = chain->levels[*level];
+    Uint8 r, g, b, a;
+    SDL_BlendMode blend_mode;
+    SDL_GetTextureColorMod(texture, &r, &g, &b);
+    SDL_GetTextureAlphaMod(texture, &a);
+    SDL_GetTextureBlendMode(texture, &blend_mode);
+    SDL_SetTextureColorMod(level_texture, r, g, b);
+    SDL_SetTextureAlphaMod(level_texture, a);
+    SDL_SetTextureBlendMode(level_texture, blend_mode);
+    return level_texture;
+}
+
+/**
+ * Picks the mip level of a whole texture drawn at a destination size
+ * \param texture The texture (level 0)
+ * \param dst_w The width of the destination rectangle
+ * \param dst_h The height of the destination rectangle
+ * \return The texture of the level
+ */
+static Texture *_mip_texture(Texture *texture, int dst_w, int dst_h) {
+    MipChain *chain = _mip_chain(texture);
+    if (chain == NULL) return texture;
+    int level;
+    return _mip_level(texture, chain->width, chain->height, dst_w, dst_h, &level);
+}
+
+/**
+ * Destroys a texture and its mip chain
+ * \param texture The texture (level 0)
+ */
+static void _destroy_mipmapped_texture(Texture *texture) {
+    MipChain *chain = _mip_chain(texture);
+    if (chain != NULL) {
+        for (int i = 1; i < chain->nb_levels; i++) {
+            SDL_DestroyTexture(chain->levels[i]);
+        }
+        _mip_chain_remove(texture);
+        free(chain);
+    }
+    SDL_DestroyTexture(texture);
+}
+
 /**
  * Loads a texture
  * \param filename The path to the texture
  * \param name The name of the texture
  * \return The texture
  * \note The texture must be destroyed after use
+ * \note A mip chain is generated unless disabled with `set_mipmaps`, draw calls smaller than the texture sample a smaller level
  */
 Texture *load_texture(char *filename, char *name) {
     _assert_engine_init();
 
     // Load texture
-    Texture *texture = IMG_LoadTexture(_engine->renderer, filename);
-    if (texture == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to load image: %s\n", IMG_GetError());
-        exit(1);
-    }
+    Texture *texture = _load_mipmapped_texture(filename, MIP_MAX_LEVELS);
 
     // Add texture to texture list
     _add_to_texture_list(texture, name);
@@ -271,21 +883,50 @@ Texture *load_texture(char *filename, char *name) {
 }
 
 /**
- * Gets a texture by name
+ * Finds a texture by name
  * \param name The name of the texture
- * \return The texture
+ * \return The texture, NULL if no texture has this name
  */
-Texture *get_texture_by_name(char *name) {
+Texture *find_texture_by_name(char *name) {
     _assert_engine_init();
+    const char *key = _intern_find(name);
     TextureList *current = _texture_list;
     while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
+        if (current->name == key) {
             return current->texture;
         }
         current = current->next;
     }
-    fprintf(stderr, "[ENGINE] Texture not found: %s\n", name);
-    exit(1);
+    return NULL;
+}
+
+/**
+ * Gets a texture by name
+ * \param name The name of the texture
+ * \return The texture
+ */
+Texture *get_texture_by_name(char *name) {
+    Texture *texture = find_texture_by_name(name);
+    if (texture == NULL) {
+        fprintf(stderr, "[ENGINE] Texture not found: %s\n", name);
+        exit(1);
+    }
+    return texture;
+}
+
+/**
+ * Gets the name of a texture
+ * \param texture The texture
+ * \return The interned name of the texture, NULL if it was not loaded with a name
+ */
+const char *get_texture_name(Texture *texture) {
+    _assert_engine_init();
+    for (TextureList *current = _texture_list; current != NULL; current = current->next) {
+        if (current->texture == texture) {
+            return current->name;
+        }
+    }
+    return NULL;
 }
 
 /**
@@ -298,8 +939,9 @@ Texture *get_texture_by_name(char *name) {
  */
 void draw_texture(Texture *texture, int x, int y, int width, int height) {
     _assert_engine_init();
+    flush_geometry();
     SDL_Rect rect = {x, y, width, height};
-    SDL_RenderCopy(_engine->renderer, texture, NULL, &rect);
+    SDL_RenderCopy(_engine->renderer, _mip_texture(texture, width, height), NULL, &rect);
 }
 
 /**
@@ -315,8 +957,9 @@ void draw_texture(Texture *texture, int x, int y, int width, int height) {
  */
 void draw_texture_ex(Texture *texture, int x, int y, int width, int height, double angle, Point *center, Flip flip) {
     _assert_engine_init();
+    flush_geometry();
     SDL_Rect rect = {x, y, width, height};
-    SDL_RenderCopyEx(_engine->renderer, texture, NULL, &rect, angle, center, flip);
+    SDL_RenderCopyEx(_engine->renderer, _mip_texture(texture, width, height), NULL, &rect, angle, center, flip);
 }
 
 /**
@@ -329,6 +972,7 @@ void draw_texture_ex(Texture *texture, int x, int y, int width, int height, doub
  */
 void draw_texture_from_path(char *filename, int x, int y, int width, int height) {
     _assert_engine_init();
+    flush_geometry();
     Texture *texture = IMG_LoadTexture(_engine->renderer, filename);
 
     SDL_Rect rect = {x, y, width, height};
@@ -343,18 +987,18 @@ void draw_texture_from_path(char *filename, int x, int y, int width, int height)
  */
 void destroy_texture(char *name) {
     _assert_engine_init();
+    const char *key = _intern_find(name);
     TextureList *current = _texture_list;
     TextureList *prev = NULL;
     while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
+        if (current->name == key) {
             if (prev == NULL) {
                 _texture_list = current->next;
             } else {
                 prev->next = current->next;
             }
-            SDL_DestroyTexture(current->texture);
-            free(current->name);
-            free(current);
+            _destroy_mipmapped_texture(current->texture);
+            _pool_free(&_texture_list_pool, current);
             return;
         }
         prev = current;
@@ -373,9 +1017,8 @@ void destroy_all_textures() {
     TextureList *current = _texture_list;
     while (current != NULL) {
         TextureList *next = current->next;
-        SDL_DestroyTexture(current->texture);
-        free(current->name);
-        free(current);
+        _destroy_mipmapped_texture(current->texture);
+        _pool_free(&_texture_list_pool, current);
         current = next;
     }
     _texture_list = NULL;
@@ -388,686 +1031,2586 @@ void destroy_all_textures() {
  */
 void rotate_texture(char *name, double angle) {
     _assert_engine_init();
+    flush_geometry();
     Texture *texture = get_texture_by_name(name);
     SDL_RenderCopyEx(_engine->renderer, texture, NULL, NULL, angle, NULL, SDL_FLIP_NONE);
 }
 
 /***********************************************
- * Tilemap functions
+ * Texture streaming functions
  ***********************************************/
 
 /**
- * Creates a tilemap
- * \param filename The path to the tilemap
- * \param tile_width The width of the tile
- * \param tile_height The height of the tile
- * \param spacing The spacing between tiles
- * \param nb_rows The number of rows in the tilemap
- * \param nb_cols The number of columns in the tilemap
- * \return The tilemap
+ * Decodes the image of a streamed texture
+ * \param streamed The streamed texture
+ * \return The decoded image, NULL on failure
+ * \note Called from the streaming thread, it only reads fields that do not change after loading
  */
-Tilemap *create_tilemap(char *filename, int tile_width, int tile_height, int spacing, int nb_rows, int nb_cols) {
-    _assert_engine_init();
-    Tilemap *tilemap = (Tilemap *)malloc(sizeof(Tilemap));
-    if (tilemap == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for tilemap\n");
-        exit(1);
+static SDL_Surface *_decode_streamed_texture(StreamedTexture *streamed) {
+    if (streamed->file_data != NULL) {
+        return IMG_Load_RW(SDL_RWFromConstMem(streamed->file_data, (int)streamed->file_size), 1);
     }
+    return IMG_Load(streamed->path);
+}
 
-    tilemap->texture = IMG_LoadTexture(_engine->renderer, filename);
-    if (tilemap->texture == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to load tilemap: %s\n", IMG_GetError());
-        exit(1);
+/**
+ * Decodes the queued streamed textures until the streaming thread is stopped
+ * \param data Unused
+ * \return 0
+ */
+static int _stream_thread_main(void *data) {
+    (void)data;
+    SDL_LockMutex(_stream_mutex);
+    while (!_stream_quit) {
+        if (_stream_jobs == NULL) {
+            SDL_CondWait(_stream_cond, _stream_mutex);
+            continue;
+        }
+        StreamedTexture *streamed = _stream_jobs;
+        _stream_jobs = streamed->next_job;
+        if (_stream_jobs == NULL) _stream_jobs_tail = NULL;
+        streamed->next_job = NULL;
+        _stream_current = streamed;
+        SDL_UnlockMutex(_stream_mutex);
+
+        SDL_Surface *surface = _decode_streamed_texture(streamed);
+
+        SDL_LockMutex(_stream_mutex);
+        streamed->decoded = surface;
+        streamed->state = TEXTURE_DECODED;
+        _stream_current = NULL;
+        SDL_CondBroadcast(_stream_cond);
     }
-
-    tilemap->tile_width = tile_width;
-    tilemap->tile_height = tile_height;
-    tilemap->spacing = spacing;
-    tilemap->nb_rows = nb_rows;
-    tilemap->nb_cols = nb_cols;
-
-    return tilemap;
+    SDL_UnlockMutex(_stream_mutex);
+    return 0;
 }
 
 /**
- * Gets a tile from a tilemap
- * \param tilemap The tilemap to use
- * \param tile_row The row of the tile
- * \param tile_col The column of the tile
- * \return The tile
- * \note The tile must be destroyed after use
+ * Starts the streaming thread if it is not running
  */
-Tile *get_tile(Tilemap *tilemap, int tile_row, int tile_col) {
-    _assert_engine_init();
-    if (tile_row >= tilemap->nb_rows || tile_col >= tilemap->nb_cols) {
-        fprintf(stderr, "[ENGINE] Tile out of bounds\n");
+static void _stream_thread_init() {
+    if (_stream_thread != NULL) return;
+    _stream_mutex = SDL_CreateMutex();
+    _stream_cond = SDL_CreateCond();
+    if (_stream_mutex == NULL || _stream_cond == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to create texture streaming lock: %s\n", SDL_GetError());
         exit(1);
     }
-
-    Tile *tile = (Tile *)malloc(sizeof(Tile));
-    if (tile == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for tile\n");
+    _stream_quit = false;
+    _stream_thread = SDL_CreateThread(_stream_thread_main, "texture_stream", NULL);
+    if (_stream_thread == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to create texture streaming thread: %s\n", SDL_GetError());
         exit(1);
     }
-
-    tile->tilemap = tilemap;
-    tile->row = tile_row;
-    tile->col = tile_col;
-
-    return tile;
 }
 
 /**
- * Draws a tile
- * \param tile The tile to draw
- * \param x The x position to draw the tile
- * \param y The y position to draw the tile
+ * Stops the streaming thread, the queued textures are not decoded
  */
-void draw_tile(Tile *tile, int x, int y) {
-    _assert_engine_init();
-    SDL_Rect src = {tile->col * (tile->tilemap->tile_width + tile->tilemap->spacing), tile->row * (tile->tilemap->tile_height + tile->tilemap->spacing), tile->tilemap->tile_width, tile->tilemap->tile_height};
-    SDL_Rect dest = {x, y, tile->tilemap->tile_width, tile->tilemap->tile_height};
-    SDL_RenderCopy(_engine->renderer, tile->tilemap->texture, &src, &dest);
+static void _stream_thread_quit() {
+    if (_stream_thread == NULL) return;
+    SDL_LockMutex(_stream_mutex);
+    _stream_quit = true;
+    SDL_CondBroadcast(_stream_cond);
+    SDL_UnlockMutex(_stream_mutex);
+    SDL_WaitThread(_stream_thread, NULL);
+    SDL_DestroyCond(_stream_cond);
+    SDL_DestroyMutex(_stream_mutex);
+    _stream_thread = NULL;
+    _stream_cond = NULL;
+    _stream_mutex = NULL;
+    _stream_jobs = NULL;
+    _stream_jobs_tail = NULL;
 }
 
 /**
- * Draws a tile with the specified width and height
- * \param tile The tile to draw
- * \param x The x position to draw the tile
- * \param y The y position to draw the tile
- * \param width The width of the tile
- * \param height The height of the tile
+ * Computes the GPU memory used by a texture and its mip chain
+ * \param texture The texture (level 0)
+ * \return The size in bytes, 4 bytes per pixel
  */
-void draw_tile_with_size(Tile *tile, int x, int y, int width, int height) {
-    _assert_engine_init();
-    SDL_Rect src = {tile->col * (tile->tilemap->tile_width + tile->tilemap->spacing), tile->row * (tile->tilemap->tile_height + tile->tilemap->spacing), tile->tilemap->tile_width, tile->tilemap->tile_height};
-    SDL_Rect dest = {x, y, width, height};
-    SDL_RenderCopy(_engine->renderer, tile->tilemap->texture, &src, &dest);
+static size_t _texture_bytes(Texture *texture) {
+    MipChain *chain = _mip_chain(texture);
+    int nb_levels = chain == NULL ? 1 : chain->nb_levels;
+    size_t bytes = 0;
+    for (int i = 0; i < nb_levels; i++) {
+        int width, height;
+        SDL_QueryTexture(chain == NULL ? texture : chain->levels[i], NULL, NULL, &width, &height);
+        bytes += (size_t)width * height * 4;
+    }
+    return bytes;
 }
 
 /**
- * Draws a tile from a tilemap
- * \param tilemap The tilemap to use
- * \param tile_row The row of the tile
- * \param tile_col The column of the tile
- * \param x The x position to draw the tile
- * \param y The y position to draw the tile
+ * Uploads the decoded image of a streamed texture, on the main thread
+ * \param streamed The streamed texture
+ * \param surface The decoded image, freed by this function, NULL if the decoding failed
+ * \note A failed decoding is logged and leaves the texture in the failed state, it is not decoded again
  */
-void draw_tile_from_tilemap(Tilemap *tilemap, int tile_row, int tile_col, int x, int y) {
-    _assert_engine_init();
-    if (tile_row >= tilemap->nb_rows || tile_col >= tilemap->nb_cols) {
-        fprintf(stderr, "[ENGINE] Tile out of bounds\n");
-        exit(1);
+static void _upload_streamed_texture(StreamedTexture *streamed, SDL_Surface *surface) {
+    if (surface == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to reload streamed texture %s: %s\n", streamed->name, streamed->path);
+        streamed->state = TEXTURE_FAILED;
+        return;
     }
-
-    SDL_Rect src = {tile_col * (tilemap->tile_width + tilemap->spacing), tile_row * (tilemap->tile_height + tilemap->spacing), tilemap->tile_width, tilemap->tile_height};
-    SDL_Rect dest = {x, y, tilemap->tile_width, tilemap->tile_height};
-    SDL_RenderCopy(_engine->renderer, tilemap->texture, &src, &dest);
+    streamed->texture = _create_mipmapped_texture(surface, MIP_MAX_LEVELS);
+    streamed->width = surface->w;
+    streamed->height = surface->h;
+    streamed->bytes = _texture_bytes(streamed->texture);
+    streamed->state = TEXTURE_RESIDENT;
+    _resident_texture_bytes += streamed->bytes;
+    SDL_FreeSurface(surface);
 }
 
 /**
- * Destroys a tile
- * \param tile The tile to destroy
- * \note This function does not destroy the tilemap
+ * Destroys the texture of a resident streamed texture, keeping its file data or path
+ * \param streamed The streamed texture
  */
-void destroy_tile(Tile *tile) {
-    free(tile);
+static void _evict_streamed_texture(StreamedTexture *streamed) {
+    _destroy_mipmapped_texture(streamed->texture);
+    _resident_texture_bytes -= streamed->bytes;
+    streamed->texture = NULL;
+    streamed->state = TEXTURE_EVICTED;
 }
 
 /**
- * Destroys a tilemap
- * \param tilemap The tilemap to destroy
+ * Evicts the least recently used streamed textures until the resident ones fit in the texture budget
+ * \note Called at the end of every frame, textures used during the frame are never evicted
  */
-void destroy_tilemap(Tilemap *tilemap) {
-    _assert_engine_init();
-    SDL_DestroyTexture(tilemap->texture);
-    free(tilemap);
+static void _update_texture_residency() {
+    while (_resident_texture_bytes > _texture_budget) {
+        StreamedTexture *lru = NULL;
+        for (StreamedTexture *current = _streamed_textures; current != NULL; current = current->next) {
+            if (current->state != TEXTURE_RESIDENT || current->last_used >= _frame_count) continue;
+            if (lru == NULL || current->last_used < lru->last_used) lru = current;
+        }
+        if (lru == NULL) return;
+        _evict_streamed_texture(lru);
+    }
 }
 
-/***********************************************
- * Object functions
- ***********************************************/
-
 /**
- * Adds an object to the object list
- * \param object The object to add
- * \param name The name of the object
+ * Loads a streamed texture
+ * \param filename The path to the image
+ * \param name The name of the texture
+ * \param keep_file_data True to keep the content of the file in memory, false to read the file again when the texture is reloaded
+ * \return The streamed texture
+ * \note The texture is resident after loading, it is evicted at the end of a frame where the texture budget is exceeded and it was not used
+ * \note The streamed texture must be destroyed after use
  */
-static void _add_object_to_list(Object *object, char *name) {
-    char *obj_name = (char *)malloc(sizeof(char) * strlen(name) + 1);
-    if (obj_name == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for object name\n");
-        exit(1);
+StreamedTexture *load_streamed_texture(char *filename, char *name, bool keep_file_data) {
+    _assert_engine_init();
+    const char *texture_name = engine_intern(name);
+    for (StreamedTexture *current = _streamed_textures; current != NULL; current = current->next) {
+        if (current->name == texture_name) {
+            fprintf(stderr, "[ENGINE] Streamed texture name already exists: %s\n", name);
+            exit(1);
+        }
     }
-    strcpy(obj_name, name);
 
-    ObjectList *object_list_item = (ObjectList *)malloc(sizeof(ObjectList));
-    if (object_list_item == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for object list item\n");
+    StreamedTexture *streamed = (StreamedTexture *)malloc(sizeof(StreamedTexture));
+    if (streamed == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for streamed texture\n");
         exit(1);
     }
-    object_list_item->object = object;
-    object_list_item->name = obj_name;
-    object_list_item->next = NULL;
-
-    if (_object_list == NULL) {
-        _object_list = object_list_item;
-    } else {
-        ObjectList *current = _object_list;
-        while (current->next != NULL) {
-            if (strcmp(current->name, name) == 0) {
-                fprintf(stderr, "[ENGINE] Object name already exists: %s\n", name);
-                exit(1);
-            }
-            current = current->next;
+    streamed->name = texture_name;
+    streamed->path = engine_intern(filename);
+    streamed->file_data = NULL;
+    streamed->file_size = 0;
+    if (keep_file_data) {
+        streamed->file_data = SDL_LoadFile(filename, &streamed->file_size);
+        if (streamed->file_data == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to read file: %s\n", SDL_GetError());
+            exit(1);
         }
-        current->next = object_list_item;
     }
+    streamed->texture = NULL;
+    streamed->decoded = NULL;
+    streamed->bytes = 0;
+    streamed->last_used = _frame_count;
+    streamed->state = TEXTURE_EVICTED;
+    streamed->next_job = NULL;
+
+    SDL_Surface *surface = _decode_streamed_texture(streamed);
+    if (surface == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to load image: %s\n", streamed->path);
+        exit(1);
+    }
+    _upload_streamed_texture(streamed, surface);
+
+    streamed->next = _streamed_textures;
+    _streamed_textures = streamed;
+    return streamed;
 }
 
 /**
- * Creates an object
- * \param name The name of the object
- * \param texture The texture of the object
- * \param x The x position of the object
- * \param y The y position of the object
- * \param width The width of the object
- * \param height The height of the object
- * \param hitbox True if the object has a hitbox, false otherwise
- * \param data The data of the object
- * \return The object
+ * Gets the texture of a streamed texture and marks it as used this frame
+ * \param streamed The streamed texture
+ * \return The texture, NULL while it is being decoded or if it failed to be decoded again
+ * \note An evicted texture is queued for decoding on the streaming thread and uploaded by the first call after it is decoded
+ * \note The texture returned must not be kept across frames, it can be evicted at the end of any frame it is not used
  */
-Object *create_object(char *name, Texture *texture, int x, int y, int width, int height, bool hitbox, void *data) {
+Texture *get_streamed_texture(StreamedTexture *streamed) {
     _assert_engine_init();
-    Object *object = (Object *)malloc(sizeof(Object));
-    if (object == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for object\n");
-        exit(1);
+    streamed->last_used = _frame_count;
+
+    // Only the main thread leaves the resident and evicted states
+    if (streamed->state == TEXTURE_RESIDENT) return streamed->texture;
+    if (streamed->state == TEXTURE_FAILED) return NULL;
+    if (streamed->state == TEXTURE_EVICTED) {
+        _stream_thread_init();
+        SDL_LockMutex(_stream_mutex);
+        streamed->state = TEXTURE_LOADING;
+        if (_stream_jobs_tail == NULL) {
+            _stream_jobs = streamed;
+        } else {
+            _stream_jobs_tail->next_job = streamed;
+        }
+        _stream_jobs_tail = streamed;
+        SDL_CondBroadcast(_stream_cond);
+        SDL_UnlockMutex(_stream_mutex);
+        return NULL;
     }
 
-    object->texture = texture;
-    object->x = x;
-    object->y = y;
-    object->width = width;
-    object->height = height;
-    object->hitbox = hitbox;
-    object->data = data;
-
-    _add_object_to_list(object, name);
+    SDL_LockMutex(_stream_mutex);
+    bool decoded = streamed->state == TEXTURE_DECODED;
+    SDL_Surface *surface = streamed->decoded;
+    streamed->decoded = NULL;
+    SDL_UnlockMutex(_stream_mutex);
+    if (!decoded) return NULL;
 
-    return object;
+    _upload_streamed_texture(streamed, surface);
+    return streamed->texture;
 }
 
 /**
- * Instantiates an object from an object template
- * \param object_template The object template to instantiate
- * \param x The x position of the object
- * \param y The y position of the object
- * \param data The data of the object
- * \return The object
+ * Draws a streamed texture
+ * \param streamed The streamed texture to draw
+ * \param x The x position to draw the texture
+ * \param y The y position to draw the texture
+ * \param width The width of the texture
+ * \param height The height of the texture
+ * \note Nothing is drawn while the texture is being decoded or if it failed to be decoded again
  */
-Object *instantiate_object(ObjectTemplate *object_template, char *name, int x, int y, void *data) {
-    _assert_engine_init();
-    return create_object(name, object_template->texture, x, y, object_template->width, object_template->height, object_template->hitbox, data);
+void draw_streamed_texture(StreamedTexture *streamed, int x, int y, int width, int height) {
+    Texture *texture = get_streamed_texture(streamed);
+    if (texture == NULL) return;
+    draw_texture(texture, x, y, width, height);
 }
 
 /**
- * Checks if an object exists
- * \param name The name of the object
- * \return True if the object exists, false otherwise
+ * Sets the GPU memory budget of the streamed textures
+ * \param bytes The budget in bytes, 256 MiB by default
+ * \note The budget is only checked at the end of a frame, textures used during the frame stay resident even if it is exceeded
  */
-bool object_exists(char *name) {
-    _assert_engine_init();
-    ObjectList *current = _object_list;
-    while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
-            return true;
-        }
-        current = current->next;
-    }
-    return false;
+void set_texture_budget(size_t bytes) {
+    _texture_budget = bytes;
 }
 
 /**
- * Draws an object
- * \param object The object to draw
+ * Gets the GPU memory used by the resident streamed textures
+ * \return The size in bytes
  */
-void draw_object(Object *object) {
-    _assert_engine_init();
-    SDL_Rect rect = {object->x, object->y, object->width, object->height};
-    SDL_RenderCopy(_engine->renderer, object->texture, NULL, &rect);
+size_t get_resident_texture_bytes() {
+    return _resident_texture_bytes;
 }
 
 /**
- * Gets an object by name
- * \param name The name of the object
- * \return The object with the given name
+ * Destroys a streamed texture
+ * \param streamed The streamed texture to destroy
+ * \note Waits for the streaming thread if it is decoding the texture
  */
-Object *get_object_by_name(char *name) {
+void destroy_streamed_texture(StreamedTexture *streamed) {
     _assert_engine_init();
-    ObjectList *current = _object_list;
-    while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
-            return current->object;
-        }
-        current = current->next;
+    StreamedTexture **link = &_streamed_textures;
+    while (*link != NULL && *link != streamed) link = &(*link)->next;
+    if (*link == NULL) {
+        fprintf(stderr, "[ENGINE] Streamed texture not found: %s\n", streamed->name);
+        exit(1);
     }
-    fprintf(stderr, "[ENGINE] Object not found: %s\n", name);
-    exit(1);
-}
+    *link = streamed->next;
 
-/**
- * Destroys all objects with a given name
- * \param name The name of the object
- */
-void destroy_object_by_name(char *name) {
-    _assert_engine_init();
-    ObjectList *current = _object_list;
-    ObjectList *prev = NULL;
-    while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
+    if (_stream_mutex != NULL) {
+        SDL_LockMutex(_stream_mutex);
+        StreamedTexture *prev = NULL;
+        for (StreamedTexture *job = _stream_jobs; job != NULL; prev = job, job = job->next_job) {
+            if (job != streamed) continue;
             if (prev == NULL) {
-                _object_list = current->next;
+                _stream_jobs = job->next_job;
             } else {
-                prev->next = current->next;
+                prev->next_job = job->next_job;
             }
-            free(current->object);
-            free(current->name);
-            free(current);
+            if (_stream_jobs_tail == job) _stream_jobs_tail = prev;
+            break;
         }
-        prev = current;
-        current = current->next;
+        while (_stream_current == streamed) {
+            SDL_CondWait(_stream_cond, _stream_mutex);
+        }
+        SDL_UnlockMutex(_stream_mutex);
     }
+
+    if (streamed->decoded != NULL) SDL_FreeSurface(streamed->decoded);
+    if (streamed->state == TEXTURE_RESIDENT) _evict_streamed_texture(streamed);
+    SDL_free(streamed->file_data);
+    free(streamed);
 }
 
 /**
- * Destroys all objects
+ * Destroys all the streamed textures
  */
-void destroy_all_objects() {
+void destroy_all_streamed_textures() {
     _assert_engine_init();
-    ObjectList *current = _object_list;
-    while (current != NULL) {
-        ObjectList *next = current->next;
-        free(current->object);
-        free(current->name);
-        free(current);
-        current = next;
+    while (_streamed_textures != NULL) {
+        destroy_streamed_texture(_streamed_textures);
     }
-    _object_list = NULL;
 }
 
 /***********************************************
- * Object template functions
+ * Tilemap functions
  ***********************************************/
 
 /**
- * Adds an object template to the object template list
- * \param template The object template to add
- * \param name The name of the object template
+ * Creates a tilemap
+ * \param filename The path to the tilemap
+ * \param tile_width The width of the tile
+ * \param tile_height The height of the tile
+ * \param spacing The spacing between tiles
+ * \param nb_rows The number of rows in the tilemap
+ * \param nb_cols The number of columns in the tilemap
+ * \return The tilemap
+ * \note The source rectangle of every tile is computed once here, tile ids index this table
+ * \note The mip chain stops at the first level where the tile size or the spacing is not divisible by 2
  */
-static void _add_object_template_to_list(ObjectTemplate *template, char *name) {
-    char *objt_name = (char *)malloc(sizeof(char) * strlen(name) + 1);
-    if (objt_name == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for object template name\n");
+Tilemap *create_tilemap(char *filename, int tile_width, int tile_height, int spacing, int nb_rows, int nb_cols) {
+    _assert_engine_init();
+    Tilemap *tilemap = (Tilemap *)malloc(sizeof(Tilemap));
+    if (tilemap == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for tilemap\n");
         exit(1);
     }
-    strcpy(objt_name, name);
 
-    ObjectTemplateList *object_template_list_item = (ObjectTemplateList *)malloc(sizeof(ObjectTemplateList));
-    if (object_template_list_item == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for object template list item\n");
-        exit(1);
+    // Halved tiles must stay on whole pixels
+    int levels = 1;
+    while (levels < MIP_MAX_LEVELS && ((tile_width | tile_height | spacing) & ((1 << levels) - 1)) == 0) {
+        levels++;
     }
+    tilemap->texture = _load_mipmapped_texture(filename, levels);
 
-    object_template_list_item->object_template = template;
-    object_template_list_item->name = objt_name;
-    object_template_list_item->next = NULL;
+    tilemap->tile_width = tile_width;
+    tilemap->tile_height = tile_height;
+    tilemap->spacing = spacing;
+    tilemap->nb_rows = nb_rows;
+    tilemap->nb_cols = nb_cols;
 
-    if (_object_template_list == NULL) {
-        _object_template_list = object_template_list_item;
-    } else {
-        ObjectTemplateList *current = _object_template_list;
-        while (current->next != NULL) {
-            if (strcmp(current->name, name) == 0) {
-                fprintf(stderr, "[ENGINE] Object template name already exists: %s\n", name);
-                exit(1);
-            }
-            current = current->next;
+    tilemap->tiles = (SDL_Rect *)malloc(sizeof(SDL_Rect) * nb_rows * nb_cols);
+    if (tilemap->tiles == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for tilemap tiles\n");
+        exit(1);
+    }
+    for (int row = 0; row < nb_rows; row++) {
+        for (int col = 0; col < nb_cols; col++) {
+            SDL_Rect *src = &tilemap->tiles[row * nb_cols + col];
+            src->x = col * (tile_width + spacing);
+            src->y = row * (tile_height + spacing);
+            src->w = tile_width;
+            src->h = tile_height;
         }
-        current->next = object_template_list_item;
     }
+
+    return tilemap;
 }
 
 /**
- * Creates an object template
- * \param name The name of the object template
- * \param texture The texture of the object template
- * \param width The width of the object template
- * \param height The height of the object template
- * \param hitbox True if objects created from this template have a hitbox, false otherwise
- * \return The object template
+ * Draws a tile of a tilemap at a destination size, sampling the mip level nearest to that size
+ * \param tilemap The tilemap to use
+ * \param id The id of the tile
+ * \param dest The destination rectangle
  */
-ObjectTemplate *create_object_template(char *name, Texture *texture, int width, int height, bool hitbox) {
-    _assert_engine_init();
-    ObjectTemplate *object_template = (ObjectTemplate *)malloc(sizeof(ObjectTemplate));
-    if (object_template == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for object template\n");
-        exit(1);
+static void _draw_tilemap_tile(Tilemap *tilemap, int id, SDL_Rect *dest) {
+    SDL_Rect *src = &tilemap->tiles[id];
+    int level;
+    Texture *texture = _mip_level(tilemap->texture, src->w, src->h, dest->w, dest->h, &level);
+    if (level == 0) {
+        SDL_RenderCopy(_engine->renderer, texture, src, dest);
+        return;
     }
-    object_template->texture = texture;
-    object_template->width = width;
-    object_template->height = height;
-    object_template->hitbox = hitbox;
-
-    // Add object template to object template list
-    _add_object_template_to_list(object_template, name);
-
-    return object_template;
+    SDL_Rect level_src = {src->x >> level, src->y >> level, src->w >> level, src->h >> level};
+    SDL_RenderCopy(_engine->renderer, texture, &level_src, dest);
 }
 
 /**
- * Gets an object template by name
- * \param name The name of the object template
- * \return The object template
+ * Gets the id of a tile in a tilemap
+ * \param tilemap The tilemap to use
+ * \param tile_row The row of the tile
+ * \param tile_col The column of the tile
+ * \return The id of the tile (`tile_row * nb_cols + tile_col`)
  */
-ObjectTemplate *get_template_by_name(char *name) {
-    _assert_engine_init();
-    ObjectTemplateList *current = _object_template_list;
-    while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
-            return current->object_template;
-        }
-        current = current->next;
+int get_tile_id(Tilemap *tilemap, int tile_row, int tile_col) {
+    if (tile_row < 0 || tile_col < 0 || tile_row >= tilemap->nb_rows || tile_col >= tilemap->nb_cols) {
+        fprintf(stderr, "[ENGINE] Tile out of bounds\n");
+        exit(1);
     }
-    fprintf(stderr, "[ENGINE] Object template not found: %s\n", name);
-    exit(1);
+    return tile_row * tilemap->nb_cols + tile_col;
 }
 
 /**
- * Destroys an object template by name
- * \param name The name of the object template
+ * Gets a tile from a tilemap
+ * \param tilemap The tilemap to use
+ * \param tile_row The row of the tile
+ * \param tile_col The column of the tile
+ * \return The tile
+ * \note The tile is returned by value, it does not need to be destroyed
  */
-void destroy_object_template(char *name) {
+Tile get_tile(Tilemap *tilemap, int tile_row, int tile_col) {
     _assert_engine_init();
-    ObjectTemplateList *current = _object_template_list;
-    ObjectTemplateList *prev = NULL;
-    while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
-            if (prev == NULL) {
-                _object_template_list = current->next;
-            } else {
-                prev->next = current->next;
-            }
-            free(current->object_template);
-            free(current->name);
-            free(current);
-            return;
-        }
-        prev = current;
-        current = current->next;
-    }
+    Tile tile = {tilemap, tile_row, tile_col, get_tile_id(tilemap, tile_row, tile_col)};
+    return tile;
 }
 
 /**
- * Destroys all object templates
+ * Draws a tile
+ * \param tile The tile to draw
+ * \param x The x position to draw the tile
+ * \param y The y position to draw the tile
  */
-void destroy_all_templates() {
+void draw_tile(Tile *tile, int x, int y) {
     _assert_engine_init();
-    ObjectTemplateList *current = _object_template_list;
-    while (current != NULL) {
-        ObjectTemplateList *next = current->next;
-        free(current->object_template);
-        free(current->name);
-        free(current);
-        current = next;
-    }
-    _object_template_list = NULL;
+    flush_geometry();
+    SDL_Rect dest = {x, y, tile->tilemap->tile_width, tile->tilemap->tile_height};
+    _draw_tilemap_tile(tile->tilemap, tile->id, &dest);
 }
 
-/***********************************************
- * Hitbox functions
- ***********************************************/
+/**
+ * Draws a tile with the specified width and height
+ * \param tile The tile to draw
+ * \param x The x position to draw the tile
+ * \param y The y position to draw the tile
+ * \param width The width of the tile
+ * \param height The height of the tile
+ */
+void draw_tile_with_size(Tile *tile, int x, int y, int width, int height) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Rect dest = {x, y, width, height};
+    _draw_tilemap_tile(tile->tilemap, tile->id, &dest);
+}
 
 /**
- * Creates a hitbox
- * \param name The name of the hitbox
- * \param x The x position of the hitbox
- * \param y The y position of the hitbox
- * \param width The width of the hitbox
- * \param height The height of the hitbox
- * \return The hitbox
+ * Draws a tile from a tilemap
+ * \param tilemap The tilemap to use
+ * \param tile_row The row of the tile
+ * \param tile_col The column of the tile
+ * \param x The x position to draw the tile
+ * \param y The y position to draw the tile
  */
-Object *create_hitbox(char *name, int x, int y, int width, int height) {
+void draw_tile_from_tilemap(Tilemap *tilemap, int tile_row, int tile_col, int x, int y) {
     _assert_engine_init();
-    Object *new_hitbox = (Object *)malloc(sizeof(Object));
-    if (new_hitbox == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for hitbox\n");
+    draw_tile_id(tilemap, get_tile_id(tilemap, tile_row, tile_col), x, y);
+}
+
+/**
+ * Draws a tile from a tilemap by id
+ * \param tilemap The tilemap to use
+ * \param id The id of the tile, see `get_tile_id`
+ * \param x The x position to draw the tile
+ * \param y The y position to draw the tile
+ * \note This is the fastest way to draw a tile, the source rectangle is read from the tilemap table
+ */
+void draw_tile_id(Tilemap *tilemap, int id, int x, int y) {
+    _assert_engine_init();
+    flush_geometry();
+    if ((unsigned int)id >= (unsigned int)(tilemap->nb_rows * tilemap->nb_cols)) {
+        fprintf(stderr, "[ENGINE] Tile out of bounds\n");
         exit(1);
     }
-    new_hitbox->x = x;
-    new_hitbox->y = y;
-    new_hitbox->width = width;
-    new_hitbox->height = height;
-    new_hitbox->hitbox = true;
-
-    _add_object_to_list(new_hitbox, name);
 
-    return new_hitbox;
+    SDL_Rect dest = {x, y, tilemap->tile_width, tilemap->tile_height};
+    _draw_tilemap_tile(tilemap, id, &dest);
 }
 
 /**
- * Checks if a hitbox is colliding with another hitbox
- * \param hitbox1 The first hitbox
- * \param hitbox2 The second hitbox
- * \return True if the hitboxes are colliding, false otherwise
+ * Destroys a tilemap
+ * \param tilemap The tilemap to destroy
  */
-bool hitbox_is_colliding(Object *hitbox1, Object *hitbox2) {
-    return hitbox1->x < hitbox2->x + hitbox2->width && hitbox1->x + hitbox1->width > hitbox2->x && hitbox1->y < hitbox2->y + hitbox2->height && hitbox1->y + hitbox1->height > hitbox2->y;
+void destroy_tilemap(Tilemap *tilemap) {
+    _assert_engine_init();
+    _destroy_mipmapped_texture(tilemap->texture);
+    free(tilemap->tiles);
+    free(tilemap);
 }
 
 /***********************************************
- * Geometry functions
+ * Animation functions
  ***********************************************/
 
 /**
- * Draws a line
- * \param x1 The x position of the first point
- * \param y1 The y position of the first point
- * \param x2 The x position of the second point
- * \param y2 The y position of the second point
- * \param color The color of the line
+ * Creates an animation clip
+ * \param tilemap The tilemap holding the frames
+ * \param frames The tile id of each frame, see `get_tile_id`
+ * \param durations The duration of each frame in milliseconds
+ * \param nb_frames The number of frames
+ * \param loop The loop mode of the clip
+ * \return The animation clip
+ * \note The frames and durations are copied
  */
-void draw_line(int x1, int y1, int x2, int y2, Color color) {
+AnimationClip *create_animation_clip(Tilemap *tilemap, int *frames, int *durations, int nb_frames, AnimationLoop loop) {
     _assert_engine_init();
-    lineRGBA(_engine->renderer, x1, y1, x2, y2, color.r, color.g, color.b, color.a);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+    if (nb_frames <= 0) {
+        fprintf(stderr, "[ENGINE] Animation clip must have at least one frame\n");
+        exit(1);
+    }
+
+    AnimationClip *clip = (AnimationClip *)malloc(sizeof(AnimationClip) + sizeof(int) * nb_frames * 2);
+    if (clip == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for animation clip\n");
+        exit(1);
+    }
+
+    clip->tilemap = tilemap;
+    clip->frames = (int *)(clip + 1);
+    clip->durations = clip->frames + nb_frames;
+    clip->nb_frames = nb_frames;
+    clip->loop = loop;
+
+    Sint64 total = 0;
+    for (int i = 0; i < nb_frames; i++) {
+        if ((unsigned int)frames[i] >= (unsigned int)(tilemap->nb_rows * tilemap->nb_cols)) {
+            fprintf(stderr, "[ENGINE] Tile out of bounds\n");
+            exit(1);
+        }
+        if (durations[i] <= 0) {
+            fprintf(stderr, "[ENGINE] Animation frame duration must be positive\n");
+            exit(1);
+        }
+        clip->frames[i] = frames[i];
+        clip->durations[i] = durations[i];
+        total += durations[i];
+    }
+
+    // Ping pong plays the inner frames twice and the end frames once per cycle
+    Sint64 cycle = total;
+    if (loop == ANIMATION_PING_PONG) cycle = nb_frames > 1 ? total * 2 - durations[0] - durations[nb_frames - 1] : total * 2;
+    if (cycle > SDL_MAX_SINT32) {
+        fprintf(stderr, "[ENGINE] Animation clip is too long\n");
+        exit(1);
+    }
+    clip->cycle = (int)cycle;
+
+    return clip;
 }
 
 /**
- * Draws a rectangle
- * \param x1 The x position of the point at the top-left corner of the rectangle
- * \param y1 The y position of the point at the top-left corner of the rectangle
- * \param x2 The x position of the point at the bottom-right corner of the rectangle
- * \param y2 The y position of the point at the bottom-right corner of the rectangle
- * \param color The color of the rectangle
+ * Destroys an animation clip
+ * \param clip The animation clip to destroy
+ * \warning Animations using this clip must be destroyed or switched to another clip first
  */
-void draw_rect(int x1, int y1, int x2, int y2, Color color) {
-    _assert_engine_init();
-    rectangleRGBA(_engine->renderer, x1, y1, x2, y2, color.r, color.g, color.b, color.a);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+void destroy_animation_clip(AnimationClip *clip) {
+    free(clip);
 }
 
 /**
- * Draws an ellipse
- * \param x The x position of the ellipse
- * \param y The y position of the ellipse
- * \param rx The x radius of the ellipse
- * \param ry The y radius of the ellipse
- * \param color The color of the ellipse
+ * Checks that an animation handle refers to a live animation
+ * \param animation The animation to check
  */
-void draw_ellipse(int x, int y, int rx, int ry, Color color) {
-    _assert_engine_init();
-    ellipseRGBA(_engine->renderer, x, y, rx, ry, color.r, color.g, color.b, color.a);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+static void _assert_animation(Animation animation) {
+    if (animation < 0 || animation >= _animations.count || _animations.clips[animation] == NULL) {
+        fprintf(stderr, "[ENGINE] Animation not found: %d\n", animation);
+        exit(1);
+    }
 }
 
 /**
- * Draws a circle
- * \param x The x position of the circle
- * \param y The y position of the circle
- * \param radius The radius of the circle
- * \param color The color of the circle
+ * Grows the animation states arrays
+ * \param capacity The new number of slots
  */
-void draw_circle(int x, int y, int radius, Color color) {
-    _assert_engine_init();
-    circleRGBA(_engine->renderer, x, y, radius, color.r, color.g, color.b, color.a);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+static void _animation_states_resize(int capacity) {
+    _animations.clips = (AnimationClip **)realloc(_animations.clips, sizeof(AnimationClip *) * capacity);
+    _animations.frames = (int *)realloc(_animations.frames, sizeof(int) * capacity);
+    _animations.elapsed = (int *)realloc(_animations.elapsed, sizeof(int) * capacity);
+    _animations.directions = (int *)realloc(_animations.directions, sizeof(int) * capacity);
+    _animations.playing = (bool *)realloc(_animations.playing, sizeof(bool) * capacity);
+    _animations.finished = (bool *)realloc(_animations.finished, sizeof(bool) * capacity);
+    _animations.next_free = (int *)realloc(_animations.next_free, sizeof(int) * capacity);
+    if (_animations.clips == NULL || _animations.frames == NULL || _animations.elapsed == NULL || _animations.directions == NULL || _animations.playing == NULL || _animations.finished == NULL || _animations.next_free == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for animations\n");
+        exit(1);
+    }
+    _animations.capacity = capacity;
 }
 
 /**
- * Draws a line with a specified thickness
- * \param x1 The x position of the first point
- * \param y1 The y position of the first point
- * \param x2 The x position of the second point
- * \param y2 The y position of the second point
- * \param color The color of the line
- * \param thickness The thickness of the line
+ * Advances every playing animation
+ * \param dt The time elapsed since the last frame in milliseconds
+ * \note Called by the engine once per frame, it is a single pass over the animation states
+ * \note Whole cycles of looping clips are skipped at once, at most one cycle of frames is stepped through
  */
-void draw_line_thick(int x1, int y1, int x2, int y2, Color color, int thickness) {
-    _assert_engine_init();
-    thickLineRGBA(_engine->renderer, x1, y1, x2, y2, thickness, color.r, color.g, color.b, color.a);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+static void _update_animations(int dt) {
+    AnimationClip **clips = _animations.clips;
+    int *frames = _animations.frames;
+    int *elapsed = _animations.elapsed;
+    int *directions = _animations.directions;
+    bool *playing = _animations.playing;
+    bool *finished = _animations.finished;
+
+    for (int i = 0; i < _animations.count; i++) {
+        if (!playing[i]) continue;
+        AnimationClip *clip = clips[i];
+
+        elapsed[i] += dt;
+        if (clip->loop != ANIMATION_ONCE && elapsed[i] >= clip->cycle) elapsed[i] %= clip->cycle;
+        while (elapsed[i] >= clip->durations[frames[i]]) {
+            elapsed[i] -= clip->durations[frames[i]];
+            int next = frames[i] + directions[i];
+            if (next < 0 || next >= clip->nb_frames) {
+                if (clip->loop == ANIMATION_ONCE) {
+                    playing[i] = false;
+                    finished[i] = true;
+                    elapsed[i] = 0;
+                    break;
+                } else if (clip->loop == ANIMATION_LOOP) {
+                    next = 0;
+                } else {
+                    directions[i] = -directions[i];
+                    next = clip->nb_frames > 1 ? frames[i] + directions[i] : 0;
+                }
+            }
+            frames[i] = next;
+        }
+    }
 }
 
 /**
- * Draws a rectangle with a specified thickness
- * \param x1 The x position of the point at the top-left corner of the rectangle
- * \param y1 The y position of the point at the top-left corner of the rectangle
- * \param x2 The x position of the point at the bottom-right corner of the rectangle
- * \param y2 The y position of the point at the bottom-right corner of the rectangle
- * \param color The color of the rectangle
- * \param thickness The thickness of the rectangle
+ * Creates an animation and starts playing it
+ * \param clip The animation clip to play
+ * \return The animation
+ * \note Animations are advanced by the engine every frame, before the draw function
  */
-void draw_rect_thick(int x1, int y1, int x2, int y2, Color color, int thickness) {
+Animation create_animation(AnimationClip *clip) {
     _assert_engine_init();
-    for (int i = 0; i < thickness; i++) {
-        rectangleRGBA(_engine->renderer, x1 + i, y1 + i, x2 - i, y2 - i, color.r, color.g, color.b, color.a);
+    if (clip == NULL) {
+        fprintf(stderr, "[ENGINE] Animation clip is NULL\n");
+        exit(1);
     }
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+    Animation animation;
+    if (_animations.first_free != -1) {
+        animation = _animations.first_free;
+        _animations.first_free = _animations.next_free[animation];
+    } else {
+        if (_animations.count == _animations.capacity) {
+            _animation_states_resize(_animations.capacity ? _animations.capacity * 2 : ANIMATION_STATES_SIZE);
+        }
+        animation = _animations.count++;
+    }
+
+    _animations.clips[animation] = clip;
+    _animations.frames[animation] = 0;
+    _animations.elapsed[animation] = 0;
+    _animations.directions[animation] = 1;
+    _animations.playing[animation] = true;
+    _animations.finished[animation] = false;
+
+    return animation;
 }
 
 /**
- * Draws a circle with a specified thickness
- * \param x The x position of the circle
- * \param y The y position of the circle
- * \param radius The radius of the circle
- * \param color The color of the circle
- * \param thickness The thickness of the circle
+ * Changes the clip of an animation and restarts it
+ * \param animation The animation
+ * \param clip The new animation clip
  */
-void draw_circle_thick(int x, int y, int radius, Color color, int thickness) {
-    _assert_engine_init();
-    thickCircleRGBA(_engine->renderer, x, y, radius, color.r, color.g, color.b, color.a, thickness);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+void set_animation_clip(Animation animation, AnimationClip *clip) {
+    _assert_animation(animation);
+    if (clip == NULL) {
+        fprintf(stderr, "[ENGINE] Animation clip is NULL\n");
+        exit(1);
+    }
+    _animations.clips[animation] = clip;
+    _animations.frames[animation] = 0;
+    _animations.elapsed[animation] = 0;
+    _animations.directions[animation] = 1;
+    _animations.playing[animation] = true;
+    _animations.finished[animation] = false;
 }
 
 /**
- * Draws an ellipse with a specified thickness
- * \param x The x position of the ellipse
- * \param y The y position of the ellipse
- * \param rx The x radius of the ellipse
- * \param ry The y radius of the ellipse
- * \param color The color of the ellipse
- * \param thickness The thickness of the ellipse
+ * Pauses an animation
+ * \param animation The animation to pause
  */
-void draw_ellipse_thick(int x, int y, int rx, int ry, Color color, int thickness) {
-    _assert_engine_init();
-    thickEllipseRGBA(_engine->renderer, x, y, rx, ry, color.r, color.g, color.b, color.a, thickness);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+void pause_animation(Animation animation) {
+    _assert_animation(animation);
+    _animations.playing[animation] = false;
 }
 
 /**
- * Draws geometry from a texture
- * \param texture The texture to draw
- * \param x The x position to draw the texture
- * \param y The y position to draw the texture
+ * Resumes a paused animation
+ * \param animation The animation to resume
+ * \note A finished animation is restarted, a paused one continues from its current frame
  */
-void draw_geometry(Texture *texture, int x, int y) {
-    _assert_engine_init();
-    SDL_Rect rect = {x, y, _engine->width, _engine->height};
-    SDL_RenderCopy(_engine->renderer, texture, NULL, &rect);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+void resume_animation(Animation animation) {
+    _assert_animation(animation);
+    if (_animations.finished[animation]) {
+        _animations.frames[animation] = 0;
+        _animations.elapsed[animation] = 0;
+        _animations.directions[animation] = 1;
+        _animations.finished[animation] = false;
+    }
+    _animations.playing[animation] = true;
 }
 
 /**
- * Create a line as a texture
- * \param name The name of the texture
- * \param x1 The x position of the first point
- * \param y1 The y position of the first point
- * \param x2 The x position of the second point
- * \param y2 The y position of the second point
- * \param color The color of the line
- * \return The texture
+ * Checks if an animation has finished
+ * \param animation The animation
+ * \return True if the animation clip plays once and its last frame is over, false otherwise
+ * \note An animation paused on its last frame is not finished
  */
-Texture *create_line(char *name, int x1, int y1, int x2, int y2, Color color) {
-    _assert_engine_init();
-    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderTarget(_engine->renderer, texture);
+bool animation_finished(Animation animation) {
+    _assert_animation(animation);
+    return _animations.finished[animation];
+}
 
-    lineRGBA(_engine->renderer, x1, y1, x2, y2, color.r, color.g, color.b, color.a);
+/**
+ * Gets the tile id of the current frame of an animation
+ * \param animation The animation
+ * \return The tile id in the tilemap of the clip
+ */
+int get_animation_tile_id(Animation animation) {
+    _assert_animation(animation);
+    return _animations.clips[animation]->frames[_animations.frames[animation]];
+}
 
-    SDL_SetRenderTarget(_engine->renderer, NULL);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+/**
+ * Draws the current frame of an animation
+ * \param animation The animation to draw
+ * \param x The x position to draw the animation
+ * \param y The y position to draw the animation
+ */
+void draw_animation(Animation animation, int x, int y) {
+    _assert_animation(animation);
+    AnimationClip *clip = _animations.clips[animation];
+    draw_tile_id(clip->tilemap, clip->frames[_animations.frames[animation]], x, y);
+}
 
-    _add_to_texture_list(texture, name);
+/**
+ * Destroys an animation
+ * \param animation The animation to destroy
+ * \note The handle may be reused by the next created animation
+ */
+void destroy_animation(Animation animation) {
+    _assert_animation(animation);
+    _animations.clips[animation] = NULL;
+    _animations.playing[animation] = false;
+    _animations.next_free[animation] = _animations.first_free;
+    _animations.first_free = animation;
+}
 
-    return texture;
+/**
+ * Destroys all animations
+ * \note The animation clips are not destroyed
+ */
+void destroy_all_animations() {
+    free(_animations.clips);
+    free(_animations.frames);
+    free(_animations.elapsed);
+    free(_animations.directions);
+    free(_animations.playing);
+    free(_animations.finished);
+    free(_animations.next_free);
+    _animations = (AnimationStates){NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, -1};
 }
 
+/***********************************************
+ * Particle functions
+ ***********************************************/
+
 /**
- * Create a rectangle as a texture
- * \param name The name of the texture
- * \param x1 The x position of the point at the top-left corner of the rectangle
- * \param y1 The y position of the point at the top-left corner of the rectangle
- * \param x2 The x position of the point at the bottom-right corner of the rectangle
- * \param y2 The y position of the point at the bottom-right corner of the rectangle
- * \param color The color of the rectangle
- * \return The texture
+ * Creates a particle emitter
+ * \param texture The texture of the particles, NULL to draw plain squares
+ * \param capacity The maximum number of living particles
+ * \param size The size of the particles in pixels
+ * \param gravity The vertical acceleration of the particles in pixels per second squared
+ * \return The particle emitter
+ * \note Particles of every emitter are moved by the engine every frame, before the draw function
  */
-Texture *create_rect(char *name, int x1, int y1, int x2, int y2, Color color) {
+ParticleEmitter *create_particle_emitter(Texture *texture, int capacity, float size, float gravity) {
     _assert_engine_init();
-    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderTarget(_engine->renderer, texture);
+    ParticleEmitter *emitter = (ParticleEmitter *)malloc(sizeof(ParticleEmitter));
+    if (emitter == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for particle emitter\n");
+        exit(1);
+    }
 
-    rectangleRGBA(_engine->renderer, x1, y1, x2, y2, color.r, color.g, color.b, color.a);
+    emitter->texture = texture;
+    emitter->size = size;
+    emitter->gravity = gravity;
+    emitter->count = 0;
+    emitter->capacity = capacity;
+    emitter->x = (float *)malloc(sizeof(float) * capacity);
+    emitter->y = (float *)malloc(sizeof(float) * capacity);
+    emitter->vx = (float *)malloc(sizeof(float) * capacity);
+    emitter->vy = (float *)malloc(sizeof(float) * capacity);
+    emitter->life = (float *)malloc(sizeof(float) * capacity);
+    emitter->max_life = (float *)malloc(sizeof(float) * capacity);
+    emitter->colors = (Color *)malloc(sizeof(Color) * capacity);
+    emitter->vertices = (SDL_Vertex *)malloc(sizeof(SDL_Vertex) * capacity * 4);
+    emitter->indices = (int *)malloc(sizeof(int) * capacity * 6);
+    if (emitter->x == NULL || emitter->y == NULL || emitter->vx == NULL || emitter->vy == NULL || emitter->life == NULL || emitter->max_life == NULL || emitter->colors == NULL || emitter->vertices == NULL || emitter->indices == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for particles\n");
+        exit(1);
+    }
 
-    SDL_SetRenderTarget(_engine->renderer, NULL);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+    // The quads never change topology, the indices are built once
+    for (int i = 0; i < capacity; i++) {
+        int *index = &emitter->indices[i * 6];
+        int vertex = i * 4;
+        index[0] = vertex;
+        index[1] = vertex + 1;
+        index[2] = vertex + 2;
+        index[3] = vertex;
+        index[4] = vertex + 2;
+        index[5] = vertex + 3;
+    }
 
-    _add_to_texture_list(texture, name);
+    emitter->next = _particle_emitters;
+    _particle_emitters = emitter;
 
-    return texture;
+    return emitter;
 }
 
 /**
- * Create a circle as a texture
- * \param name The name of the texture
- * \param x The x position of the circle
- * \param y The y position of the circle
- * \param radius The radius of the circle
- * \param color The color of the circle
- * \return The texture
+ * Emits particles in random directions
+ * \param emitter The particle emitter
+ * \param count The number of particles to emit
+ * \param x The x position of the particles
+ * \param y The y position of the particles
+ * \param speed The maximum speed of the particles in pixels per second
+ * \param life The maximum life of the particles in milliseconds
+ * \param color The color of the particles
+ * \note Particles that do not fit in the emitter capacity are dropped, nothing is emitted without a positive life
  */
-Texture *create_circle(char *name, int x, int y, int radius, Color color) {
-    _assert_engine_init();
-    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderTarget(_engine->renderer, texture);
+void emit_particles(ParticleEmitter *emitter, int count, float x, float y, float speed, int life, Color color) {
+    if (life <= 0) return;
+    if (count > emitter->capacity - emitter->count) {
+        count = emitter->capacity - emitter->count;
+    }
+
+    for (int i = emitter->count; i < emitter->count + count; i++) {
+        float angle = (float)rand() / RAND_MAX * 2.0f * (float)M_PI;
+        float velocity = (float)rand() / RAND_MAX * speed;
+        emitter->x[i] = x;
+        emitter->y[i] = y;
+        emitter->vx[i] = cosf(angle) * velocity;
+        emitter->vy[i] = sinf(angle) * velocity;
+        emitter->max_life[i] = (0.5f + 0.5f * rand() / RAND_MAX) * life / 1000.0f;
+        emitter->life[i] = emitter->max_life[i];
+        emitter->colors[i] = color;
+    }
+    emitter->count += count;
+}
+
+/**
+ * Moves the particles of an emitter and removes the dead ones
+ * \param emitter The particle emitter
+ * \param dt The time elapsed since the last frame in seconds
+ */
+static void _update_particle_emitter(ParticleEmitter *emitter, float dt) {
+    float *restrict x = emitter->x;
+    float *restrict y = emitter->y;
+    float *restrict vx = emitter->vx;
+    float *restrict vy = emitter->vy;
+    float *restrict life = emitter->life;
+    float gravity = emitter->gravity * dt;
+    int count = emitter->count;
+
+    // Branch-free loops over the arrays, vectorized by the compiler
+    for (int i = 0; i < count; i++) {
+        vy[i] += gravity;
+    }
+    for (int i = 0; i < count; i++) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        life[i] -= dt;
+    }
+
+    // Dead particles are replaced by the last living one
+    int i = 0;
+    while (i < count) {
+        if (life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        count--;
+        x[i] = x[count];
+        y[i] = y[count];
+        vx[i] = vx[count];
+        vy[i] = vy[count];
+        life[i] = life[count];
+        emitter->max_life[i] = emitter->max_life[count];
+        emitter->colors[i] = emitter->colors[count];
+    }
+    emitter->count = count;
+}
+
+/**
+ * Updates every particle emitter
+ * \param dt The time elapsed since the last frame in milliseconds
+ */
+static void _update_particles(int dt) {
+    ParticleEmitter *current = _particle_emitters;
+    while (current != NULL) {
+        _update_particle_emitter(current, dt / 1000.0f);
+        current = current->next;
+    }
+}
+
+/**
+ * Draws the particles of an emitter
+ * \param emitter The particle emitter to draw
+ * \note All the particles of the emitter are drawn with a single geometry call
+ */
+void draw_particles(ParticleEmitter *emitter) {
+    _assert_engine_init();
+    flush_geometry();
+    if (emitter->count == 0) return;
+
+    float half = emitter->size / 2.0f;
+    SDL_Vertex *vertex = emitter->vertices;
+    for (int i = 0; i < emitter->count; i++) {
+        SDL_Color color = emitter->colors[i];
+        // Written so that a NaN ratio fades out instead of converting to Uint8
+        float fade = emitter->life[i] / emitter->max_life[i];
+        color.a = fade > 0.0f ? (Uint8)(color.a * (fade < 1.0f ? fade : 1.0f)) : 0;
+        float left = emitter->x[i] - half;
+        float top = emitter->y[i] - half;
+        float right = emitter->x[i] + half;
+        float bottom = emitter->y[i] + half;
+
+        vertex[0] = (SDL_Vertex){{left, top}, color, {0.0f, 0.0f}};
+        vertex[1] = (SDL_Vertex){{right, top}, color, {1.0f, 0.0f}};
+        vertex[2] = (SDL_Vertex){{right, bottom}, color, {1.0f, 1.0f}};
+        vertex[3] = (SDL_Vertex){{left, bottom}, color, {0.0f, 1.0f}};
+        vertex += 4;
+    }
+
+    Texture *texture = emitter->texture == NULL ? NULL : _mip_texture(emitter->texture, (int)emitter->size, (int)emitter->size);
+    if (texture == NULL) SDL_SetRenderDrawBlendMode(_engine->renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(_engine->renderer, texture, emitter->vertices, emitter->count * 4, emitter->indices, emitter->count * 6);
+}
+
+/**
+ * Removes every particle of an emitter
+ * \param emitter The particle emitter
+ */
+void clear_particles(ParticleEmitter *emitter) {
+    emitter->count = 0;
+}
+
+/**
+ * Frees the memory of a particle emitter
+ * \param emitter The particle emitter
+ */
+static void _free_particle_emitter(ParticleEmitter *emitter) {
+    free(emitter->x);
+    free(emitter->y);
+    free(emitter->vx);
+    free(emitter->vy);
+    free(emitter->life);
+    free(emitter->max_life);
+    free(emitter->colors);
+    free(emitter->vertices);
+    free(emitter->indices);
+    free(emitter);
+}
+
+/**
+ * Destroys a particle emitter
+ * \param emitter The particle emitter to destroy
+ * \note The texture of the emitter is not destroyed
+ */
+void destroy_particle_emitter(ParticleEmitter *emitter) {
+    ParticleEmitter *current = _particle_emitters;
+    ParticleEmitter *prev = NULL;
+    while (current != NULL) {
+        if (current == emitter) {
+            if (prev == NULL) {
+                _particle_emitters = current->next;
+            } else {
+                prev->next = current->next;
+            }
+            _free_particle_emitter(current);
+            return;
+        }
+        prev = current;
+        current = current->next;
+    }
+}
+
+/**
+ * Destroys all particle emitters
+ */
+void destroy_all_particle_emitters() {
+    ParticleEmitter *current = _particle_emitters;
+    while (current != NULL) {
+        ParticleEmitter *next = current->next;
+        _free_particle_emitter(current);
+        current = next;
+    }
+    _particle_emitters = NULL;
+}
+
+/***********************************************
+ * Object functions
+ ***********************************************/
+
+/**
+ * Adds an object to the object list
+ * \param object The object to add
+ * \param name The name of the object
+ */
+static void _add_object_to_list(Object *object, char *name) {
+    const char *obj_name = engine_intern(name);
+
+    ObjectList *object_list_item = (ObjectList *)_pool_alloc(&_object_list_pool);
+    object_list_item->object = object;
+    object_list_item->name = obj_name;
+    object_list_item->next = NULL;
+
+    if (_object_list == NULL) {
+        _object_list = object_list_item;
+    } else {
+        ObjectList *current = _object_list;
+        while (current->next != NULL) {
+            if (current->name == obj_name) {
+                fprintf(stderr, "[ENGINE] Object name already exists: %s\n", name);
+                exit(1);
+            }
+            current = current->next;
+        }
+        current->next = object_list_item;
+    }
+    _object_count++;
+}
+
+/**
+ * Creates an object
+ * \param name The name of the object
+ * \param texture The texture of the object
+ * \param x The x position of the object
+ * \param y The y position of the object
+ * \param width The width of the object
+ * \param height The height of the object
+ * \param hitbox True if the object has a hitbox, false otherwise
+ * \param data The data of the object
+ * \return The object
+ */
+Object *create_object(char *name, Texture *texture, int x, int y, int width, int height, bool hitbox, void *data) {
+    _assert_engine_init();
+    Object *object = (Object *)malloc(sizeof(Object));
+    if (object == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for object\n");
+        exit(1);
+    }
+
+    object->texture = texture;
+    object->x = x;
+    object->y = y;
+    object->width = width;
+    object->height = height;
+    object->hitbox = hitbox;
+    object->data = data;
+
+    _add_object_to_list(object, name);
+
+    return object;
+}
+
+/**
+ * Instantiates an object from an object template
+ * \param object_template The object template to instantiate
+ * \param x The x position of the object
+ * \param y The y position of the object
+ * \param data The data of the object
+ * \return The object
+ */
+Object *instantiate_object(ObjectTemplate *object_template, char *name, int x, int y, void *data) {
+    _assert_engine_init();
+    return create_object(name, object_template->texture, x, y, object_template->width, object_template->height, object_template->hitbox, data);
+}
+
+/**
+ * Checks if an object exists
+ * \param name The name of the object
+ * \return True if the object exists, false otherwise
+ */
+bool object_exists(char *name) {
+    _assert_engine_init();
+    const char *key = _intern_find(name);
+    ObjectList *current = _object_list;
+    while (current != NULL) {
+        if (current->name == key) {
+            return true;
+        }
+        current = current->next;
+    }
+    return false;
+}
+
+/**
+ * Draws an object
+ * \param object The object to draw
+ */
+void draw_object(Object *object) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Rect rect = {object->x, object->y, object->width, object->height};
+    SDL_RenderCopy(_engine->renderer, _mip_texture(object->texture, object->width, object->height), NULL, &rect);
+}
+
+/**
+ * Gets an object by name
+ * \param name The name of the object
+ * \return The object with the given name
+ */
+Object *get_object_by_name(char *name) {
+    _assert_engine_init();
+    const char *key = _intern_find(name);
+    ObjectList *current = _object_list;
+    while (current != NULL) {
+        if (current->name == key) {
+            return current->object;
+        }
+        current = current->next;
+    }
+    fprintf(stderr, "[ENGINE] Object not found: %s\n", name);
+    exit(1);
+}
+
+/**
+ * Destroys all objects with a given name
+ * \param name The name of the object
+ */
+void destroy_object_by_name(char *name) {
+    _assert_engine_init();
+    const char *key = _intern_find(name);
+    ObjectList *current = _object_list;
+    ObjectList *prev = NULL;
+    while (current != NULL) {
+        ObjectList *next = current->next;
+        if (current->name == key) {
+            if (prev == NULL) {
+                _object_list = next;
+            } else {
+                prev->next = next;
+            }
+            free(current->object);
+            _pool_free(&_object_list_pool, current);
+            _object_count--;
+        } else {
+            prev = current;
+        }
+        current = next;
+    }
+}
+
+/**
+ * Destroys all objects
+ */
+void destroy_all_objects() {
+    _assert_engine_init();
+    ObjectList *current = _object_list;
+    while (current != NULL) {
+        ObjectList *next = current->next;
+        free(current->object);
+        _pool_free(&_object_list_pool, current);
+        current = next;
+    }
+    _object_list = NULL;
+    _object_count = 0;
+}
+
+/**
+ * Gets the number of objects
+ * \return The number of objects
+ */
+int get_object_count() {
+    _assert_engine_init();
+    return _object_count;
+}
+
+/**
+ * Copies every object in a state array
+ * \param states The array to fill, in object order
+ * \param capacity The number of states of the array
+ * \return The number of objects copied, -1 if the array is too small
+ * \note The data of the objects is copied as a pointer, the state it points to must be saved by the game
+ */
+int save_objects(ObjectState *states, int capacity) {
+    _assert_engine_init();
+    if (_object_count > capacity) return -1;
+    ObjectState *state = states;
+    for (ObjectList *current = _object_list; current != NULL; current = current->next, state++) {
+        // Copied field by field, the padding stays zeroed so saves and their deltas do not depend on it
+        Object *object = current->object;
+        memset(state, 0, sizeof(ObjectState));
+        state->name = current->name;
+        state->object.texture = object->texture;
+        state->object.x = object->x;
+        state->object.y = object->y;
+        state->object.width = object->width;
+        state->object.height = object->height;
+        state->object.hitbox = object->hitbox;
+        state->object.data = object->data;
+    }
+    return _object_count;
+}
+
+/**
+ * Replaces every object with the objects of a state array
+ * \param states The states saved by `save_objects`
+ * \param count The number of states
+ * \note The existing objects are overwritten in order, so their pointers stay valid when the set of objects did not change since the save
+ */
+void restore_objects(const ObjectState *states, int count) {
+    _assert_engine_init();
+    ObjectList **link = &_object_list;
+    for (int i = 0; i < count; i++) {
+        ObjectList *current = *link;
+        if (current == NULL) {
+            current = (ObjectList *)_pool_alloc(&_object_list_pool);
+            current->object = (Object *)malloc(sizeof(Object));
+            if (current->object == NULL) {
+                fprintf(stderr, "[ENGINE] Failed to allocate memory for object\n");
+                exit(1);
+            }
+            current->next = NULL;
+            *link = current;
+        }
+        current->name = states[i].name;
+        *current->object = states[i].object;
+        link = &current->next;
+    }
+
+    // Objects created after the save
+    ObjectList *current = *link;
+    *link = NULL;
+    while (current != NULL) {
+        ObjectList *next = current->next;
+        free(current->object);
+        _pool_free(&_object_list_pool, current);
+        current = next;
+    }
+    _object_count = count;
+}
+
+/***********************************************
+ * Object template functions
+ ***********************************************/
+
+/**
+ * Adds an object template to the object template list
+ * \param template The object template to add
+ * \param name The name of the object template
+ */
+static void _add_object_template_to_list(ObjectTemplate *template, char *name) {
+    const char *objt_name = engine_intern(name);
+
+    ObjectTemplateList *object_template_list_item = (ObjectTemplateList *)_pool_alloc(&_object_template_list_pool);
+
+    object_template_list_item->object_template = template;
+    object_template_list_item->name = objt_name;
+    object_template_list_item->next = NULL;
+
+    if (_object_template_list == NULL) {
+        _object_template_list = object_template_list_item;
+    } else {
+        ObjectTemplateList *current = _object_template_list;
+        while (current->next != NULL) {
+            if (current->name == objt_name) {
+                fprintf(stderr, "[ENGINE] Object template name already exists: %s\n", name);
+                exit(1);
+            }
+            current = current->next;
+        }
+        current->next = object_template_list_item;
+    }
+}
+
+/**
+ * Creates an object template
+ * \param name The name of the object template
+ * \param texture The texture of the object template
+ * \param width The width of the object template
+ * \param height The height of the object template
+ * \param hitbox True if objects created from this template have a hitbox, false otherwise
+ * \return The object template
+ */
+ObjectTemplate *create_object_template(char *name, Texture *texture, int width, int height, bool hitbox) {
+    _assert_engine_init();
+    ObjectTemplate *object_template = (ObjectTemplate *)malloc(sizeof(ObjectTemplate));
+    if (object_template == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for object template\n");
+        exit(1);
+    }
+    object_template->texture = texture;
+    object_template->width = width;
+    object_template->height = height;
+    object_template->hitbox = hitbox;
+
+    // Add object template to object template list
+    _add_object_template_to_list(object_template, name);
+
+    return object_template;
+}
+
+/**
+ * Gets an object template by name
+ * \param name The name of the object template
+ * \return The object template
+ */
+ObjectTemplate *get_template_by_name(char *name) {
+    _assert_engine_init();
+    const char *key = _intern_find(name);
+    ObjectTemplateList *current = _object_template_list;
+    while (current != NULL) {
+        if (current->name == key) {
+            return current->object_template;
+        }
+        current = current->next;
+    }
+    fprintf(stderr, "[ENGINE] Object template not found: %s\n", name);
+    exit(1);
+}
+
+/**
+ * Destroys an object template by name
+ * \param name The name of the object template
+ */
+void destroy_object_template(char *name) {
+    _assert_engine_init();
+    const char *key = _intern_find(name);
+    ObjectTemplateList *current = _object_template_list;
+    ObjectTemplateList *prev = NULL;
+    while (current != NULL) {
+        if (current->name == key) {
+            if (prev == NULL) {
+                _object_template_list = current->next;
+            } else {
+                prev->next = current->next;
+            }
+            free(current->object_template);
+            _pool_free(&_object_template_list_pool, current);
+            return;
+        }
+        prev = current;
+        current = current->next;
+    }
+}
+
+/**
+ * Destroys all object templates
+ */
+void destroy_all_templates() {
+    _assert_engine_init();
+    ObjectTemplateList *current = _object_template_list;
+    while (current != NULL) {
+        ObjectTemplateList *next = current->next;
+        free(current->object_template);
+        _pool_free(&_object_template_list_pool, current);
+        current = next;
+    }
+    _object_template_list = NULL;
+}
+
+/***********************************************
+ * Hitbox functions
+ ***********************************************/
+
+/**
+ * Creates a hitbox
+ * \param name The name of the hitbox
+ * \param x The x position of the hitbox
+ * \param y The y position of the hitbox
+ * \param width The width of the hitbox
+ * \param height The height of the hitbox
+ * \return The hitbox
+ */
+Object *create_hitbox(char *name, int x, int y, int width, int height) {
+    _assert_engine_init();
+    Object *new_hitbox = (Object *)malloc(sizeof(Object));
+    if (new_hitbox == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for hitbox\n");
+        exit(1);
+    }
+    new_hitbox->x = x;
+    new_hitbox->y = y;
+    new_hitbox->width = width;
+    new_hitbox->height = height;
+    new_hitbox->hitbox = true;
+
+    _add_object_to_list(new_hitbox, name);
+
+    return new_hitbox;
+}
+
+/**
+ * Checks if a hitbox is colliding with another hitbox
+ * \param hitbox1 The first hitbox
+ * \param hitbox2 The second hitbox
+ * \return True if the hitboxes are colliding, false otherwise
+ */
+bool hitbox_is_colliding(Object *hitbox1, Object *hitbox2) {
+    return hitbox1->x < hitbox2->x + hitbox2->width && hitbox1->x + hitbox1->width > hitbox2->x && hitbox1->y < hitbox2->y + hitbox2->height && hitbox1->y + hitbox1->height > hitbox2->y;
+}
+
+/***********************************************
+ * Geometry functions
+ ***********************************************/
+
+/**
+ * Makes room in a geometry buffer
+ * \param buffer The geometry buffer
+ * \param nb_vertices The number of vertices to add
+ * \param nb_indices The number of indices to add
+ */
+static void _geometry_reserve(GeometryBuffer *buffer, int nb_vertices, int nb_indices) {
+    if (buffer->nb_vertices + nb_vertices > buffer->vertices_capacity) {
+        int capacity = buffer->vertices_capacity ? buffer->vertices_capacity * 2 : GEOMETRY_BUFFER_SIZE;
+        while (capacity < buffer->nb_vertices + nb_vertices) capacity *= 2;
+        buffer->vertices = (SDL_Vertex *)realloc(buffer->vertices, sizeof(SDL_Vertex) * capacity);
+        if (buffer->vertices == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to allocate memory for geometry vertices\n");
+            exit(1);
+        }
+        buffer->vertices_capacity = capacity;
+    }
+    if (buffer->nb_indices + nb_indices > buffer->indices_capacity) {
+        int capacity = buffer->indices_capacity ? buffer->indices_capacity * 2 : GEOMETRY_BUFFER_SIZE * 2;
+        while (capacity < buffer->nb_indices + nb_indices) capacity *= 2;
+        buffer->indices = (int *)realloc(buffer->indices, sizeof(int) * capacity);
+        if (buffer->indices == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to allocate memory for geometry indices\n");
+            exit(1);
+        }
+        buffer->indices_capacity = capacity;
+    }
+}
+
+/**
+ * Adds a vertex to a geometry buffer
+ * \param buffer The geometry buffer, with enough room reserved
+ * \param x The x position of the vertex
+ * \param y The y position of the vertex
+ * \param color The color of the vertex
+ */
+static void _geometry_vertex(GeometryBuffer *buffer, float x, float y, Color color) {
+    buffer->vertices[buffer->nb_vertices++] = (SDL_Vertex){{x, y}, color, {0.0f, 0.0f}};
+}
+
+/**
+ * Adds a quad to a geometry buffer from 4 vertices
+ * \param buffer The geometry buffer, with enough room reserved
+ * \param a,b,c,d The indices of the vertices, in order around the quad
+ */
+static void _geometry_quad(GeometryBuffer *buffer, int a, int b, int c, int d) {
+    int *index = &buffer->indices[buffer->nb_indices];
+    index[0] = a;
+    index[1] = b;
+    index[2] = c;
+    index[3] = a;
+    index[4] = c;
+    index[5] = d;
+    buffer->nb_indices += 6;
+}
+
+/**
+ * Computes the offsets across a stroke and the color at each offset
+ * \param thickness The thickness of the stroke
+ * \param color The color of the stroke
+ * \param antialiasing True to feather the edges of the stroke
+ * \param offsets The array to store the offsets, 4 entries
+ * \param colors The array to store the colors, 4 entries
+ * \return The number of offsets
+ */
+static int _stroke_profile(float thickness, Color color, bool antialiasing, float offsets[4], Color colors[4]) {
+    float half = thickness / 2.0f;
+    if (!antialiasing) {
+        offsets[0] = -half; colors[0] = color;
+        offsets[1] = half; colors[1] = color;
+        return 2;
+    }
+    float core = half > 0.5f ? half - 0.5f : 0.0f;
+    Color clear = color;
+    clear.a = 0;
+    if (thickness < 1.0f) color.a = (Uint8)(color.a * thickness);
+    offsets[0] = -half - 0.5f; colors[0] = clear;
+    offsets[1] = -core; colors[1] = color;
+    offsets[2] = core; colors[2] = color;
+    offsets[3] = half + 0.5f; colors[3] = clear;
+    return 4;
+}
+
+/**
+ * Tessellates a line into a geometry buffer
+ * \param buffer The geometry buffer
+ * \param x1,y1 The first point of the line
+ * \param x2,y2 The second point of the line
+ * \param thickness The thickness of the line
+ * \param color The color of the line
+ * \param cap True to extend the line by half its thickness at both ends
+ * \param antialiasing True to feather the edges of the line
+ */
+static void _tessellate_line(GeometryBuffer *buffer, float x1, float y1, float x2, float y2, float thickness, Color color, bool cap, bool antialiasing) {
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length == 0.0f) {
+        // A point is drawn as a square
+        dx = 1.0f;
+        length = 1.0f;
+        cap = true;
+    }
+    float ux = dx / length;
+    float uy = dy / length;
+    float half = thickness / 2.0f;
+    if (cap) {
+        x1 -= ux * half;
+        y1 -= uy * half;
+        x2 += ux * half;
+        y2 += uy * half;
+    }
+
+    // Offsets across the line and the color at each offset
+    float offsets[4];
+    Color colors[4];
+    int nb_offsets = _stroke_profile(thickness, color, antialiasing, offsets, colors);
+
+    _geometry_reserve(buffer, nb_offsets * 2, (nb_offsets - 1) * 6);
+    int first = buffer->nb_vertices;
+    for (int i = 0; i < nb_offsets; i++) {
+        _geometry_vertex(buffer, x1 - uy * offsets[i], y1 + ux * offsets[i], colors[i]);
+        _geometry_vertex(buffer, x2 - uy * offsets[i], y2 + ux * offsets[i], colors[i]);
+    }
+    for (int i = 0; i < nb_offsets - 1; i++) {
+        int v = first + i * 2;
+        _geometry_quad(buffer, v, v + 1, v + 3, v + 2);
+    }
+}
+
+/**
+ * Tessellates a polyline into a geometry buffer as one strip
+ * \param buffer The geometry buffer
+ * \param points The points of the polyline
+ * \param count The number of points
+ * \param thickness The thickness of the polyline
+ * \param color The color of the polyline
+ * \param antialiasing True to feather the edges of the polyline
+ * \note Consecutive segments share their vertices at each joint (mitered, limited to twice the thickness), so a translucent polyline never blends twice
+ * \note Both ends are extended by half the thickness
+ */
+static void _tessellate_polyline(GeometryBuffer *buffer, const SDL_FPoint *points, int count, float thickness, Color color, bool antialiasing) {
+    // Repeated points would give segments without a direction
+    SDL_FPoint *path = (SDL_FPoint *)engine_frame_alloc(sizeof(SDL_FPoint) * count);
+    int nb_points = 0;
+    for (int i = 0; i < count; i++) {
+        if (nb_points > 0 && points[i].x == path[nb_points - 1].x && points[i].y == path[nb_points - 1].y) continue;
+        path[nb_points++] = points[i];
+    }
+    if (nb_points < 2) {
+        if (count > 0) _tessellate_line(buffer, points[0].x, points[0].y, points[0].x, points[0].y, thickness, color, true, antialiasing);
+        return;
+    }
+
+    float offsets[4];
+    Color colors[4];
+    int nb_offsets = _stroke_profile(thickness, color, antialiasing, offsets, colors);
+    float half = thickness / 2.0f;
+    _geometry_reserve(buffer, nb_points * nb_offsets, (nb_points - 1) * (nb_offsets - 1) * 6);
+    int first = buffer->nb_vertices;
+
+    float prev_nx = 0.0f, prev_ny = 0.0f;
+    for (int i = 0; i < nb_points; i++) {
+        float x = path[i].x;
+        float y = path[i].y;
+        float nx, ny;
+        if (i + 1 < nb_points) {
+            float dx = path[i + 1].x - x;
+            float dy = path[i + 1].y - y;
+            float length = sqrtf(dx * dx + dy * dy);
+            nx = -dy / length;
+            ny = dx / length;
+        } else {
+            nx = prev_nx;
+            ny = prev_ny;
+        }
+
+        // Normal scaled so both edges stay at half the thickness from each segment
+        float mx = nx, my = ny;
+        if (i == 0) {
+            x -= ny * half;
+            y += nx * half;
+        } else if (i + 1 == nb_points) {
+            x += ny * half;
+            y -= nx * half;
+        } else {
+            mx = prev_nx + nx;
+            my = prev_ny + ny;
+            float length = sqrtf(mx * mx + my * my);
+            if (length < 1e-3f) {
+                mx = nx;
+                my = ny;
+            } else {
+                mx /= length;
+                my /= length;
+                float scale = 1.0f / (mx * nx + my * ny);
+                if (scale > 2.0f) scale = 2.0f;
+                mx *= scale;
+                my *= scale;
+            }
+        }
+        for (int j = 0; j < nb_offsets; j++) {
+            _geometry_vertex(buffer, x + mx * offsets[j], y + my * offsets[j], colors[j]);
+        }
+        prev_nx = nx;
+        prev_ny = ny;
+    }
+    for (int i = 0; i + 1 < nb_points; i++) {
+        int v = first + i * nb_offsets;
+        int w = v + nb_offsets;
+        for (int j = 0; j < nb_offsets - 1; j++) {
+            _geometry_quad(buffer, v + j, v + j + 1, w + j + 1, w + j);
+        }
+    }
+}
+
+/**
+ * Tessellates an axis-aligned filled rectangle into a geometry buffer
+ * \param buffer The geometry buffer
+ * \param x1,y1 The top-left corner of the rectangle
+ * \param x2,y2 The bottom-right corner of the rectangle (exclusive)
+ * \param color The color of the rectangle
+ */
+static void _tessellate_box(GeometryBuffer *buffer, float x1, float y1, float x2, float y2, Color color) {
+    if (x2 <= x1 || y2 <= y1) return;
+    _geometry_reserve(buffer, 4, 6);
+    int v = buffer->nb_vertices;
+    _geometry_vertex(buffer, x1, y1, color);
+    _geometry_vertex(buffer, x2, y1, color);
+    _geometry_vertex(buffer, x2, y2, color);
+    _geometry_vertex(buffer, x1, y2, color);
+    _geometry_quad(buffer, v, v + 1, v + 2, v + 3);
+}
+
+/**
+ * Tessellates a rectangle outline into a geometry buffer
+ * \param buffer The geometry buffer
+ * \param x1,y1 The top-left pixel of the rectangle
+ * \param x2,y2 The bottom-right pixel of the rectangle
+ * \param thickness The thickness of the outline, drawn inside the rectangle
+ * \param color The color of the outline
+ */
+static void _tessellate_rect(GeometryBuffer *buffer, int x1, int y1, int x2, int y2, int thickness, Color color) {
+    if (x1 > x2) { int tmp = x1; x1 = x2; x2 = tmp; }
+    if (y1 > y2) { int tmp = y1; y1 = y2; y2 = tmp; }
+    float left = x1, top = y1, right = x2 + 1, bottom = y2 + 1;
+    float t = thickness;
+    if (t * 2.0f >= right - left || t * 2.0f >= bottom - top) {
+        _tessellate_box(buffer, left, top, right, bottom, color);
+        return;
+    }
+    _tessellate_box(buffer, left, top, right, top + t, color);
+    _tessellate_box(buffer, left, bottom - t, right, bottom, color);
+    _tessellate_box(buffer, left, top + t, left + t, bottom - t, color);
+    _tessellate_box(buffer, right - t, top + t, right, bottom - t, color);
+}
+
+/**
+ * Computes the number of segments needed to draw a smooth ellipse
+ * \param radius The largest radius of the ellipse
+ * \return The number of segments, the error to the true curve stays under a quarter pixel
+ */
+static int _ellipse_segments(float radius) {
+    if (radius <= 1.0f) return 8;
+    int segments = (int)ceilf((float)M_PI / acosf(1.0f - 0.25f / radius));
+    if (segments < 8) segments = 8;
+    if (segments > 1024) segments = 1024;
+    return segments;
+}
+
+/**
+ * Tessellates an ellipse outline into a geometry buffer
+ * \param buffer The geometry buffer
+ * \param x,y The center of the ellipse
+ * \param rx,ry The radii of the ellipse
+ * \param thickness The thickness of the outline, centered on the radii
+ * \param color The color of the outline
+ * \param antialiasing True to feather the edges of the outline
+ */
+static void _tessellate_ellipse(GeometryBuffer *buffer, float x, float y, float rx, float ry, float thickness, Color color, bool antialiasing) {
+    float half = thickness / 2.0f;
+    float offsets[4];
+    Color colors[4];
+    int nb_offsets = _stroke_profile(thickness, color, antialiasing, offsets, colors);
+
+    int segments = _ellipse_segments((rx > ry ? rx : ry) + half);
+    _geometry_reserve(buffer, segments * nb_offsets, segments * (nb_offsets - 1) * 6);
+    int first = buffer->nb_vertices;
+
+    // Rotate the unit vector by a fixed step instead of calling cos/sin per segment
+    float step_cos = cosf(2.0f * (float)M_PI / segments);
+    float step_sin = sinf(2.0f * (float)M_PI / segments);
+    float c = 1.0f, s = 0.0f;
+    for (int i = 0; i < segments; i++) {
+        for (int j = 0; j < nb_offsets; j++) {
+            float ex = rx + offsets[j];
+            float ey = ry + offsets[j];
+            if (ex < 0.0f) ex = 0.0f;
+            if (ey < 0.0f) ey = 0.0f;
+            _geometry_vertex(buffer, x + c * ex, y + s * ey, colors[j]);
+        }
+        float next_c = c * step_cos - s * step_sin;
+        s = s * step_cos + c * step_sin;
+        c = next_c;
+    }
+    for (int i = 0; i < segments; i++) {
+        int v = first + i * nb_offsets;
+        int w = first + ((i + 1) % segments) * nb_offsets;
+        for (int j = 0; j < nb_offsets - 1; j++) {
+            _geometry_quad(buffer, v + j, v + j + 1, w + j + 1, w + j);
+        }
+    }
+}
+
+/**
+ * Tessellates a filled ellipse into a geometry buffer
+ * \param buffer The geometry buffer
+ * \param x,y The center of the ellipse
+ * \param rx,ry The radii of the ellipse
+ * \param color The color of the ellipse
+ * \param antialiasing True to feather the edge of the ellipse
+ */
+static void _tessellate_filled_ellipse(GeometryBuffer *buffer, float x, float y, float rx, float ry, Color color, bool antialiasing) {
+    int segments = _ellipse_segments(rx > ry ? rx : ry);
+    int rings = antialiasing ? 2 : 1;
+    _geometry_reserve(buffer, 1 + segments * rings, segments * (3 + (rings - 1) * 6));
+    int center = buffer->nb_vertices;
+    float inset = antialiasing ? 0.5f : 0.0f;
+    Color clear = color;
+    clear.a = 0;
+
+    _geometry_vertex(buffer, x, y, color);
+    float step_cos = cosf(2.0f * (float)M_PI / segments);
+    float step_sin = sinf(2.0f * (float)M_PI / segments);
+    float c = 1.0f, s = 0.0f;
+    for (int i = 0; i < segments; i++) {
+        float ex = rx > inset ? rx - inset : 0.0f;
+        float ey = ry > inset ? ry - inset : 0.0f;
+        _geometry_vertex(buffer, x + c * ex, y + s * ey, color);
+        if (antialiasing) _geometry_vertex(buffer, x + c * (rx + 0.5f), y + s * (ry + 0.5f), clear);
+        float next_c = c * step_cos - s * step_sin;
+        s = s * step_cos + c * step_sin;
+        c = next_c;
+    }
+    for (int i = 0; i < segments; i++) {
+        int v = center + 1 + i * rings;
+        int w = center + 1 + ((i + 1) % segments) * rings;
+        buffer->indices[buffer->nb_indices++] = center;
+        buffer->indices[buffer->nb_indices++] = v;
+        buffer->indices[buffer->nb_indices++] = w;
+        if (antialiasing) _geometry_quad(buffer, v, v + 1, w + 1, w);
+    }
+}
+
+/**
+ * Builds the fill rectangles of a rectangle outline
+ * \param rects The rectangles to fill, must hold 4 rectangles
+ * \param x1,y1 The top-left pixel of the rectangle
+ * \param x2,y2 The bottom-right pixel of the rectangle
+ * \param thickness The thickness of the outline, drawn inside the rectangle
+ * \return The number of rectangles, 1 when the outline covers the whole rectangle
+ */
+static int _rect_outline_rects(SDL_Rect *rects, int x1, int y1, int x2, int y2, int thickness) {
+    if (x1 > x2) { int tmp = x1; x1 = x2; x2 = tmp; }
+    if (y1 > y2) { int tmp = y1; y1 = y2; y2 = tmp; }
+    int w = x2 - x1 + 1, h = y2 - y1 + 1;
+    if (thickness < 1) thickness = 1;
+    if (thickness * 2 >= w || thickness * 2 >= h) {
+        rects[0] = (SDL_Rect){x1, y1, w, h};
+        return 1;
+    }
+    rects[0] = (SDL_Rect){x1, y1, w, thickness};
+    rects[1] = (SDL_Rect){x1, y2 - thickness + 1, w, thickness};
+    rects[2] = (SDL_Rect){x1, y1 + thickness, thickness, h - thickness * 2};
+    rects[3] = (SDL_Rect){x2 - thickness + 1, y1 + thickness, thickness, h - thickness * 2};
+    return 4;
+}
+
+/**
+ * Builds the fill rectangles of a box with rounded corners
+ * \param rects The rectangles to fill, must hold `2 * radius + 1` rectangles
+ * \param x1,y1 The top-left pixel of the box
+ * \param x2,y2 The bottom-right pixel of the box
+ * \param radius The radius of the corners, clamped to half the size of the box
+ * \return The number of rectangles
+ * \note Rows of the corners with the same inset are merged into a single rectangle
+ */
+static int _rounded_box_rects(SDL_Rect *rects, int x1, int y1, int x2, int y2, int radius) {
+    if (x1 > x2) { int tmp = x1; x1 = x2; x2 = tmp; }
+    if (y1 > y2) { int tmp = y1; y1 = y2; y2 = tmp; }
+    int w = x2 - x1 + 1, h = y2 - y1 + 1;
+    if (radius > w / 2) radius = w / 2;
+    if (radius > h / 2) radius = h / 2;
+    if (radius < 0) radius = 0;
+
+    int count = 0;
+    int start = 0;
+    int inset = -1;
+    for (int row = 0; row <= radius; row++) {
+        int row_inset = 0;
+        if (row < radius) {
+            // Distance from the center of the corner to the center of the row
+            float dy = radius - row - 0.5f;
+            row_inset = radius - (int)(sqrtf((float)radius * radius - dy * dy) + 0.5f);
+        }
+        if (row == radius || (row > 0 && row_inset != inset)) {
+            if (row > start) {
+                int span = row - start;
+                rects[count++] = (SDL_Rect){x1 + inset, y1 + start, w - inset * 2, span};
+                rects[count++] = (SDL_Rect){x1 + inset, y2 - row + 1, w - inset * 2, span};
+            }
+            start = row;
+        }
+        inset = row_inset;
+    }
+    if (h > radius * 2) {
+        rects[count++] = (SDL_Rect){x1, y1 + radius, w, h - radius * 2};
+    }
+    return count;
+}
+
+/**
+ * Clamps a thickness to the range accepted by the surface primitives
+ * \param thickness The thickness
+ * \return The thickness, between 1 and 255
+ */
+static Uint8 _surface_thickness(int thickness) {
+    if (thickness < 1) return 1;
+    if (thickness > 255) return 255;
+    return (Uint8)thickness;
+}
+
+/**
+ * Draws a line on the render surface
+ * \param x1,y1 The first point of the line
+ * \param x2,y2 The second point of the line
+ * \param thickness The thickness of the line
+ * \param color The color of the line
+ */
+static void _surface_line(int x1, int y1, int x2, int y2, int thickness, Color color) {
+    if (_antialiasing) {
+        surfaceAAThickLineRGBA(_render_surface, x1, y1, x2, y2, _surface_thickness(thickness), color.r, color.g, color.b, color.a);
+    } else {
+        surfaceThickLineRGBA(_render_surface, x1, y1, x2, y2, _surface_thickness(thickness), color.r, color.g, color.b, color.a);
+    }
+}
+
+/**
+ * Draws an ellipse on the render surface
+ * \param x,y The center of the ellipse
+ * \param rx,ry The radii of the ellipse
+ * \param thickness The thickness of the outline, centered on the radii, or 0 to fill the ellipse
+ * \param color The color of the ellipse
+ */
+static void _surface_ellipse(int x, int y, int rx, int ry, int thickness, Color color) {
+    if (thickness <= 0) {
+        if (_antialiasing) surfaceAAFilledEllipseRGBA(_render_surface, x, y, rx, ry, color.r, color.g, color.b, color.a);
+        else surfaceFilledEllipseRGBA(_render_surface, x, y, rx, ry, color.r, color.g, color.b, color.a);
+    } else if (_antialiasing) {
+        surfaceAAThickEllipseRGBA(_render_surface, x, y, rx, ry, color.r, color.g, color.b, color.a, _surface_thickness(thickness));
+    } else {
+        surfaceThickEllipseRGBA(_render_surface, x, y, rx, ry, color.r, color.g, color.b, color.a, _surface_thickness(thickness));
+    }
+}
+
+/**
+ * Fills rectangles with a single call
+ * \param rects The rectangles to fill
+ * \param count The number of rectangles
+ * \param color The color of the rectangles
+ */
+static void _fill_rects(const SDL_Rect *rects, int count, Color color) {
+    if (count <= 0) return;
+    if (_render_surface != NULL) {
+        for (int i = 0; i < count; i++) {
+            surfaceBoxRGBA(_render_surface, rects[i].x, rects[i].y, rects[i].x + rects[i].w - 1, rects[i].y + rects[i].h - 1, color.r, color.g, color.b, color.a);
+        }
+        return;
+    }
+    flush_geometry();
+    SDL_SetRenderDrawBlendMode(_engine->renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(_engine->renderer, color.r, color.g, color.b, color.a);
+    SDL_RenderFillRects(_engine->renderer, rects, count);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+}
+
+/**
+ * Checks that shapes can be drawn, on the render surface or with the renderer
+ * \note Shapes drawn on a render surface do not need a window
+ */
+static void _assert_render_target() {
+    if (_render_surface == NULL) _assert_engine_init();
+}
+
+/**
+ * Allocates scratch memory to draw a shape
+ * \param size The size to allocate
+ * \return The memory, from the frame arena with a window or from the heap without one, to release with `_shape_free`
+ */
+static void *_shape_alloc(size_t size) {
+    if (_engine != NULL) return engine_frame_alloc(size);
+    void *ptr = malloc(size);
+    if (ptr == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for shape\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+/**
+ * Releases scratch memory of `_shape_alloc`
+ * \param ptr The memory
+ */
+static void _shape_free(void *ptr) {
+    if (_engine == NULL) free(ptr);
+}
+
+/**
+ * Draws the batched geometry
+ * \note Lines, rectangles, circles and ellipses are batched and drawn together with a single call.
+ * \note The engine flushes the batch before drawing anything else and at the end of every frame, call this function only before drawing directly with SDL
+ */
+void flush_geometry() {
+    _assert_engine_init();
+    if (_geometry_batch.nb_indices == 0) return;
+    // Untextured geometry uses the draw blend mode, which the SDL2_gfx functions leave to none for opaque colors
+    SDL_SetRenderDrawBlendMode(_engine->renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(_engine->renderer, NULL, _geometry_batch.vertices, _geometry_batch.nb_vertices, _geometry_batch.indices, _geometry_batch.nb_indices);
+    _geometry_batch.nb_vertices = 0;
+    _geometry_batch.nb_indices = 0;
+}
+
+/**
+ * Draws a line
+ * \param x1 The x position of the first point
+ * \param y1 The y position of the first point
+ * \param x2 The x position of the second point
+ * \param y2 The y position of the second point
+ * \param color The color of the line
+ */
+void draw_line(int x1, int y1, int x2, int y2, Color color) {
+    _assert_render_target();
+    if (_render_surface != NULL) {
+        _surface_line(x1, y1, x2, y2, 1, color);
+        return;
+    }
+    _tessellate_line(&_geometry_batch, x1 + 0.5f, y1 + 0.5f, x2 + 0.5f, y2 + 0.5f, 1.0f, color, true, _antialiasing);
+}
+
+/**
+ * Draws a rectangle
+ * \param x1 The x position of the point at the top-left corner of the rectangle
+ * \param y1 The y position of the point at the top-left corner of the rectangle
+ * \param x2 The x position of the point at the bottom-right corner of the rectangle
+ * \param y2 The y position of the point at the bottom-right corner of the rectangle
+ * \param color The color of the rectangle
+ */
+void draw_rect(int x1, int y1, int x2, int y2, Color color) {
+    _assert_render_target();
+    if (_render_surface != NULL) {
+        surfaceRectangleRGBA(_render_surface, x1, y1, x2, y2, color.r, color.g, color.b, color.a);
+        return;
+    }
+    _tessellate_rect(&_geometry_batch, x1, y1, x2, y2, 1, color);
+}
+
+/**
+ * Draws an ellipse
+ * \param x The x position of the ellipse
+ * \param y The y position of the ellipse
+ * \param rx The x radius of the ellipse
+ * \param ry The y radius of the ellipse
+ * \param color The color of the ellipse
+ */
+void draw_ellipse(int x, int y, int rx, int ry, Color color) {
+    _assert_render_target();
+    if (_render_surface != NULL) {
+        _surface_ellipse(x, y, rx, ry, 1, color);
+        return;
+    }
+    _tessellate_ellipse(&_geometry_batch, x + 0.5f, y + 0.5f, rx, ry, 1.0f, color, _antialiasing);
+}
+
+/**
+ * Draws a circle
+ * \param x The x position of the circle
+ * \param y The y position of the circle
+ * \param radius The radius of the circle
+ * \param color The color of the circle
+ */
+void draw_circle(int x, int y, int radius, Color color) {
+    _assert_render_target();
+    if (_render_surface != NULL) {
+        _surface_ellipse(x, y, radius, radius, 1, color);
+        return;
+    }
+    _tessellate_ellipse(&_geometry_batch, x + 0.5f, y + 0.5f, radius, radius, 1.0f, color, _antialiasing);
+}
+
+/**
+ * Draws a line with a specified thickness
+ * \param x1 The x position of the first point
+ * \param y1 The y position of the first point
+ * \param x2 The x position of the second point
+ * \param y2 The y position of the second point
+ * \param color The color of the line
+ * \param thickness The thickness of the line
+ */
+void draw_line_thick(int x1, int y1, int x2, int y2, Color color, int thickness) {
+    _assert_render_target();
+    if (_render_surface != NULL) {
+        _surface_line(x1, y1, x2, y2, thickness, color);
+        return;
+    }
+    _tessellate_line(&_geometry_batch, x1 + 0.5f, y1 + 0.5f, x2 + 0.5f, y2 + 0.5f, thickness, color, thickness <= 1, _antialiasing);
+}
+
+/**
+ * Draws a rectangle with a specified thickness
+ * \param x1 The x position of the point at the top-left corner of the rectangle
+ * \param y1 The y position of the point at the top-left corner of the rectangle
+ * \param x2 The x position of the point at the bottom-right corner of the rectangle
+ * \param y2 The y position of the point at the bottom-right corner of the rectangle
+ * \param color The color of the rectangle
+ * \param thickness The thickness of the rectangle
+ */
+void draw_rect_thick(int x1, int y1, int x2, int y2, Color color, int thickness) {
+    _assert_render_target();
+    if (_render_surface != NULL) {
+        SDL_Rect rects[4];
+        _fill_rects(rects, _rect_outline_rects(rects, x1, y1, x2, y2, thickness), color);
+        return;
+    }
+    _tessellate_rect(&_geometry_batch, x1, y1, x2, y2, thickness, color);
+}
+
+/**
+ * Draws a circle with a specified thickness
+ * \param x The x position of the circle
+ * \param y The y position of the circle
+ * \param radius The radius of the circle
+ * \param color The color of the circle
+ * \param thickness The thickness of the circle
+ */
+void draw_circle_thick(int x, int y, int radius, Color color, int thickness) {
+    _assert_render_target();
+    if (_render_surface != NULL) {
+        _surface_ellipse(x, y, radius, radius, thickness, color);
+        return;
+    }
+    _tessellate_ellipse(&_geometry_batch, x + 0.5f, y + 0.5f, radius, radius, thickness, color, _antialiasing);
+}
+
+/**
+ * Draws an ellipse with a specified thickness
+ * \param x The x position of the ellipse
+ * \param y The y position of the ellipse
+ * \param rx The x radius of the ellipse
+ * \param ry The y radius of the ellipse
+ * \param color The color of the ellipse
+ * \param thickness The thickness of the ellipse
+ */
+void draw_ellipse_thick(int x, int y, int rx, int ry, Color color, int thickness) {
+    _assert_render_target();
+    if (_render_surface != NULL) {
+        _surface_ellipse(x, y, rx, ry, thickness, color);
+        return;
+    }
+    _tessellate_ellipse(&_geometry_batch, x + 0.5f, y + 0.5f, rx, ry, thickness, color, _antialiasing);
+}
+
+/**
+ * Draws a bezier curve
+ * \param points The control points of the curve
+ * \param count The number of control points, at least 3
+ * \param color The color of the curve
+ * \param thickness The thickness of the curve
+ * \note The number of segments follows the curvature, the curve is never more than a quarter of a pixel away from the drawn segments
+ * \note The segments are drawn as one joined strip, a translucent curve is blended once
+ */
+void draw_bezier(Point *points, int count, Color color, int thickness) {
+    _assert_render_target();
+    if (count < 3) {
+        fprintf(stderr, "[ENGINE] A bezier curve needs at least 3 control points\n");
+        exit(1);
+    }
+    Sint16 *vx = (Sint16 *)_shape_alloc(sizeof(Sint16) * count * 2);
+    Sint16 *vy = vx + count;
+    for (int i = 0; i < count; i++) {
+        vx[i] = (Sint16)points[i].x;
+        vy[i] = (Sint16)points[i].y;
+    }
+
+    int capacity = 256;
+    SDL_FPoint *path = (SDL_FPoint *)_shape_alloc(sizeof(SDL_FPoint) * capacity);
+    int nb_points = bezierFlatten(vx, vy, count, 0.25, path, capacity);
+    if (nb_points > capacity) {
+        _shape_free(path);
+        path = (SDL_FPoint *)_shape_alloc(sizeof(SDL_FPoint) * nb_points);
+        bezierFlatten(vx, vy, count, 0.25, path, nb_points);
+    }
+    _shape_free(vx);
+
+    if (_render_surface != NULL) {
+        for (int i = 0; i + 1 < nb_points; i++) {
+            _surface_line((int)lroundf(path[i].x), (int)lroundf(path[i].y), (int)lroundf(path[i + 1].x), (int)lroundf(path[i + 1].y), thickness, color);
+        }
+        _shape_free(path);
+        return;
+    }
+    for (int i = 0; i < nb_points; i++) {
+        path[i].x += 0.5f;
+        path[i].y += 0.5f;
+    }
+    _tessellate_polyline(&_geometry_batch, path, nb_points, thickness, color, _antialiasing);
+}
+
+/**
+ * Draws a filled circle
+ * \param x The x position of the circle
+ * \param y The y position of the circle
+ * \param radius The radius of the circle
+ * \param color The color of the circle
+ */
+void draw_filled_circle(int x, int y, int radius, Color color) {
+    draw_filled_ellipse(x, y, radius, radius, color);
+}
+
+/**
+ * Draws a filled ellipse
+ * \param x The x position of the ellipse
+ * \param y The y position of the ellipse
+ * \param rx The x radius of the ellipse
+ * \param ry The y radius of the ellipse
+ * \param color The color of the ellipse
+ * \note With antialiasing, the edge is smoothed with vertex colors, or with the exact coverage of each pixel on a render surface
+ */
+void draw_filled_ellipse(int x, int y, int rx, int ry, Color color) {
+    _assert_render_target();
+    if (_render_surface != NULL) {
+        _surface_ellipse(x, y, rx, ry, 0, color);
+        return;
+    }
+    _tessellate_filled_ellipse(&_geometry_batch, x + 0.5f, y + 0.5f, rx + 0.5f, ry + 0.5f, color, _antialiasing);
+}
+
+/**
+ * Draws a filled rectangle
+ * \param x1 The x position of the point at the top-left corner of the rectangle
+ * \param y1 The y position of the point at the top-left corner of the rectangle
+ * \param x2 The x position of the point at the bottom-right corner of the rectangle
+ * \param y2 The y position of the point at the bottom-right corner of the rectangle
+ * \param color The color of the rectangle
+ */
+void draw_filled_rect(int x1, int y1, int x2, int y2, Color color) {
+    _assert_render_target();
+    if (x1 > x2) { int tmp = x1; x1 = x2; x2 = tmp; }
+    if (y1 > y2) { int tmp = y1; y1 = y2; y2 = tmp; }
+    SDL_Rect rect = {x1, y1, x2 - x1 + 1, y2 - y1 + 1};
+    _fill_rects(&rect, 1, color);
+}
+
+/**
+ * Draws several filled rectangles with a single call
+ * \param rects The rectangles to draw
+ * \param count The number of rectangles
+ * \param color The color of the rectangles
+ */
+void draw_filled_rects(Rect *rects, int count, Color color) {
+    _assert_render_target();
+    _fill_rects(rects, count, color);
+}
+
+/**
+ * Draws a filled box with rounded corners
+ * \param x1 The x position of the point at the top-left corner of the box
+ * \param y1 The y position of the point at the top-left corner of the box
+ * \param x2 The x position of the point at the bottom-right corner of the box
+ * \param y2 The y position of the point at the bottom-right corner of the box
+ * \param radius The radius of the corners
+ * \param color The color of the box
+ */
+void draw_rounded_box(int x1, int y1, int x2, int y2, int radius, Color color) {
+    _assert_render_target();
+    if (radius < 0) radius = 0;
+    SDL_Rect *rects = (SDL_Rect *)_shape_alloc(sizeof(SDL_Rect) * (radius * 2 + 1));
+    int count = _rounded_box_rects(rects, x1, y1, x2, y2, radius);
+    _fill_rects(rects, count, color);
+    _shape_free(rects);
+}
+
+/**
+ * Creates an empty mesh
+ * \return The mesh
+ * \note Shapes added to a mesh are tessellated once, drawing the mesh only copies its vertices into the geometry batch
+ */
+Mesh *create_mesh() {
+    Mesh *mesh = (Mesh *)malloc(sizeof(Mesh));
+    if (mesh == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for mesh\n");
+        exit(1);
+    }
+    mesh->geometry = (GeometryBuffer){NULL, 0, 0, NULL, 0, 0};
+    return mesh;
+}
+
+/**
+ * Adds a line to a mesh
+ * \param mesh The mesh
+ * \param x1 The x position of the first point
+ * \param y1 The y position of the first point
+ * \param x2 The x position of the second point
+ * \param y2 The y position of the second point
+ * \param color The color of the line
+ * \param thickness The thickness of the line
+ * \note The current antialiasing setting is baked into the mesh
+ */
+void mesh_add_line(Mesh *mesh, int x1, int y1, int x2, int y2, Color color, int thickness) {
+    _tessellate_line(&mesh->geometry, x1 + 0.5f, y1 + 0.5f, x2 + 0.5f, y2 + 0.5f, thickness, color, thickness <= 1, _antialiasing);
+}
+
+/**
+ * Adds a rectangle to a mesh
+ * \param mesh The mesh
+ * \param x1 The x position of the point at the top-left corner of the rectangle
+ * \param y1 The y position of the point at the top-left corner of the rectangle
+ * \param x2 The x position of the point at the bottom-right corner of the rectangle
+ * \param y2 The y position of the point at the bottom-right corner of the rectangle
+ * \param color The color of the rectangle
+ * \param thickness The thickness of the rectangle
+ */
+void mesh_add_rect(Mesh *mesh, int x1, int y1, int x2, int y2, Color color, int thickness) {
+    _tessellate_rect(&mesh->geometry, x1, y1, x2, y2, thickness, color);
+}
+
+/**
+ * Adds a circle to a mesh
+ * \param mesh The mesh
+ * \param x The x position of the circle
+ * \param y The y position of the circle
+ * \param radius The radius of the circle
+ * \param color The color of the circle
+ * \param thickness The thickness of the circle
+ * \note The current antialiasing setting is baked into the mesh
+ */
+void mesh_add_circle(Mesh *mesh, int x, int y, int radius, Color color, int thickness) {
+    _tessellate_ellipse(&mesh->geometry, x + 0.5f, y + 0.5f, radius, radius, thickness, color, _antialiasing);
+}
+
+/**
+ * Adds an ellipse to a mesh
+ * \param mesh The mesh
+ * \param x The x position of the ellipse
+ * \param y The y position of the ellipse
+ * \param rx The x radius of the ellipse
+ * \param ry The y radius of the ellipse
+ * \param color The color of the ellipse
+ * \param thickness The thickness of the ellipse
+ * \note The current antialiasing setting is baked into the mesh
+ */
+void mesh_add_ellipse(Mesh *mesh, int x, int y, int rx, int ry, Color color, int thickness) {
+    _tessellate_ellipse(&mesh->geometry, x + 0.5f, y + 0.5f, rx, ry, thickness, color, _antialiasing);
+}
+
+/**
+ * Draws a mesh
+ * \param mesh The mesh to draw
+ * \param x The x position of the origin of the mesh
+ * \param y The y position of the origin of the mesh
+ */
+void draw_mesh(Mesh *mesh, int x, int y) {
+    draw_mesh_ex(mesh, x, y, 1.0, 0.0);
+}
+
+/**
+ * Draws a mesh with a transform
+ * \param mesh The mesh to draw
+ * \param x The x position of the origin of the mesh
+ * \param y The y position of the origin of the mesh
+ * \param scale The scale of the mesh
+ * \param angle The rotation of the mesh around its origin, in degrees clockwise
+ * \note The mesh is added to the geometry batch, it is drawn in the same call as the other batched shapes
+ */
+void draw_mesh_ex(Mesh *mesh, int x, int y, double scale, double angle) {
+    _assert_engine_init();
+    GeometryBuffer *geometry = &mesh->geometry;
+    _geometry_reserve(&_geometry_batch, geometry->nb_vertices, geometry->nb_indices);
+
+    float radians = (float)(angle * M_PI / 180.0);
+    float a = (float)scale * cosf(radians);
+    float b = (float)scale * sinf(radians);
+    SDL_Vertex *dst = &_geometry_batch.vertices[_geometry_batch.nb_vertices];
+    for (int i = 0; i < geometry->nb_vertices; i++) {
+        SDL_Vertex vertex = geometry->vertices[i];
+        float vx = vertex.position.x;
+        float vy = vertex.position.y;
+        vertex.position.x = x + a * vx - b * vy;
+        vertex.position.y = y + b * vx + a * vy;
+        dst[i] = vertex;
+    }
+
+    int base = _geometry_batch.nb_vertices;
+    int *index = &_geometry_batch.indices[_geometry_batch.nb_indices];
+    for (int i = 0; i < geometry->nb_indices; i++) {
+        index[i] = geometry->indices[i] + base;
+    }
+
+    _geometry_batch.nb_vertices += geometry->nb_vertices;
+    _geometry_batch.nb_indices += geometry->nb_indices;
+}
+
+/**
+ * Destroys a mesh
+ * \param mesh The mesh to destroy
+ */
+void destroy_mesh(Mesh *mesh) {
+    free(mesh->geometry.vertices);
+    free(mesh->geometry.indices);
+    free(mesh);
+}
+
+/**
+ * Draws geometry from a texture
+ * \param texture The texture to draw
+ * \param x The x position to draw the texture
+ * \param y The y position to draw the texture
+ */
+void draw_geometry(Texture *texture, int x, int y) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Rect rect = {x, y, _engine->width, _engine->height};
+    SDL_RenderCopy(_engine->renderer, texture, NULL, &rect);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+}
+
+/**
+ * Create a line as a texture
+ * \param name The name of the texture
+ * \param x1 The x position of the first point
+ * \param y1 The y position of the first point
+ * \param x2 The x position of the second point
+ * \param y2 The y position of the second point
+ * \param color The color of the line
+ * \return The texture
+ */
+Texture *create_line(char *name, int x1, int y1, int x2, int y2, Color color) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(_engine->renderer, texture);
+
+    lineRGBA(_engine->renderer, x1, y1, x2, y2, color.r, color.g, color.b, color.a);
+
+    SDL_SetRenderTarget(_engine->renderer, _active_layer == NULL ? NULL : _active_layer->texture);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+
+    _add_to_texture_list(texture, name);
+
+    return texture;
+}
+
+/**
+ * Create a rectangle as a texture
+ * \param name The name of the texture
+ * \param x1 The x position of the point at the top-left corner of the rectangle
+ * \param y1 The y position of the point at the top-left corner of the rectangle
+ * \param x2 The x position of the point at the bottom-right corner of the rectangle
+ * \param y2 The y position of the point at the bottom-right corner of the rectangle
+ * \param color The color of the rectangle
+ * \return The texture
+ */
+Texture *create_rect(char *name, int x1, int y1, int x2, int y2, Color color) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(_engine->renderer, texture);
+
+    SDL_Rect rects[4];
+    _fill_rects(rects, _rect_outline_rects(rects, x1, y1, x2, y2, 1), color);
+
+    SDL_SetRenderTarget(_engine->renderer, _active_layer == NULL ? NULL : _active_layer->texture);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+
+    _add_to_texture_list(texture, name);
+
+    return texture;
+}
+
+/**
+ * Create a circle as a texture
+ * \param name The name of the texture
+ * \param x The x position of the circle
+ * \param y The y position of the circle
+ * \param radius The radius of the circle
+ * \param color The color of the circle
+ * \return The texture
+ */
+Texture *create_circle(char *name, int x, int y, int radius, Color color) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(_engine->renderer, texture);
 
     circleRGBA(_engine->renderer, x, y, radius, color.r, color.g, color.b, color.a);
 
-    SDL_SetRenderTarget(_engine->renderer, NULL);
+    SDL_SetRenderTarget(_engine->renderer, _active_layer == NULL ? NULL : _active_layer->texture);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+
+    _add_to_texture_list(texture, name);
+
+    return texture;
+}
+
+/**
+ * Create an ellipse as a texture
+ * \param name The name of the texture
+ * \param x The x position of the ellipse
+ * \param y The y position of the ellipse
+ * \param rx The x radius of the ellipse
+ * \param ry The y radius of the ellipse
+ * \param color The color of the ellipse
+ * \return The texture
+ */
+Texture *create_ellipse(char *name, int x, int y, int rx, int ry, Color color) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(_engine->renderer, texture);
+
+    ellipseRGBA(_engine->renderer, x, y, rx, ry, color.r, color.g, color.b, color.a);
+
+    SDL_SetRenderTarget(_engine->renderer, _active_layer == NULL ? NULL : _active_layer->texture);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+
+    _add_to_texture_list(texture, name);
+
+    return texture;
+}
+
+/**
+ * Create a line with a specified thickness as a texture
+ * \param name The name of the texture
+ * \param x1 The x position of the first point
+ * \param y1 The y position of the first point
+ * \param x2 The x position of the second point
+ * \param y2 The y position of the second point
+ * \param color The color of the line
+ * \param thickness The thickness of the line
+ * \return The texture
+ */
+Texture *create_line_thick(char *name, int x1, int y1, int x2, int y2, Color color, int thickness) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(_engine->renderer, texture);
+
+    thickLineRGBA(_engine->renderer, x1, y1, x2, y2, thickness, color.r, color.g, color.b, color.a);
+
+    SDL_SetRenderTarget(_engine->renderer, _active_layer == NULL ? NULL : _active_layer->texture);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+
+    _add_to_texture_list(texture, name);
+
+    return texture;
+}
+
+/**
+ * Create a rectangle with a specified thickness as a texture
+ * \param name The name of the texture
+ * \param x1 The x position of the point at the top-left corner of the rectangle
+ * \param y1 The y position of the point at the top-left corner of the rectangle
+ * \param x2 The x position of the point at the bottom-right corner of the rectangle
+ * \param y2 The y position of the point at the bottom-right corner of the rectangle
+ * \param color The color of the rectangle
+ * \param thickness The thickness of the rectangle
+ * \return The texture
+ */
+Texture *create_rect_thick(char *name, int x1, int y1, int x2, int y2, Color color, int thickness) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(_engine->renderer, texture);
+
+    SDL_Rect rects[4];
+    _fill_rects(rects, _rect_outline_rects(rects, x1, y1, x2, y2, thickness), color);
+
+    SDL_SetRenderTarget(_engine->renderer, _active_layer == NULL ? NULL : _active_layer->texture);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+
+    _add_to_texture_list(texture, name);
+
+    return texture;
+}
+
+/**
+ * Create a circle with a specified thickness as a texture
+ * \param name The name of the texture
+ * \param x The x position of the circle
+ * \param y The y position of the circle
+ * \param radius The radius of the circle
+ * \param color The color of the circle
+ * \param thickness The thickness of the circle
+ * \return The texture
+ */
+Texture *create_circle_thick(char *name, int x, int y, int radius, Color color, int thickness) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(_engine->renderer, texture);
+
+    thickCircleRGBA(_engine->renderer, x, y, radius, color.r, color.g, color.b, color.a, thickness);
+
+    SDL_SetRenderTarget(_engine->renderer, _active_layer == NULL ? NULL : _active_layer->texture);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+
+    _add_to_texture_list(texture, name);
+
+    return texture;
+}
+
+/**
+ * Create an ellipse with a specified thickness as a texture
+ * \param name The name of the texture
+ * \param x The x position of the ellipse
+ * \param y The y position of the ellipse
+ * \param rx The x radius of the ellipse
+ * \param ry The y radius of the ellipse
+ * \param color The color of the ellipse
+ * \param thickness The thickness of the ellipse
+ * \return The texture
+ */
+Texture *create_ellipse_thick(char *name, int x, int y, int rx, int ry, Color color, int thickness) {
+    _assert_engine_init();
+    flush_geometry();
+    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(_engine->renderer, texture);
+
+    thickEllipseRGBA(_engine->renderer, x, y, rx, ry, color.r, color.g, color.b, color.a, thickness);
+
+    SDL_SetRenderTarget(_engine->renderer, _active_layer == NULL ? NULL : _active_layer->texture);
     SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
 
     _add_to_texture_list(texture, name);
@@ -1075,349 +3618,1158 @@ Texture *create_circle(char *name, int x, int y, int radius, Color color) {
     return texture;
 }
 
+/***********************************************
+ * Layer functions
+ ***********************************************/
+
+/**
+ * Finds a layer by name
+ * \param name The name of the layer
+ * \return The layer, NULL if it does not exist
+ */
+static Layer *_find_layer(const char *name) {
+    const char *key = _intern_find(name);
+    for (Layer *layer = _layers; layer != NULL; layer = layer->next) {
+        if (layer->name == key) return layer;
+    }
+    return NULL;
+}
+
+/**
+ * Gets a layer by name
+ * \param name The name of the layer
+ * \return The layer
+ */
+static Layer *_get_layer(const char *name) {
+    Layer *layer = _find_layer(name);
+    if (layer == NULL) {
+        fprintf(stderr, "[ENGINE] Layer not found: %s\n", name);
+        exit(1);
+    }
+    return layer;
+}
+
+/**
+ * Divides the colors of a layer by their alpha, for renderers without a premultiplied blend mode
+ * \param layer The layer, the current render target
+ * \note The layer is read back once each time it is drawn again
+ */
+static void _unpremultiply_layer(Layer *layer) {
+    Uint32 *pixels = (Uint32 *)malloc(sizeof(Uint32) * layer->width * layer->height);
+    if (pixels == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for layer\n");
+        exit(1);
+    }
+    int pitch = layer->width * sizeof(Uint32);
+    if (SDL_RenderReadPixels(_engine->renderer, NULL, SDL_PIXELFORMAT_RGBA8888, pixels, pitch) != 0) {
+        fprintf(stderr, "[ENGINE] Failed to read layer: %s\n", SDL_GetError());
+        exit(1);
+    }
+    for (int i = 0; i < layer->width * layer->height; i++) {
+        Uint32 a = pixels[i] & 0xFF;
+        if (a == 0 || a == 255) continue;
+        Uint32 r = ((pixels[i] >> 24) * 255 + a / 2) / a;
+        Uint32 g = ((pixels[i] >> 16 & 0xFF) * 255 + a / 2) / a;
+        Uint32 b = ((pixels[i] >> 8 & 0xFF) * 255 + a / 2) / a;
+        if (r > 255) r = 255;
+        if (g > 255) g = 255;
+        if (b > 255) b = 255;
+        pixels[i] = r << 24 | g << 16 | b << 8 | a;
+    }
+    SDL_UpdateTexture(layer->texture, NULL, pixels, pitch);
+    free(pixels);
+}
+
+/**
+ * Starts drawing into a layer, every draw call until `end_layer` is drawn into the layer instead of the window
+ * \param name The name of the layer, it is created on first use
+ * \param width The width of the layer
+ * \param height The height of the layer
+ * \return True if the layer must be drawn again, false if its content is still valid and `end_layer` must not be called
+ * \note The layer is cleared to transparent before drawing, a layer of a different size is created again
+ * \note The layer keeps premultiplied alpha, translucent content looks the same through the layer as drawn directly
+ * \note Layers cannot be nested
+ */
+bool begin_layer(char *name, int width, int height) {
+    _assert_engine_init();
+    if (_active_layer != NULL) {
+        fprintf(stderr, "[ENGINE] Layer already started: %s\n", _active_layer->name);
+        exit(1);
+    }
+
+    Layer *layer = _find_layer(name);
+    if (layer == NULL) {
+        layer = (Layer *)_pool_alloc(&_layer_pool);
+        layer->name = engine_intern(name);
+        layer->texture = NULL;
+        layer->valid = false;
+        layer->next = _layers;
+        _layers = layer;
+    }
+    if (layer->texture != NULL && (layer->width != width || layer->height != height)) {
+        SDL_DestroyTexture(layer->texture);
+        layer->texture = NULL;
+        layer->valid = false;
+    }
+    if (layer->valid) return false;
+
+    if (layer->texture == NULL) {
+        layer->texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (layer->texture == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to create layer: %s\n", SDL_GetError());
+            exit(1);
+        }
+        // Blending into a transparent target leaves colors multiplied by their alpha
+        SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        layer->premultiplied = SDL_SetTextureBlendMode(layer->texture, premultiplied) == 0;
+        if (!layer->premultiplied) SDL_SetTextureBlendMode(layer->texture, SDL_BLENDMODE_BLEND);
+        layer->width = width;
+        layer->height = height;
+    }
+
+    flush_geometry();
+    SDL_SetRenderTarget(_engine->renderer, layer->texture);
+    SDL_SetRenderDrawColor(_engine->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(_engine->renderer);
+    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+    _active_layer = layer;
+    return true;
+}
+
+/**
+ * Finishes drawing into the layer started with `begin_layer`, the next draw calls are drawn into the window
+ */
+void end_layer() {
+    _assert_engine_init();
+    if (_active_layer == NULL) {
+        fprintf(stderr, "[ENGINE] No layer started\n");
+        exit(1);
+    }
+    flush_geometry();
+    if (!_active_layer->premultiplied) _unpremultiply_layer(_active_layer);
+    SDL_SetRenderTarget(_engine->renderer, NULL);
+    _active_layer->valid = true;
+    _active_layer = NULL;
+}
+
+/**
+ * Draws a layer at its size
+ * \param name The name of the layer
+ * \param x The x position to draw the layer
+ * \param y The y position to draw the layer
+ */
+void draw_layer(char *name, int x, int y) {
+    _assert_engine_init();
+    Layer *layer = _get_layer(name);
+    if (layer == _active_layer) {
+        fprintf(stderr, "[ENGINE] Layer cannot be drawn into itself: %s\n", name);
+        exit(1);
+    }
+    if (layer->texture == NULL) return;
+    flush_geometry();
+    SDL_Rect rect = {x, y, layer->width, layer->height};
+    SDL_RenderCopy(_engine->renderer, layer->texture, NULL, &rect);
+}
+
+/**
+ * Invalidates a layer, the next `begin_layer` call returns true so it is drawn again
+ * \param name The name of the layer
+ */
+void invalidate_layer(char *name) {
+    _assert_engine_init();
+    _get_layer(name)->valid = false;
+}
+
+/**
+ * Invalidates all the layers
+ * \note Called by the engine when the renderer loses the content of its render targets
+ */
+void invalidate_all_layers() {
+    for (Layer *layer = _layers; layer != NULL; layer = layer->next) {
+        layer->valid = false;
+    }
+}
+
+/**
+ * Destroys a layer
+ * \param name The name of the layer
+ */
+void destroy_layer(char *name) {
+    _assert_engine_init();
+    const char *key = _intern_find(name);
+    Layer **link = &_layers;
+    while (*link != NULL && (*link)->name != key) link = &(*link)->next;
+    if (*link == NULL) {
+        fprintf(stderr, "[ENGINE] Layer not found: %s\n", name);
+        exit(1);
+    }
+    Layer *layer = *link;
+    if (layer == _active_layer) {
+        fprintf(stderr, "[ENGINE] Layer cannot be destroyed while it is drawn: %s\n", name);
+        exit(1);
+    }
+    *link = layer->next;
+    if (layer->texture != NULL) SDL_DestroyTexture(layer->texture);
+    _pool_free(&_layer_pool, layer);
+}
+
+/**
+ * Destroys all the layers
+ */
+void destroy_all_layers() {
+    _assert_engine_init();
+    if (_active_layer != NULL) {
+        fprintf(stderr, "[ENGINE] Layers cannot be destroyed while one is drawn: %s\n", _active_layer->name);
+        exit(1);
+    }
+    Layer *layer = _layers;
+    while (layer != NULL) {
+        Layer *next = layer->next;
+        if (layer->texture != NULL) SDL_DestroyTexture(layer->texture);
+        _pool_free(&_layer_pool, layer);
+        layer = next;
+    }
+    _layers = NULL;
+}
+
+/***********************************************
+ * Utility functions
+ ************************************************/
+
+/**
+ * Sets the color of the renderer
+ * \param color The color to set
+ */
+void set_color(Color color) {
+    _assert_engine_init();
+    _color = color;
+    SDL_SetRenderDrawColor(_engine->renderer, color.r, color.g, color.b, color.a);
+}
+
+/**
+ * Change the background color
+ * \param color The color to set
+ */
+void set_background_color(Color color) {
+    _assert_engine_init();
+    _clear_color = color;
+}
+
+/**
+ * Enables or disables antialiasing of lines, circles and ellipses
+ * \param antialiasing True to feather the edges of the shapes over one pixel, false otherwise
+ */
+void set_antialiasing(bool antialiasing) {
+    _antialiasing = antialiasing;
+}
+
+/**
+ * Sets the surface the shapes are drawn on
+ * \param surface A 32 bits surface to draw lines, rectangles, circles and ellipses on in software, or NULL to draw them with the renderer
+ * \note With antialiasing, shapes drawn on a surface are filled with the exact coverage of each pixel
+ * \note The surface is not freed by the engine
+ * \note The engine does not need to be initialized to draw shapes on a surface, without a window the shapes need a render surface
+ */
+void set_render_surface(SDL_Surface *surface) {
+    if (surface != NULL && surface->format->BytesPerPixel != 4) {
+        fprintf(stderr, "[ENGINE] Render surface must have 32 bits per pixel\n");
+        exit(1);
+    }
+    if (_engine != NULL) flush_geometry();
+    _render_surface = surface;
+}
+
+/**
+ * Enables or disables the mip chains of the textures and tilemaps loaded afterwards
+ * \param mipmaps True to generate a mip chain when loading, false otherwise
+ * \note Mip chains use a third more texture memory, draw calls smaller than the texture sample a smaller level
+ */
+void set_mipmaps(bool mipmaps) {
+    _mipmaps = mipmaps;
+}
+
+/**
+ * Delay the program
+ * \param ms The time to delay in milliseconds
+ */
+void delay(int ms) {
+    SDL_Delay(ms);
+}
+
+/***********************************************
+ * Event functions
+ ***********************************************/
+
+/**
+ * Get the mouse position
+ * \param x The variable to store the x position of the mouse
+ * \param y The variable to store the y position of the mouse
+ */
+void get_mouse_position(int *x, int *y) {
+    _assert_engine_init();
+    SDL_GetMouseState(x, y);
+}
+
+/**
+ * Checks if any key is pressed
+ * \return True if any key is pressed, false otherwise
+ */
+bool any_key_pressed() {
+    _assert_engine_init();
+    return _event.type == SDL_KEYDOWN;
+}
+
+/**
+ * Checks if an object is hovered
+ * \param object The object to check
+ * \return True if the object is hovered, false otherwise
+ */
+bool object_is_hovered(Object *object) {
+    _assert_engine_init();
+    int mouseX, mouseY;
+    SDL_GetMouseState(&mouseX, &mouseY);
+
+    return mouseX >= object->x && mouseX <= object->x + object->width && mouseY >= object->y && mouseY <= object->y + object->height;
+}
+
+/**
+ * Checks if an object is hovered by name
+ * \param name The name of the object to check
+ * \return True if the object is hovered, false otherwise (or if the object does not exist)
+ */
+bool object_is_hovered_by_name(char *name) {
+    _assert_engine_init();
+    const char *key = _intern_find(name);
+    ObjectList *current = _object_list;
+    while (current != NULL) {
+        if (current->name == key) {
+            return object_is_hovered(current->object);
+        }
+        current = current->next;
+    }
+    return false;
+}
+
+/**
+ * Records the mouse buttons and wheel of an event in the input snapshot
+ * \param event The event
+ */
+static void _input_handle_event(const SDL_Event *event) {
+    switch (event->type) {
+        case SDL_MOUSEBUTTONDOWN:
+            _input.pressed |= SDL_BUTTON(event->button.button);
+            break;
+        case SDL_MOUSEBUTTONUP:
+            _input.released |= SDL_BUTTON(event->button.button);
+            break;
+        case SDL_MOUSEWHEEL:
+            _input.wheel += event->wheel.y;
+            break;
+    }
+}
+
 /**
- * Create an ellipse as a texture
- * \param name The name of the texture
- * \param x The x position of the ellipse
- * \param y The y position of the ellipse
- * \param rx The x radius of the ellipse
- * \param ry The y radius of the ellipse
- * \param color The color of the ellipse
- * \return The texture
+ * Gets the input snapshot of the current frame
+ * \return The input snapshot, updated by `engine_run` after the events of each frame are handled
+ * \note Buttons pressed and released between two frames are reported in both `pressed` and `released`
  */
-Texture *create_ellipse(char *name, int x, int y, int rx, int ry, Color color) {
+const Input *get_input() {
     _assert_engine_init();
-    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderTarget(_engine->renderer, texture);
+    return &_input;
+}
 
-    ellipseRGBA(_engine->renderer, x, y, rx, ry, color.r, color.g, color.b, color.a);
+/***********************************************
+ * Text functions
+ ***********************************************/
 
-    SDL_SetRenderTarget(_engine->renderer, NULL);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+/**
+ * Gets the font face of a font file, reading the file on first use
+ * \param filename The path to the font file
+ * \param size The size the face is opened at
+ * \return The font face, its reference count is incremented
+ */
+static FontFace *_acquire_font_face(const char *filename, int size) {
+    const char *path = engine_intern(filename);
+    for (FontFace *face = _font_faces; face != NULL; face = face->next) {
+        if (face->path == path) {
+            face->refcount++;
+            return face;
+        }
+    }
 
-    _add_to_texture_list(texture, name);
+    FontFace *face = (FontFace *)malloc(sizeof(FontFace));
+    if (face == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for font face\n");
+        exit(1);
+    }
+    face->data = SDL_LoadFile(filename, &face->data_size);
+    if (face->data == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to load font: %s\n", SDL_GetError());
+        exit(1);
+    }
+    face->font = TTF_OpenFontRW(SDL_RWFromConstMem(face->data, (int)face->data_size), 1, size);
+    if (face->font == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to load font: %s\n", TTF_GetError());
+        exit(1);
+    }
+    face->path = path;
+    face->current_size = size;
+    face->refcount = 1;
+    face->next = _font_faces;
+    _font_faces = face;
+    return face;
+}
 
-    return texture;
+/**
+ * Releases a font face, it is closed when no font uses it anymore
+ * \param face The font face
+ * \note The glyphs of a closed face are removed by clearing the glyph atlas
+ */
+static void _release_font_face(FontFace *face) {
+    if (--face->refcount > 0) return;
+    FontFace **link = &_font_faces;
+    while (*link != face) link = &(*link)->next;
+    *link = face->next;
+    TTF_CloseFont(face->font);
+    SDL_free(face->data);
+    free(face);
+    _glyph_atlas_clear();
 }
 
 /**
- * Create a line with a specified thickness as a texture
- * \param name The name of the texture
- * \param x1 The x position of the first point
- * \param y1 The y position of the first point
- * \param x2 The x position of the second point
- * \param y2 The y position of the second point
- * \param color The color of the line
- * \param thickness The thickness of the line
- * \return The texture
+ * Gets the font of a face set to the size of a font
+ * \param font The font
+ * \return The font of its face, at its size
+ * \note Changing the size flushes the glyph cache of SDL_ttf, it only happens when glyphs or layouts are missing from the engine caches
  */
-Texture *create_line_thick(char *name, int x1, int y1, int x2, int y2, Color color, int thickness) {
+static TTF_Font *_font_at_size(Font *font) {
+    FontFace *face = font->face;
+    if (face->current_size != font->size) {
+        if (TTF_SetFontSize(face->font, font->size) != 0) {
+            fprintf(stderr, "[ENGINE] Failed to set font size: %s\n", TTF_GetError());
+            exit(1);
+        }
+        face->current_size = font->size;
+    }
+    return face->font;
+}
+
+/**
+ * Loads a font
+ * \param filename The path to the font
+ * \param size The size of the font
+ * \param name The name of the font
+ * \note The font file is read once, fonts loaded from the same file share its face and their glyphs are cached in a common atlas
+ */
+void load_font(char *filename, int size, char *name) {
     _assert_engine_init();
-    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderTarget(_engine->renderer, texture);
+    FontFace *face = _acquire_font_face(filename, size);
 
-    thickLineRGBA(_engine->renderer, x1, y1, x2, y2, thickness, color.r, color.g, color.b, color.a);
+    Font *font_struct = (Font *)_pool_alloc(&_font_pool);
 
-    SDL_SetRenderTarget(_engine->renderer, NULL);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+    font_struct->name = engine_intern(name);
+    font_struct->face = face;
+    font_struct->size = size;
+    font_struct->quality = TEXT_SOLID;
+    font_struct->next = NULL;
 
-    _add_to_texture_list(texture, name);
+    if (_font == NULL) {
+        _font = font_struct;
+    } else {
+        Font *current = _font;
+        while (current->next != NULL) {
+            current = current->next;
+        }
+        current->next = font_struct;
+    }
+}
 
-    return texture;
+static Font *_get_font(char *font_name) {
+    const char *key = _intern_find(font_name);
+    Font *current = _font;
+    while (current != NULL) {
+        if (current->name == key) {
+            return current;
+        }
+        current = current->next;
+    }
+    fprintf(stderr, "[ENGINE] Font not found: %s\n", font_name);
+    exit(1);
 }
 
 /**
- * Create a rectangle with a specified thickness as a texture
- * \param name The name of the texture
- * \param x1 The x position of the point at the top-left corner of the rectangle
- * \param y1 The y position of the point at the top-left corner of the rectangle
- * \param x2 The x position of the point at the bottom-right corner of the rectangle
- * \param y2 The y position of the point at the bottom-right corner of the rectangle
- * \param color The color of the rectangle
- * \param thickness The thickness of the rectangle
- * \return The texture
+ * Places a rectangle relative to an anchor point
+ * \param x The x position of the anchor
+ * \param y The y position of the anchor
+ * \param width The width of the rectangle
+ * \param height The height of the rectangle
+ * \param anchor The point of the rectangle placed at the anchor
+ * \return The rectangle
  */
-Texture *create_rect_thick(char *name, int x1, int y1, int x2, int y2, Color color, int thickness) {
-    _assert_engine_init();
-    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderTarget(_engine->renderer, texture);
+static SDL_Rect _anchor_rect(int x, int y, int width, int height, Anchor anchor) {
+    SDL_Rect rect = {x, y, width, height};
+    switch (anchor) {
+        case TOP_LEFT:
+            break;
+        case TOP:
+            rect.x -= width / 2;
+            break;
+        case TOP_RIGHT:
+            rect.x -= width;
+            break;
+        case LEFT:
+            rect.y -= height / 2;
+            break;
+        case CENTER:
+            rect.x -= width / 2;
+            rect.y -= height / 2;
+            break;
+        case RIGHT:
+            rect.x -= width;
+            rect.y -= height / 2;
+            break;
+        case BOTTOM_LEFT:
+            rect.y -= height;
+            break;
+        case BOTTOM:
+            rect.x -= width / 2;
+            rect.y -= height;
+            break;
+        case BOTTOM_RIGHT:
+            rect.x -= width;
+            rect.y -= height;
+            break;
+    }
+    return rect;
+}
+
+/**
+ * Decodes the next codepoint of a UTF-8 string
+ * \param text The string, advanced past the codepoint
+ * \return The codepoint, U+FFFD for invalid sequences
+ */
+static Uint32 _utf8_decode(const char **text) {
+    static const Uint32 min_codepoint[4] = {0, 0x80, 0x800, 0x10000};
+    const unsigned char *c = (const unsigned char *)*text;
+    Uint32 codepoint;
+    int extra;
+    if (c[0] < 0x80) {
+        *text += 1;
+        return c[0];
+    } else if ((c[0] & 0xE0) == 0xC0) {
+        codepoint = c[0] & 0x1F;
+        extra = 1;
+    } else if ((c[0] & 0xF0) == 0xE0) {
+        codepoint = c[0] & 0x0F;
+        extra = 2;
+    } else if ((c[0] & 0xF8) == 0xF0) {
+        codepoint = c[0] & 0x07;
+        extra = 3;
+    } else {
+        *text += 1;
+        return 0xFFFD;
+    }
+    for (int i = 1; i <= extra; i++) {
+        if ((c[i] & 0xC0) != 0x80) {
+            *text += i;
+            return 0xFFFD;
+        }
+        codepoint = (codepoint << 6) | (c[i] & 0x3F);
+    }
+    *text += extra + 1;
+    if (codepoint < min_codepoint[extra] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        return 0xFFFD;
+    }
+    return codepoint;
+}
 
-    for (int i = 0; i < thickness; i++) {
-        rectangleRGBA(_engine->renderer, x1 + i, y1 + i, x2 - i, y2 - i, color.r, color.g, color.b, color.a);
+/**
+ * Finds the slot of a glyph in the glyph table
+ * \param face The font face of the glyph
+ * \param size The size of the glyph
+ * \param quality The text quality of the glyph
+ * \param codepoint The codepoint of the glyph
+ * \return The slot holding the glyph, or the empty slot where it must be inserted
+ */
+static Glyph *_glyph_slot(FontFace *face, int size, TextQuality quality, Uint32 codepoint) {
+    Uint32 hash = (Uint32)((uintptr_t)face >> 4) * 2654435761u ^ codepoint * 2246822519u ^ ((Uint32)size << 2 | quality) * 3266489917u;
+    hash ^= hash >> 15;
+    int mask = _glyph_atlas.capacity - 1;
+    int i = hash & mask;
+    while (_glyph_atlas.glyphs[i].face != NULL) {
+        Glyph *glyph = &_glyph_atlas.glyphs[i];
+        if (glyph->face == face && glyph->size == size && glyph->quality == quality && glyph->codepoint == codepoint) break;
+        i = (i + 1) & mask;
     }
+    return &_glyph_atlas.glyphs[i];
+}
 
-    SDL_SetRenderTarget(_engine->renderer, NULL);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+/**
+ * Rebuilds the glyph table, dropping the glyphs of a shelf
+ * \param capacity The new number of slots, a power of two
+ * \param evicted_shelf The shelf whose glyphs are dropped, -1 to keep every glyph
+ */
+static void _glyph_table_rebuild(int capacity, int evicted_shelf) {
+    Glyph *old_glyphs = _glyph_atlas.glyphs;
+    int old_capacity = _glyph_atlas.capacity;
+    _glyph_atlas.glyphs = (Glyph *)calloc(capacity, sizeof(Glyph));
+    if (_glyph_atlas.glyphs == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for glyph table\n");
+        exit(1);
+    }
+    _glyph_atlas.capacity = capacity;
+    _glyph_atlas.count = 0;
+    for (int i = 0; i < old_capacity; i++) {
+        Glyph *glyph = &old_glyphs[i];
+        if (glyph->face == NULL || (evicted_shelf >= 0 && glyph->shelf == evicted_shelf)) continue;
+        *_glyph_slot(glyph->face, glyph->size, glyph->quality, glyph->codepoint) = *glyph;
+        _glyph_atlas.count++;
+    }
+    free(old_glyphs);
+}
 
-    _add_to_texture_list(texture, name);
+/**
+ * Removes every glyph and shelf from the glyph atlas
+ * \note The text layouts rebuild their quads when they see the new generation
+ */
+static void _glyph_atlas_clear() {
+    if (_glyph_atlas.glyphs != NULL) memset(_glyph_atlas.glyphs, 0, sizeof(Glyph) * _glyph_atlas.capacity);
+    _glyph_atlas.count = 0;
+    _glyph_atlas.nb_shelves = 0;
+    _glyph_atlas.used_mask = 0;
+    _glyph_atlas.generation++;
+}
 
-    return texture;
+/**
+ * Marks shelves of the glyph atlas as drawn this frame
+ * \param mask The shelves, one bit per shelf
+ * \note The mask of the previous frame is folded into the last used frame of its shelves
+ */
+static void _glyph_atlas_touch(Uint64 mask) {
+    if (_glyph_atlas.mask_frame != _frame_count) {
+        for (int i = 0; i < _glyph_atlas.nb_shelves; i++) {
+            if (_glyph_atlas.used_mask & ((Uint64)1 << i)) _glyph_atlas.shelves[i].last_used = _glyph_atlas.mask_frame;
+        }
+        _glyph_atlas.used_mask = 0;
+        _glyph_atlas.mask_frame = _frame_count;
+    }
+    _glyph_atlas.used_mask |= mask;
 }
 
 /**
- * Create a circle with a specified thickness as a texture
- * \param name The name of the texture
- * \param x The x position of the circle
- * \param y The y position of the circle
- * \param radius The radius of the circle
- * \param color The color of the circle
- * \param thickness The thickness of the circle
- * \return The texture
+ * Reserves a rectangle in the glyph atlas
+ * \param width The width of the rectangle
+ * \param height The height of the rectangle
+ * \param shelf The variable to store the shelf of the rectangle
+ * \return The rectangle, empty if it is larger than the atlas
+ * \note Uses the best fitting shelf with room, then a new shelf, then evicts the least recently used shelf that is tall enough and was not drawn this frame
+ * \note The whole atlas is cleared only when every tall enough shelf was drawn this frame
  */
-Texture *create_circle_thick(char *name, int x, int y, int radius, Color color, int thickness) {
-    _assert_engine_init();
-    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderTarget(_engine->renderer, texture);
+static SDL_Rect _glyph_atlas_pack(int width, int height, int *shelf) {
+    SDL_Rect rect = {0, 0, 0, 0};
+    *shelf = -1;
+    if (width > GLYPH_ATLAS_SIZE || height > GLYPH_ATLAS_SIZE) return rect;
+    int shelf_height = (height + GLYPH_SHELF_ROUND - 1) / GLYPH_SHELF_ROUND * GLYPH_SHELF_ROUND;
+    _glyph_atlas_touch(0);
+
+    // Best fitting shelf with room, tall shelves are not filled with small glyphs
+    int best = -1;
+    for (int i = 0; i < _glyph_atlas.nb_shelves; i++) {
+        GlyphShelf *current = &_glyph_atlas.shelves[i];
+        if (current->height < height || current->height > shelf_height + GLYPH_SHELF_ROUND) continue;
+        if (current->x + width > GLYPH_ATLAS_SIZE) continue;
+        if (best < 0 || current->height < _glyph_atlas.shelves[best].height) best = i;
+    }
 
-    thickCircleRGBA(_engine->renderer, x, y, radius, color.r, color.g, color.b, color.a, thickness);
+    // New shelf below the last one
+    if (best < 0) {
+        int bottom = 0;
+        if (_glyph_atlas.nb_shelves > 0) {
+            GlyphShelf *last = &_glyph_atlas.shelves[_glyph_atlas.nb_shelves - 1];
+            bottom = last->y + last->height + 1;
+        }
+        if (_glyph_atlas.nb_shelves < GLYPH_MAX_SHELVES && bottom + shelf_height <= GLYPH_ATLAS_SIZE) {
+            best = _glyph_atlas.nb_shelves++;
+            _glyph_atlas.shelves[best] = (GlyphShelf){bottom, shelf_height, 0, _frame_count};
+        }
+    }
 
-    SDL_SetRenderTarget(_engine->renderer, NULL);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+    // Least recently used shelf, its glyphs are dropped
+    if (best < 0) {
+        for (int i = 0; i < _glyph_atlas.nb_shelves; i++) {
+            GlyphShelf *current = &_glyph_atlas.shelves[i];
+            if (current->height < height || (_glyph_atlas.used_mask & ((Uint64)1 << i))) continue;
+            if (best < 0 || current->last_used < _glyph_atlas.shelves[best].last_used) best = i;
+        }
+        if (best >= 0) {
+            _glyph_table_rebuild(_glyph_atlas.capacity, best);
+            _glyph_atlas.shelves[best].x = 0;
+            _glyph_atlas.generation++;
+        }
+    }
 
-    _add_to_texture_list(texture, name);
+    if (best < 0) {
+        _glyph_atlas_clear();
+        best = 0;
+        _glyph_atlas.nb_shelves = 1;
+        _glyph_atlas.shelves[0] = (GlyphShelf){0, shelf_height, 0, _frame_count};
+    }
 
-    return texture;
+    GlyphShelf *target = &_glyph_atlas.shelves[best];
+    rect = (SDL_Rect){target->x, target->y, width, height};
+    target->x += width + 1;
+    *shelf = best;
+    return rect;
 }
 
 /**
- * Create an ellipse with a specified thickness as a texture
- * \param name The name of the texture
- * \param x The x position of the ellipse
- * \param y The y position of the ellipse
- * \param rx The x radius of the ellipse
- * \param ry The y radius of the ellipse
- * \param color The color of the ellipse
- * \param thickness The thickness of the ellipse
- * \return The texture
+ * Rasterizes a glyph in white, converted to the format of the glyph atlas
+ * \param ttf_font The font of the glyph, set to the size of the glyph
+ * \param quality The text quality of the glyph
+ * \param codepoint The codepoint of the glyph
+ * \return The surface of the glyph, NULL if the font has no such glyph
+ * \note Pixels are premultiplied by their alpha when the atlas is premultiplied
  */
-Texture *create_ellipse_thick(char *name, int x, int y, int rx, int ry, Color color, int thickness) {
-    _assert_engine_init();
-    SDL_Texture *texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _engine->width, _engine->height);
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderTarget(_engine->renderer, texture);
+static SDL_Surface *_rasterize_glyph(TTF_Font *ttf_font, TextQuality quality, Uint32 codepoint) {
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface *surface = NULL;
+    switch (quality) {
+        case TEXT_SHADED:
+            surface = TTF_RenderGlyph32_Shaded(ttf_font, codepoint, white, (SDL_Color){0, 0, 0, 255});
+            break;
+        case TEXT_BLENDED:
+            surface = TTF_RenderGlyph32_Blended(ttf_font, codepoint, white);
+            break;
+        default:
+            surface = TTF_RenderGlyph32_Solid(ttf_font, codepoint, white);
+            break;
+    }
+    if (surface == NULL) return NULL;
 
-    thickEllipseRGBA(_engine->renderer, x, y, rx, ry, color.r, color.g, color.b, color.a, thickness);
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(surface);
+    if (converted == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to convert glyph: %s\n", SDL_GetError());
+        exit(1);
+    }
+    if (_glyph_atlas.premultiplied && quality == TEXT_BLENDED) {
+        // Solid and shaded pixels have an alpha of 0 or 255, they are already premultiplied
+        for (int y = 0; y < converted->h; y++) {
+            Uint32 *pixel = (Uint32 *)((Uint8 *)converted->pixels + y * converted->pitch);
+            for (int x = 0; x < converted->w; x++) {
+                Uint32 a = pixel[x] >> 24;
+                Uint32 r = ((pixel[x] >> 16) & 0xFF) * a / 255;
+                Uint32 g = ((pixel[x] >> 8) & 0xFF) * a / 255;
+                Uint32 b = (pixel[x] & 0xFF) * a / 255;
+                pixel[x] = a << 24 | r << 16 | g << 8 | b;
+            }
+        }
+    }
+    return converted;
+}
 
-    SDL_SetRenderTarget(_engine->renderer, NULL);
-    SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+/**
+ * Gets a glyph, rasterizing it in the glyph atlas on first use
+ * \param font The font of the glyph
+ * \param codepoint The codepoint of the glyph
+ * \return The glyph, valid until the next glyph is rasterized
+ */
+static Glyph *_get_glyph(Font *font, Uint32 codepoint) {
+    if (_glyph_atlas.texture == NULL) {
+        _glyph_atlas.texture = SDL_CreateTexture(_engine->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, GLYPH_ATLAS_SIZE, GLYPH_ATLAS_SIZE);
+        if (_glyph_atlas.texture == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to create glyph atlas: %s\n", SDL_GetError());
+            exit(1);
+        }
+        // Premultiplied alpha, the software renderer has no custom blend modes and keeps straight alpha
+        SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        _glyph_atlas.premultiplied = SDL_SetTextureBlendMode(_glyph_atlas.texture, premultiplied) == 0;
+        if (!_glyph_atlas.premultiplied) SDL_SetTextureBlendMode(_glyph_atlas.texture, SDL_BLENDMODE_BLEND);
+        _glyph_table_rebuild(GLYPH_TABLE_SIZE, -1);
+    }
 
-    _add_to_texture_list(texture, name);
+    Glyph *glyph = _glyph_slot(font->face, font->size, font->quality, codepoint);
+    if (glyph->face != NULL) return glyph;
+    if ((_glyph_atlas.count + 1) * 4 > _glyph_atlas.capacity * 3) {
+        _glyph_table_rebuild(_glyph_atlas.capacity * 2, -1);
+    }
 
-    return texture;
-}
+    TTF_Font *ttf_font = _font_at_size(font);
+    int minx, maxx, miny, maxy, advance;
+    if (TTF_GlyphMetrics32(ttf_font, codepoint, &minx, &maxx, &miny, &maxy, &advance) != 0) {
+        minx = 0;
+        advance = 0;
+    }
 
-/***********************************************
- * Utility functions
- ************************************************/
+    // Rendered white, the vertex color tints it
+    SDL_Rect rect = {0, 0, 0, 0};
+    int shelf = -1;
+    SDL_Surface *surface = NULL;
+    if (codepoint != ' ' && codepoint != '\t') {
+        surface = _rasterize_glyph(ttf_font, font->quality, codepoint);
+    }
+    if (surface != NULL) {
+        rect = _glyph_atlas_pack(surface->w, surface->h, &shelf);
+        if (rect.w > 0) SDL_UpdateTexture(_glyph_atlas.texture, &rect, surface->pixels, surface->pitch);
+        SDL_FreeSurface(surface);
+    }
 
-/**
- * Sets the color of the renderer
- * \param color The color to set
- */
-void set_color(Color color) {
-    _assert_engine_init();
-    _color = color;
-    SDL_SetRenderDrawColor(_engine->renderer, color.r, color.g, color.b, color.a);
+    // The table may have been rebuilt while packing
+    glyph = _glyph_slot(font->face, font->size, font->quality, codepoint);
+    glyph->face = font->face;
+    glyph->size = font->size;
+    glyph->quality = font->quality;
+    glyph->codepoint = codepoint;
+    glyph->rect = rect;
+    glyph->shelf = shelf;
+    glyph->offset = minx < 0 ? minx : 0;
+    glyph->advance = advance;
+    _glyph_atlas.count++;
+    return glyph;
 }
 
 /**
- * Change the background color
- * \param color The color to set
+ * Frees a text layout
+ * \param layout The text layout
  */
-void set_background_color(Color color) {
-    _assert_engine_init();
-    _clear_color = color;
+static void _free_text_layout(TextLayout *layout) {
+    free(layout->text);
+    free(layout->glyphs);
+    free(layout->vertices);
+    free(layout);
 }
 
 /**
- * Delay the program
- * \param ms The time to delay in milliseconds
+ * Frees the text layouts not used for a while, at most once per frame
  */
-void delay(int ms) {
-    SDL_Delay(ms);
+static void _sweep_text_layouts() {
+    if (_text_layouts_swept == _frame_count) return;
+    _text_layouts_swept = _frame_count;
+    for (int i = 0; i < LAYOUT_CACHE_SIZE; i++) {
+        TextLayout **link = &_text_layouts[i];
+        while (*link != NULL) {
+            TextLayout *layout = *link;
+            if (layout->last_used + LAYOUT_LIFETIME < _frame_count) {
+                *link = layout->next;
+                _free_text_layout(layout);
+            } else {
+                link = &layout->next;
+            }
+        }
+    }
 }
 
-/***********************************************
- * Event functions
- ***********************************************/
-
 /**
- * Get the mouse position
- * \param x The variable to store the x position of the mouse
- * \param y The variable to store the y position of the mouse
+ * Frees the text layouts of a font, or all of them
+ * \param font The font, NULL for every font
  */
-void get_mouse_position(int *x, int *y) {
-    _assert_engine_init();
-    SDL_GetMouseState(x, y);
+static void _purge_text_layouts(Font *font) {
+    for (int i = 0; i < LAYOUT_CACHE_SIZE; i++) {
+        TextLayout **link = &_text_layouts[i];
+        while (*link != NULL) {
+            TextLayout *layout = *link;
+            if (font == NULL || layout->font == font) {
+                *link = layout->next;
+                _free_text_layout(layout);
+            } else {
+                link = &layout->next;
+            }
+        }
+    }
 }
 
 /**
- * Checks if any key is pressed
- * \return True if any key is pressed, false otherwise
+ * Frees the glyph atlas and the text layouts
  */
-bool any_key_pressed() {
-    _assert_engine_init();
-    return _event.type == SDL_KEYDOWN;
+static void _text_cache_destroy() {
+    _purge_text_layouts(NULL);
+    if (_glyph_atlas.texture != NULL) SDL_DestroyTexture(_glyph_atlas.texture);
+    free(_glyph_atlas.glyphs);
+    memset(&_glyph_atlas, 0, sizeof(GlyphAtlas));
+    free(_text_indices);
+    _text_indices = NULL;
+    _text_indices_capacity = 0;
 }
 
 /**
- * Checks if an object is hovered
- * \param object The object to check
- * \return True if the object is hovered, false otherwise
+ * Lays out a string: decodes it, places its glyphs with kerning and wraps its words to a width
+ * \param layout The layout, its font, wrap width and text must be set
+ * \note Words wider than the wrap width are broken between glyphs, '\n' always starts a new line
  */
-bool object_is_hovered(Object *object) {
-    _assert_engine_init();
-    int mouseX, mouseY;
-    SDL_GetMouseState(&mouseX, &mouseY);
+static void _layout_text(TextLayout *layout) {
+    Font *font = layout->font;
+    int wrap_width = layout->wrap_width;
+    int line_skip = TTF_FontLineSkip(_font_at_size(font));
+    size_t capacity = strlen(layout->text) + 1;
+    LayoutGlyph *glyphs = (LayoutGlyph *)malloc(sizeof(LayoutGlyph) * capacity);
+    if (glyphs == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for text layout\n");
+        exit(1);
+    }
 
-    return mouseX >= object->x && mouseX <= object->x + object->width && mouseY >= object->y && mouseY <= object->y + object->height;
+    int count = 0, line_start = 0, break_index = -1;
+    int pen_x = 0, y = 0;
+    Uint32 previous = 0;
+    const char *c = layout->text;
+    while (*c) {
+        Uint32 codepoint = _utf8_decode(&c);
+        if (codepoint == '\n') {
+            pen_x = 0;
+            y += line_skip;
+            line_start = count;
+            break_index = -1;
+            previous = 0;
+            continue;
+        }
+        if (codepoint == '\r') continue;
+        if (codepoint == '\t') codepoint = ' ';
+
+        int advance = _get_glyph(font, codepoint)->advance;
+        int x = pen_x + (previous != 0 ? TTF_GetFontKerningSizeGlyphs32(_font_at_size(font), previous, codepoint) : 0);
+        if (wrap_width > 0 && codepoint != ' ' && x + advance > wrap_width && count > line_start) {
+            if (break_index > line_start) {
+                // Move the current word to the next line
+                int shift = break_index < count ? glyphs[break_index].x : x;
+                for (int i = break_index; i < count; i++) {
+                    glyphs[i].x -= shift;
+                    glyphs[i].y += line_skip;
+                }
+                x -= shift;
+                line_start = break_index;
+            } else {
+                x = 0;
+                line_start = count;
+            }
+            y += line_skip;
+            break_index = -1;
+        }
+
+        glyphs[count++] = (LayoutGlyph){codepoint, x, y, advance};
+        pen_x = x + advance;
+        if (codepoint == ' ') break_index = count;
+        previous = codepoint;
+    }
+
+    int width = 0;
+    for (int i = 0; i < count; i++) {
+        if (glyphs[i].codepoint != ' ' && glyphs[i].x + glyphs[i].advance > width) {
+            width = glyphs[i].x + glyphs[i].advance;
+        }
+    }
+
+    layout->glyphs = glyphs;
+    layout->nb_glyphs = count;
+    layout->width = width;
+    layout->height = y + TTF_FontHeight(_font_at_size(font));
+    layout->vertices = (SDL_Vertex *)malloc(sizeof(SDL_Vertex) * 4 * (count > 0 ? count : 1));
+    if (layout->vertices == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for text layout\n");
+        exit(1);
+    }
+    layout->nb_quads = -1;
 }
 
 /**
- * Checks if an object is hovered by name
- * \param name The name of the object to check
- * \return True if the object is hovered, false otherwise (or if the object does not exist)
+ * Builds the quads of a text layout from the glyph atlas
+ * \param layout The text layout
  */
-bool object_is_hovered_by_name(char *name) {
-    _assert_engine_init();
-    ObjectList *current = _object_list;
-    while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
-            return object_is_hovered(current->object);
+static void _build_text_quads(TextLayout *layout) {
+    const float scale = 1.0f / GLYPH_ATLAS_SIZE;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        Uint32 generation = _glyph_atlas.generation;
+        SDL_Vertex *vertex = layout->vertices;
+        layout->nb_quads = 0;
+        layout->shelf_mask = 0;
+        for (int i = 0; i < layout->nb_glyphs; i++) {
+            LayoutGlyph *placed = &layout->glyphs[i];
+            Glyph *glyph = _get_glyph(layout->font, placed->codepoint);
+            if (glyph->rect.w == 0) continue;
+            layout->shelf_mask |= (Uint64)1 << glyph->shelf;
+
+            float x1 = (float)(placed->x + glyph->offset);
+            float y1 = (float)placed->y;
+            float x2 = x1 + glyph->rect.w;
+            float y2 = y1 + glyph->rect.h;
+            float u1 = glyph->rect.x * scale;
+            float v1 = glyph->rect.y * scale;
+            float u2 = (glyph->rect.x + glyph->rect.w) * scale;
+            float v2 = (glyph->rect.y + glyph->rect.h) * scale;
+            SDL_Color white = {255, 255, 255, 255};
+            vertex[0] = (SDL_Vertex){{x1, y1}, white, {u1, v1}};
+            vertex[1] = (SDL_Vertex){{x2, y1}, white, {u2, v1}};
+            vertex[2] = (SDL_Vertex){{x2, y2}, white, {u2, v2}};
+            vertex[3] = (SDL_Vertex){{x1, y2}, white, {u1, v2}};
+            vertex += 4;
+            layout->nb_quads++;
         }
-        current = current->next;
+        layout->generation = generation;
+        // A layout larger than the whole atlas keeps the glyphs of its last pass
+        if (_glyph_atlas.generation == generation) return;
     }
-    return false;
 }
 
-/***********************************************
- * Text functions
- ***********************************************/
-
 /**
- * Loads a font
- * \param filename The path to the font
- * \param size The size of the font
- * \param name The name of the font
+ * Gets the layout of a string, from the layout cache when the same string was laid out recently
+ * \param font The font
+ * \param text The string, UTF-8 encoded
+ * \param wrap_width The width to wrap the text to, 0 for no wrapping
+ * \return The text layout
  */
-void load_font(char *filename, int size, char *name) {
-    _assert_engine_init();
-    TTF_Font *font = TTF_OpenFont(filename, size);
-    if (font == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to load font: %s\n", TTF_GetError());
-        exit(1);
-    }
-    char *name_alloc = (char *)malloc(sizeof(char) * strlen(filename) + 1);
-    if (name_alloc == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for font filename\n");
-        exit(1);
+static TextLayout *_get_text_layout(Font *font, const char *text, int wrap_width) {
+    _sweep_text_layouts();
+    size_t length;
+    Uint32 hash = _hash_string(text, &length);
+    Uint32 bucket = (hash ^ (Uint32)((uintptr_t)font >> 4) * 2654435761u ^ (Uint32)wrap_width * 40503u) & (LAYOUT_CACHE_SIZE - 1);
+    for (TextLayout *layout = _text_layouts[bucket]; layout != NULL; layout = layout->next) {
+        if (layout->hash == hash && layout->font == font && layout->wrap_width == wrap_width && strcmp(layout->text, text) == 0) {
+            layout->last_used = _frame_count;
+            return layout;
+        }
     }
-    strcpy(name_alloc, name);
 
-    Font *font_struct = (Font *)malloc(sizeof(Font));
-    if (font_struct == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for font\n");
+    TextLayout *layout = (TextLayout *)malloc(sizeof(TextLayout));
+    char *copy = (char *)malloc(length + 1);
+    if (layout == NULL || copy == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for text layout\n");
         exit(1);
     }
+    memcpy(copy, text, length + 1);
+    layout->hash = hash;
+    layout->font = font;
+    layout->wrap_width = wrap_width;
+    layout->text = copy;
+    layout->last_used = _frame_count;
+    _layout_text(layout);
+    layout->next = _text_layouts[bucket];
+    _text_layouts[bucket] = layout;
+    return layout;
+}
 
-    font_struct->name = name_alloc;
-    font_struct->font = font;
-    font_struct->next = NULL;
-
-    if (_font == NULL) {
-        _font = font_struct;
-    } else {
-        Font *current = _font;
-        while (current->next != NULL) {
-            current = current->next;
+/**
+ * Draws a text layout with the glyph atlas in a single geometry call
+ * \param layout The text layout
+ * \param x The x position of the anchor
+ * \param y The y position of the anchor
+ * \param color The color of the text
+ * \param anchor The point of the layout placed at the anchor
+ */
+static void _draw_text_layout(TextLayout *layout, int x, int y, Color color, Anchor anchor) {
+    if (layout->nb_quads < 0 || layout->generation != _glyph_atlas.generation) {
+        _build_text_quads(layout);
+    }
+    if (layout->nb_quads == 0) return;
+    _glyph_atlas_touch(layout->shelf_mask);
+
+    if (_text_indices_capacity < layout->nb_quads) {
+        int capacity = _text_indices_capacity > 0 ? _text_indices_capacity : 64;
+        while (capacity < layout->nb_quads) capacity *= 2;
+        int *indices = (int *)realloc(_text_indices, sizeof(int) * 6 * capacity);
+        if (indices == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to allocate memory for text indices\n");
+            exit(1);
         }
-        current->next = font_struct;
+        for (int i = _text_indices_capacity; i < capacity; i++) {
+            int *index = indices + i * 6;
+            index[0] = i * 4;
+            index[1] = i * 4 + 1;
+            index[2] = i * 4 + 2;
+            index[3] = i * 4;
+            index[4] = i * 4 + 2;
+            index[5] = i * 4 + 3;
+        }
+        _text_indices = indices;
+        _text_indices_capacity = capacity;
     }
-}
 
-static Font *_get_font(char *font_name) {
-    Font *current = _font;
-    while (current != NULL) {
-        if (strcmp(current->name, font_name) == 0) {
-            return current;
-        }
-        current = current->next;
+    SDL_Rect rect = _anchor_rect(x, y, layout->width, layout->height, anchor);
+    if (_glyph_atlas.premultiplied && color.a != 255) {
+        color.r = color.r * color.a / 255;
+        color.g = color.g * color.a / 255;
+        color.b = color.b * color.a / 255;
     }
-    fprintf(stderr, "[ENGINE] Font not found: %s\n", font_name);
-    exit(1);
+    int nb_vertices = layout->nb_quads * 4;
+    SDL_Vertex *vertices = (SDL_Vertex *)engine_frame_alloc(sizeof(SDL_Vertex) * nb_vertices);
+    for (int i = 0; i < nb_vertices; i++) {
+        vertices[i] = layout->vertices[i];
+        vertices[i].position.x += rect.x;
+        vertices[i].position.y += rect.y;
+        vertices[i].color = color;
+    }
+    flush_geometry();
+    if (layout->font->quality == TEXT_SHADED) {
+        // Fills the gaps between the glyph boxes
+        SDL_SetRenderDrawBlendMode(_engine->renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(_engine->renderer, 0, 0, 0, color.a);
+        SDL_RenderFillRect(_engine->renderer, &rect);
+        SDL_SetRenderDrawColor(_engine->renderer, _color.r, _color.g, _color.b, _color.a);
+    }
+    SDL_RenderGeometry(_engine->renderer, _glyph_atlas.texture, vertices, nb_vertices, _text_indices, layout->nb_quads * 6);
 }
 
 /**
  * Draws text
  * \param font_name The name of the font
- * \param text The text to draw
+ * \param text The text to draw, UTF-8 encoded
  * \param x The x position to draw the text
  * \param y The y position to draw the text
  * \param color The color of the text
  * \param anchor The anchor of the text
+ * \note The layout of the text is cached, drawing the same text again costs a hash lookup and one geometry call
  */
 void draw_text(char *font_name, char *text, int x, int y, Color color, Anchor anchor) {
+    _assert_engine_init();
+    draw_text_wrapped(font_name, text, x, y, 0, color, anchor);
+}
+
+/**
+ * Draws text wrapped to a width
+ * \param font_name The name of the font
+ * \param text The text to draw, UTF-8 encoded
+ * \param x The x position to draw the text
+ * \param y The y position to draw the text
+ * \param width The width to wrap the text to, 0 for no wrapping
+ * \param color The color of the text
+ * \param anchor The anchor of the text block
+ * \note Lines are broken at spaces, at '\n', or between glyphs for words wider than the width
+ */
+void draw_text_wrapped(char *font_name, char *text, int x, int y, int width, Color color, Anchor anchor) {
     _assert_engine_init();
     if (_font == NULL) {
         fprintf(stderr, "[ENGINE] Font not loaded\n");
         exit(1);
     }
-
     Font *font_struct = _get_font(font_name);
-    SDL_Surface *surface = TTF_RenderText_Solid(font_struct->font, text, color);
-    if (surface == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to render text: %s\n", TTF_GetError());
-        exit(1);
-    }
-
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(_engine->renderer, surface);
-    if (texture == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to create texture from surface: %s\n", SDL_GetError());
-        exit(1);
-    }
-
-    SDL_Rect rect = {x, y, surface->w, surface->h};
-    switch (anchor) {
-        case TOP_LEFT:
-            break;
-        case TOP:
-            rect.x -= surface->w / 2;
-            break;
-        case TOP_RIGHT:
-            rect.x -= surface->w;
-            break;
-        case LEFT:
-            rect.y -= surface->h / 2;
-            break;
-        case CENTER:
-            rect.x -= surface->w / 2;
-            rect.y -= surface->h / 2;
-            break;
-        case RIGHT:
-            rect.x -= surface->w;
-            rect.y -= surface->h / 2;
-            break;
-        case BOTTOM_LEFT:
-            rect.y -= surface->h;
-            break;
-        case BOTTOM:
-            rect.x -= surface->w / 2;
-            rect.y -= surface->h;
-            break;
-        case BOTTOM_RIGHT:
-            rect.x -= surface->w;
-            rect.y -= surface->h;
-            break;
-    }
+    _draw_text_layout(_get_text_layout(font_struct, text, width), x, y, color, anchor);
+}
 
-    SDL_RenderCopy(_engine->renderer, texture, NULL, &rect);
+/**
+ * Measures text
+ * \param font_name The name of the font
+ * \param text The text to measure, UTF-8 encoded
+ * \param width The width to wrap the text to, 0 for no wrapping
+ * \param text_width The variable to store the width of the text
+ * \param text_height The variable to store the height of the text
+ */
+void measure_text(char *font_name, char *text, int width, int *text_width, int *text_height) {
+    _assert_engine_init();
+    Font *font_struct = _get_font(font_name);
+    TextLayout *layout = _get_text_layout(font_struct, text, width);
+    *text_width = layout->width;
+    *text_height = layout->height;
+}
 
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
+/**
+ * Sets the text quality of a font
+ * \param font_name The name of the font
+ * \param quality The text quality (TEXT_SOLID by default)
+ * \note Glyphs are rasterized once per quality in the glyph atlas, blended text costs the same per frame as solid text
+ */
+void set_font_quality(char *font_name, TextQuality quality) {
+    _assert_engine_init();
+    Font *font_struct = _get_font(font_name);
+    if (font_struct->quality == quality) return;
+    _purge_text_layouts(font_struct);
+    font_struct->quality = quality;
 }
 
 /**
@@ -1426,18 +4778,20 @@ void draw_text(char *font_name, char *text, int x, int y, Color color, Anchor an
  */
 void close_font(char *name) {
     _assert_engine_init();
+    const char *key = _intern_find(name);
     Font *current = _font;
     Font *prev = NULL;
     while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
+        if (current->name == key) {
             if (prev == NULL) {
                 _font = current->next;
             } else {
                 prev->next = current->next;
             }
-            TTF_CloseFont(current->font);
-            free(current->name);
-            free(current);
+            _purge_text_layouts(current);
+            _ui_purge_texts(current);
+            _release_font_face(current->face);
+            _pool_free(&_font_pool, current);
             return;
         }
         prev = current;
@@ -1457,31 +4811,386 @@ void close_all_fonts() {
     Font *current = _font;
     while (current != NULL) {
         Font *next = current->next;
-        TTF_CloseFont(current->font);
-        free(current->name);
-        free(current);
+        _purge_text_layouts(current);
+        _ui_purge_texts(current);
+        _release_font_face(current->face);
+        _pool_free(&_font_pool, current);
         current = next;
     }
     _font = NULL;
 }
 
 /***********************************************
- * Audio functions
+ * UI functions
  ***********************************************/
 
-static void _add_to_sound_list(Mix_Chunk *audio, char *name) {
-    char *sound_name = (char *)malloc(sizeof(char) * strlen(name) + 1);
-    if (sound_name == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for audio name\n");
+/**
+ * Frees a cached UI text
+ * \param text The cached text
+ */
+static void _ui_free_text(UIText *text) {
+    if (text->texture != NULL) SDL_DestroyTexture(text->texture);
+    free(text->text);
+    free(text);
+}
+
+/**
+ * Finds the slot of a widget text in the UI text table
+ * \param id The interned id of the widget
+ * \param index The index of the text in the widget
+ * \return The index of the slot holding the text, or of the empty slot where it belongs
+ */
+static int _ui_text_slot(const char *id, int index) {
+    int mask = _ui_texts.capacity - 1;
+    int i = (int)((((uintptr_t)id >> 4) * 2654435761u ^ (Uint32)index * 40503u) & mask);
+    while (_ui_texts.texts[i] != NULL && (_ui_texts.texts[i]->id != id || _ui_texts.texts[i]->index != index)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/**
+ * Moves the UI texts to a new table
+ * \param capacity The number of slots of the new table, a power of two
+ */
+static void _ui_text_table_rebuild(int capacity) {
+    UIText **old_texts = _ui_texts.texts;
+    int old_capacity = _ui_texts.capacity;
+    _ui_texts.texts = (UIText **)calloc(capacity, sizeof(UIText *));
+    if (_ui_texts.texts == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for UI text table\n");
+        exit(1);
+    }
+    _ui_texts.capacity = capacity;
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_texts[i] != NULL) _ui_texts.texts[_ui_text_slot(old_texts[i]->id, old_texts[i]->index)] = old_texts[i];
+    }
+    free(old_texts);
+}
+
+/**
+ * Frees the cached UI texts of a font, or the ones not drawn for a while
+ * \param font The font of the texts to free, NULL to free the texts not drawn for `UI_TEXT_LIFETIME` frames
+ * \note The table is rebuilt only when a text is freed, so lookups never need tombstones
+ */
+static void _ui_purge_texts(Font *font) {
+    int count = _ui_texts.count;
+    for (int i = 0; i < _ui_texts.capacity; i++) {
+        UIText *text = _ui_texts.texts[i];
+        if (text == NULL) continue;
+        if (font != NULL ? text->font != font : text->last_used + UI_TEXT_LIFETIME >= _frame_count) continue;
+        _ui_free_text(text);
+        _ui_texts.texts[i] = NULL;
+        _ui_texts.count--;
+    }
+    if (_ui_texts.count != count) _ui_text_table_rebuild(_ui_texts.capacity);
+}
+
+/**
+ * Gets the cached texture of a widget text, rendering it again only if the text, font or color changed
+ * \param id The interned id of the widget
+ * \param index The index of the text in the widget
+ * \param string The text
+ * \return The cached text, its texture is NULL for empty text
+ */
+static UIText *_ui_text(const char *id, int index, const char *string) {
+    Color color = _ui_style.text;
+    if ((_ui_texts.count + 1) * 2 > _ui_texts.capacity) {
+        _ui_text_table_rebuild(_ui_texts.capacity > 0 ? _ui_texts.capacity * 2 : 64);
+    }
+    int slot = _ui_text_slot(id, index);
+    UIText *text = _ui_texts.texts[slot];
+
+    if (text == NULL) {
+        text = (UIText *)malloc(sizeof(UIText));
+        if (text == NULL) {
+            fprintf(stderr, "[ENGINE] Failed to allocate memory for UI text\n");
+            exit(1);
+        }
+        text->id = id;
+        text->index = index;
+        text->text = NULL;
+        text->texture = NULL;
+        _ui_texts.texts[slot] = text;
+        _ui_texts.count++;
+    } else if (text->font == _ui_font && strcmp(text->text, string) == 0 &&
+               text->color.r == color.r && text->color.g == color.g && text->color.b == color.b && text->color.a == color.a) {
+        text->last_used = _frame_count;
+        return text;
+    }
+
+    size_t length = strlen(string);
+    free(text->text);
+    text->text = (char *)malloc(length + 1);
+    if (text->text == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to allocate memory for UI text\n");
+        exit(1);
+    }
+    memcpy(text->text, string, length + 1);
+    if (text->texture != NULL) SDL_DestroyTexture(text->texture);
+    text->texture = NULL;
+    text->font = _ui_font;
+    text->color = color;
+    text->width = 0;
+    text->height = TTF_FontHeight(_font_at_size(_ui_font));
+    text->last_used = _frame_count;
+    if (length == 0) return text;
+
+    SDL_Surface *surface = TTF_RenderUTF8_Blended(_font_at_size(_ui_font), string, color);
+    if (surface == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to render text: %s\n", TTF_GetError());
+        exit(1);
+    }
+    text->texture = SDL_CreateTextureFromSurface(_engine->renderer, surface);
+    if (text->texture == NULL) {
+        fprintf(stderr, "[ENGINE] Failed to create texture from surface: %s\n", SDL_GetError());
+        exit(1);
+    }
+    text->width = surface->w;
+    text->height = surface->h;
+    SDL_FreeSurface(surface);
+    return text;
+}
+
+/**
+ * Queues a cached text to be drawn when the UI pass ends
+ * \param text The cached text
+ * \param x The x position of the anchor
+ * \param y The y position of the anchor
+ * \param anchor The point of the text placed at the anchor
+ */
+static void _ui_draw_text(UIText *text, int x, int y, Anchor anchor) {
+    if (text->texture == NULL) return;
+    if (_ui_nb_draws == _ui_draws_capacity) {
+        UITextDraw *draws = (UITextDraw *)engine_frame_alloc(sizeof(UITextDraw) * _ui_draws_capacity * 2);
+        memcpy(draws, _ui_draws, sizeof(UITextDraw) * _ui_nb_draws);
+        _ui_draws = draws;
+        _ui_draws_capacity *= 2;
+    }
+    _ui_draws[_ui_nb_draws].texture = text->texture;
+    _ui_draws[_ui_nb_draws].rect = _anchor_rect(x, y, text->width, text->height, anchor);
+    _ui_nb_draws++;
+}
+
+/**
+ * Draws the batched quads and the queued text of the UI pass
+ */
+static void _ui_flush() {
+    flush_geometry();
+    for (int i = 0; i < _ui_nb_draws; i++) {
+        SDL_RenderCopy(_engine->renderer, _ui_draws[i].texture, NULL, &_ui_draws[i].rect);
+    }
+    _ui_nb_draws = 0;
+}
+
+/**
+ * Adds a quad of a widget to the batch
+ * \param x The x position of the quad
+ * \param y The y position of the quad
+ * \param width The width of the quad
+ * \param height The height of the quad
+ * \param color The color of the quad
+ * \note The batch is drawn first if the quad covers queued text, so widgets stay in submission order
+ */
+static void _ui_box(int x, int y, int width, int height, Color color) {
+    SDL_Rect rect = {x, y, width, height};
+    for (int i = 0; i < _ui_nb_draws; i++) {
+        if (SDL_HasIntersection(&rect, &_ui_draws[i].rect)) {
+            _ui_flush();
+            break;
+        }
+    }
+    _tessellate_box(&_geometry_batch, x, y, x + width, y + height, color);
+}
+
+/**
+ * Checks that a UI pass is started
+ */
+static void _ui_assert_begin() {
+    if (_ui_font == NULL) {
+        fprintf(stderr, "[ENGINE] UI not started, call ui_begin first\n");
         exit(1);
     }
-    strcpy(sound_name, name);
+}
+
+/**
+ * Checks if the mouse is over a rectangle
+ * \return True if the mouse is over the rectangle, false otherwise
+ */
+static bool _ui_hovered(int x, int y, int width, int height) {
+    return _input.mouse_x >= x && _input.mouse_x < x + width && _input.mouse_y >= y && _input.mouse_y < y + height;
+}
+
+/**
+ * Handles the mouse for a clickable area of a widget
+ * \param id The interned id of the widget
+ * \param index The index of the area in the widget
+ * \param hovered If the mouse is over the area
+ * \return True if the area was clicked (pressed and released over it) during the frame
+ */
+static bool _ui_clicked(const char *id, int index, bool hovered) {
+    if (hovered && (_input.pressed & SDL_BUTTON_LMASK)) {
+        _ui_active = id;
+        _ui_active_index = index;
+    }
+    return hovered && (_input.released & SDL_BUTTON_LMASK) && _ui_active == id && _ui_active_index == index;
+}
 
-    Audiolist *sound_list_item = (Audiolist *)malloc(sizeof(Audiolist));
-    if (sound_list_item == NULL) {
-        fprintf(stderr, "[ENGINE] Failed to allocate memory for audio list item\n");
+/**
+ * Starts a UI pass, the widgets are drawn when `ui_end` is called
+ * \param font_name The name of the font of the widgets
+ * \note The quads of the widgets are batched in a single geometry call and their text is drawn above them, the batch is only split when a quad covers text queued before it
+ * \note Cached text not drawn for a while is freed here
+ */
+void ui_begin(char *font_name) {
+    _assert_engine_init();
+    if (_ui_font != NULL) {
+        fprintf(stderr, "[ENGINE] UI already started\n");
         exit(1);
     }
+    _ui_font = _get_font(font_name);
+
+    _ui_purge_texts(NULL);
+
+    _ui_draws = (UITextDraw *)engine_frame_alloc(sizeof(UITextDraw) * UI_DRAWS_SIZE);
+    _ui_nb_draws = 0;
+    _ui_draws_capacity = UI_DRAWS_SIZE;
+}
+
+/**
+ * Ends the UI pass and draws the widgets
+ */
+void ui_end() {
+    _assert_engine_init();
+    _ui_assert_begin();
+    _ui_flush();
+    if (!(_input.buttons & SDL_BUTTON_LMASK)) {
+        _ui_active = NULL;
+        _ui_active_index = -1;
+    }
+    _ui_draws = NULL;
+    _ui_nb_draws = 0;
+    _ui_draws_capacity = 0;
+    _ui_font = NULL;
+}
+
+/**
+ * Sets the colors of the UI widgets
+ * \param style The style
+ */
+void ui_set_style(UIStyle style) {
+    _ui_style = style;
+}
+
+/**
+ * Draws a panel
+ * \param x The x position of the panel
+ * \param y The y position of the panel
+ * \param width The width of the panel
+ * \param height The height of the panel
+ * \return True if the panel is hovered, false otherwise
+ */
+bool ui_panel(int x, int y, int width, int height) {
+    _assert_engine_init();
+    _ui_assert_begin();
+    _ui_box(x, y, width, height, _ui_style.panel);
+    return _ui_hovered(x, y, width, height);
+}
+
+/**
+ * Draws a label
+ * \param id The id of the label, its text texture is cached under this id
+ * \param text The text of the label
+ * \param x The x position of the label
+ * \param y The y position of the label
+ * \param anchor The anchor of the label
+ */
+void ui_label(char *id, char *text, int x, int y, Anchor anchor) {
+    _assert_engine_init();
+    _ui_assert_begin();
+    _ui_draw_text(_ui_text(engine_intern(id), 0, text), x, y, anchor);
+}
+
+/**
+ * Draws a button
+ * \param id The id of the button, its text texture is cached under this id
+ * \param text The text of the button, centered
+ * \param x The x position of the button
+ * \param y The y position of the button
+ * \param width The width of the button
+ * \param height The height of the button
+ * \return True if the button was clicked during the frame, false otherwise
+ */
+bool ui_button(char *id, char *text, int x, int y, int width, int height) {
+    _assert_engine_init();
+    _ui_assert_begin();
+    const char *key = engine_intern(id);
+    bool hovered = _ui_hovered(x, y, width, height);
+    bool clicked = _ui_clicked(key, 0, hovered);
+
+    Color color = _ui_style.button;
+    if (_ui_active == key && (_input.buttons & SDL_BUTTON_LMASK)) {
+        color = _ui_style.button_pressed;
+    } else if (hovered) {
+        color = _ui_style.button_hovered;
+    }
+    _ui_box(x, y, width, height, color);
+    _ui_draw_text(_ui_text(key, 0, text), x + width / 2, y + height / 2, CENTER);
+    return clicked;
+}
+
+/**
+ * Draws a list of items, one per row
+ * \param id The id of the list, the text textures of its items are cached under this id
+ * \param items The text of the items
+ * \param count The number of items
+ * \param x The x position of the list
+ * \param y The y position of the list
+ * \param width The width of the list
+ * \param item_height The height of each item
+ * \param selected The index of the selected item, -1 for none
+ * \return The index of the item clicked during the frame, `selected` otherwise
+ */
+int ui_list(char *id, char **items, int count, int x, int y, int width, int item_height, int selected) {
+    _assert_engine_init();
+    _ui_assert_begin();
+    const char *key = engine_intern(id);
+    int result = selected;
+    for (int i = 0; i < count; i++) {
+        int item_y = y + i * item_height;
+        bool hovered = _ui_hovered(x, item_y, width, item_height);
+        if (_ui_clicked(key, i, hovered)) result = i;
+
+        if (i == selected) {
+            _ui_box(x, item_y, width, item_height, _ui_style.item_selected);
+        } else if (hovered) {
+            _ui_box(x, item_y, width, item_height, _ui_style.item_hovered);
+        }
+        _ui_draw_text(_ui_text(key, i, items[i]), x + 4, item_y + item_height / 2, LEFT);
+    }
+    return result;
+}
+
+/**
+ * Frees every cached UI text
+ */
+void ui_clear_cache() {
+    _assert_engine_init();
+    for (int i = 0; i < _ui_texts.capacity; i++) {
+        if (_ui_texts.texts[i] != NULL) _ui_free_text(_ui_texts.texts[i]);
+    }
+    free(_ui_texts.texts);
+    _ui_texts = (UITextTable){NULL, 0, 0};
+}
+
+/***********************************************
+ * Audio functions
+ ***********************************************/
+
+static void _add_to_sound_list(Mix_Chunk *audio, char *name) {
+    const char *sound_name = engine_intern(name);
+
+    Audiolist *sound_list_item = (Audiolist *)_pool_alloc(&_audio_list_pool);
 
     sound_list_item->audio = audio;
     sound_list_item->name = sound_name;
@@ -1522,9 +5231,10 @@ Audio *load_audio(char *filename, char *name) {
  */
 Audio *get_audio_by_name(char *name) {
     _assert_engine_init();
+    const char *key = _intern_find(name);
     Audiolist *current = _audio_list;
     while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
+        if (current->name == key) {
             return current->audio;
         }
         current = current->next;
@@ -1550,9 +5260,10 @@ void play_audio(Audio *audio, int channel) {
  */
 void play_audio_by_name(char *name, int channel) {
     _assert_engine_init();
+    const char *key = _intern_find(name);
     Audiolist *current = _audio_list;
     while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
+        if (current->name == key) {
             Mix_PlayChannel(channel, current->audio, 0);
             return;
         }
@@ -1586,18 +5297,18 @@ void stop_audio(int channel) {
  */
 void close_audio(char *name) {
     _assert_engine_init();
+    const char *key = _intern_find(name);
     Audiolist *current = _audio_list;
     Audiolist *prev = NULL;
     while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
+        if (current->name == key) {
             if (prev == NULL) {
                 _audio_list = current->next;
             } else {
                 prev->next = current->next;
             }
             Mix_FreeChunk(current->audio);
-            free(current->name);
-            free(current);
+            _pool_free(&_audio_list_pool, current);
             return;
         }
         prev = current;
@@ -1614,8 +5325,7 @@ void close_all_audios() {
     while (current != NULL) {
         Audiolist *next = current->next;
         Mix_FreeChunk(current->audio);
-        free(current->name);
-        free(current);
+        _pool_free(&_audio_list_pool, current);
         current = next;
     }
     _audio_list = NULL;
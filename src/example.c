@@ -5,11 +5,20 @@ void draw(void *game);
 void event_handler(SDL_Event event, void *game);
 
 static void create_hitboxes();
+static Mesh *create_grid();
+static void apply_command(void *game, int player, const Command *command);
+static Uint32 checksum(void *game);
+
+static Mesh *grid = NULL;
+static Transport *transport = NULL;
+static Lockstep *lockstep = NULL;
 
 int main(int argc, char *argv[]) {
     engine_init("TinyWar", WIN_W, WIN_H, FPS);
     load_font("assets/font.ttf", 32, "font_32");
     load_font("assets/font.ttf", 64, "font_64");
+    set_font_quality("font_32", TEXT_BLENDED);
+    set_font_quality("font_64", TEXT_BLENDED);
 
     load_audio("audio/start.ogg", "start");
     load_audio("audio/click.ogg", "click");
@@ -28,11 +37,24 @@ int main(int argc, char *argv[]) {
     }
     init_game(game);
 
+    // Online play: example <player 1|2> <local port> <peer host> <peer port>
+    if (argc == 5) {
+        transport = transport_udp_open(atoi(argv[2]), argv[3], atoi(argv[4]));
+        lockstep = lockstep_create(transport, atoi(argv[1]) - 1, INPUT_DELAY, apply_command, checksum, game);
+        set_manual_update(false);
+    }
+
     create_hitboxes();
+    grid = create_grid();
 
     play_audio_by_name("start", -1);
     engine_run(update, draw, event_handler, game);
 
+    if (lockstep != NULL) {
+        lockstep_destroy(lockstep);
+        transport->close(transport);
+    }
+    destroy_mesh(grid);
     destroy_all_objects();
     destroy_all_textures();
     destroy_all_templates();
@@ -53,8 +75,45 @@ static void create_hitboxes() {
     }
 }
 
+static Mesh *create_grid() {
+    Mesh *mesh = create_mesh();
+    for (int i = 0; i < 4; i++) {
+        mesh_add_line(mesh, 0, i * TILE_SIZE, WIN_W, i * TILE_SIZE, (Color){66, 50, 166, 255}, 5);
+    }
+    for (int i = 0; i < 4; i++) {
+        mesh_add_line(mesh, i * TILE_SIZE, 0, i * TILE_SIZE, WIN_H, (Color){66, 50, 166, 255}, 5);
+    }
+    return mesh;
+}
+
+static void apply_command(void *_game, int player, const Command *command) {
+    Game *game = _game;
+    if (!game_apply_command(game, player + 1, command)) return;
+    if (command->type == COMMAND_PLAY) {
+        char name[20];
+        sprintf(name, "hitbox_%d_%d", command->x, command->y);
+        play_audio_by_name("click", -1);
+        destroy_object_by_name(name);
+    } else {
+        destroy_all_objects();
+        create_hitboxes();
+    }
+    manual_update();
+}
+
+static Uint32 checksum(void *game) {
+    return game_checksum(game);
+}
+
 void update(void *_game) {
     Game *game = _game;
+    if (lockstep != NULL) {
+        lockstep_update(lockstep);
+        if (lockstep->desync) {
+            fprintf(stderr, "[GAME] Desync detected at tick %u\n", lockstep->desync_tick);
+            exit(1);
+        }
+    }
     game->winner = check_winner(game);
 }
 
@@ -62,12 +121,7 @@ void draw(void *_game) {
     Game *game = _game;
     if (game->winner == 0) {
         //draw grid
-        for (int i = 0; i < 4; i++) {
-            draw_line_thick(0, i * TILE_SIZE, WIN_W, i * TILE_SIZE, (Color){66, 50, 166, 255}, 5);
-        }
-        for (int i = 0; i < 4; i++) {
-            draw_line_thick(i * TILE_SIZE, 0, i * TILE_SIZE, WIN_H, (Color){66, 50, 166, 255}, 5);
-        }
+        draw_mesh(grid, 0, 0);
         //draw X and O
         for (int i = 0; i < 3; i++) {
             for (int j = 0; j < 3; j++) {
@@ -94,27 +148,29 @@ void draw(void *_game) {
 void event_handler(SDL_Event event, void *_game) {
     Game *game = _game;
     switch (event.type) {
-        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONDOWN: {
+            Command command = {COMMAND_RESET, 0, 0};
             if (game->winner == 0) {
                 int x, y;
                 get_mouse_position(&x, &y);
-                int i = x / TILE_SIZE;
-                int j = y / TILE_SIZE;
-                char name[10];
-                sprintf(name, "hitbox_%d_%d", i, j);
-                if (object_is_hovered_by_name(name)) {
-                    play_audio_by_name("click", -1);
-                    game->matrix[i][j] = game->current_player;
-                    game->current_player = game->current_player == 1 ? 2 : 1;
-                    game->turn++;
-                    destroy_object_by_name(name);
-                    manual_update();
-                }
+                command = (Command){COMMAND_PLAY, x / TILE_SIZE, y / TILE_SIZE};
+            }
+            // Online, the command is applied by every player on the same tick
+            if (lockstep != NULL) {
+                lockstep_set_input(lockstep, command);
             } else {
-                destroy_all_objects();
-                init_game(game);
-                create_hitboxes();
+                apply_command(game, game->current_player - 1, &command);
+            }
+            break;
+        }
+        case SDL_KEYDOWN:
+            // Quick save and quick load, hot-seat only
+            if (lockstep != NULL) break;
+            if (event.key.keysym.sym == SDLK_F5) {
+                save_game(SAVE_FILE, game, sizeof(Game));
+            } else if (event.key.keysym.sym == SDLK_F9 && load_game(SAVE_FILE, game, sizeof(Game))) {
                 manual_update();
             }
+            break;
     }
 }
\ No newline at end of file
@@ -45,4 +45,48 @@ int check_winner(Game *game) {
         return -1;
     }
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * Apply a command of a player
+ * \param game The game structure
+ * \param player The player sending the command (1 or 2)
+ * \param command The command, COMMAND_PLAY on the cell (x, y) or COMMAND_RESET
+ * \return True if the command changed the game, false if it is not allowed
+ * \note Only depends on the game and the command, so every player of a lockstep session gets the same game
+ */
+bool game_apply_command(Game *game, int player, const Command *command) {
+    switch (command->type) {
+        case COMMAND_PLAY:
+            if (game->winner != 0 || player != game->current_player) return false;
+            if (command->x >= MAP_W || command->y >= MAP_H || game->matrix[command->x][command->y] != 0) return false;
+            game->matrix[command->x][command->y] = player;
+            game->current_player = player == 1 ? 2 : 1;
+            game->turn++;
+            game->winner = check_winner(game);
+            return true;
+        case COMMAND_RESET:
+            if (game->winner == 0) return false;
+            init_game(game);
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Hash the game state (FNV-1a)
+ * \param game The game structure
+ * \return The checksum of the game
+ */
+Uint32 game_checksum(Game *game) {
+    Uint32 hash = 2166136261u;
+    for (int i = 0; i < MAP_H; i++) {
+        for (int j = 0; j < MAP_W; j++) {
+            hash = (hash ^ (Uint32)game->matrix[i][j]) * 16777619u;
+        }
+    }
+    hash = (hash ^ (Uint32)game->current_player) * 16777619u;
+    hash = (hash ^ (Uint32)game->winner) * 16777619u;
+    hash = (hash ^ (Uint32)game->turn) * 16777619u;
+    return hash;
+}
@@ -0,0 +1,430 @@
+#include "lockstep.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET Socket;
+#define SOCKET_INVALID INVALID_SOCKET
+#define socket_close closesocket
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+typedef int Socket;
+#define SOCKET_INVALID -1
+#define socket_close close
+#endif
+
+#define LOOPBACK_QUEUE_SIZE 256
+#define PACKET_MAGIC 'L'
+#define PACKET_HEADER_SIZE 19
+#define COMMAND_SIZE 3
+#define NO_CHECKSUM 0xFFFFFFFF
+
+/**
+ * UDP transport data
+ * \param socket The non-blocking socket
+ * \param peer The address of the other player
+ */
+typedef struct _UdpTransport {
+    Socket socket;
+    struct sockaddr_in peer;
+} UdpTransport;
+
+/**
+ * Loopback datagram
+ * \param size The size of the datagram
+ * \param data The content of the datagram
+ */
+typedef struct _LoopbackPacket {
+    int size;
+    Uint8 data[LOCKSTEP_PACKET_SIZE];
+} LoopbackPacket;
+
+/**
+ * Loopback link (two datagram queues shared by both ends)
+ * \param queues The datagrams sent to each end (ring buffers)
+ * \param heads The index of the next datagram to receive of each queue
+ * \param counts The number of datagrams of each queue
+ * \param drop_percent The percentage of datagrams dropped
+ * \param seed The state of the random generator dropping datagrams
+ * \param refcount The number of open ends
+ */
+typedef struct _LoopbackLink {
+    LoopbackPacket queues[2][LOOPBACK_QUEUE_SIZE];
+    int heads[2];
+    int counts[2];
+    int drop_percent;
+    Uint32 seed;
+    int refcount;
+} LoopbackLink;
+
+/**
+ * Loopback transport data
+ * \param link The shared link
+ * \param side The end of the link (0 or 1)
+ */
+typedef struct _LoopbackTransport {
+    LoopbackLink *link;
+    int side;
+} LoopbackTransport;
+
+/***********************************************
+ * Transport functions
+ ***********************************************/
+
+static void _udp_send(Transport *transport, const void *data, int size) {
+    UdpTransport *udp = (UdpTransport *)transport->data;
+    sendto(udp->socket, (const char *)data, size, 0, (struct sockaddr *)&udp->peer, sizeof(udp->peer));
+}
+
+static int _udp_receive(Transport *transport, void *buffer, int size) {
+    UdpTransport *udp = (UdpTransport *)transport->data;
+    for (;;) {
+        struct sockaddr_in from;
+        socklen_t from_size = sizeof(from);
+        int received = recvfrom(udp->socket, (char *)buffer, size, 0, (struct sockaddr *)&from, &from_size);
+        if (received <= 0) return 0;
+        // Datagrams from other hosts are ignored
+        if (from.sin_addr.s_addr == udp->peer.sin_addr.s_addr && from.sin_port == udp->peer.sin_port) return received;
+    }
+}
+
+static void _udp_close(Transport *transport) {
+    UdpTransport *udp = (UdpTransport *)transport->data;
+    socket_close(udp->socket);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    free(udp);
+    free(transport);
+}
+
+/**
+ * Opens a UDP transport
+ * \param local_port The port to receive datagrams on
+ * \param peer_host The host name or address of the other player
+ * \param peer_port The port of the other player
+ * \return The transport
+ */
+Transport *transport_udp_open(Uint16 local_port, const char *peer_host, Uint16 peer_port) {
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        fprintf(stderr, "[LOCKSTEP] Failed to initialize Winsock\n");
+        exit(1);
+    }
+#endif
+    Transport *transport = (Transport *)malloc(sizeof(Transport));
+    UdpTransport *udp = (UdpTransport *)malloc(sizeof(UdpTransport));
+    if (transport == NULL || udp == NULL) {
+        fprintf(stderr, "[LOCKSTEP] Failed to allocate memory for transport\n");
+        exit(1);
+    }
+
+    struct addrinfo hints, *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(peer_host, NULL, &hints, &result) != 0) {
+        fprintf(stderr, "[LOCKSTEP] Failed to resolve host: %s\n", peer_host);
+        exit(1);
+    }
+    memcpy(&udp->peer, result->ai_addr, sizeof(udp->peer));
+    udp->peer.sin_port = htons(peer_port);
+    freeaddrinfo(result);
+
+    udp->socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (udp->socket == SOCKET_INVALID) {
+        fprintf(stderr, "[LOCKSTEP] Failed to create socket\n");
+        exit(1);
+    }
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(local_port);
+    if (bind(udp->socket, (struct sockaddr *)&local, sizeof(local)) != 0) {
+        fprintf(stderr, "[LOCKSTEP] Failed to bind port %d\n", local_port);
+        exit(1);
+    }
+#ifdef _WIN32
+    u_long non_blocking = 1;
+    ioctlsocket(udp->socket, FIONBIO, &non_blocking);
+#else
+    fcntl(udp->socket, F_SETFL, fcntl(udp->socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    transport->send = _udp_send;
+    transport->receive = _udp_receive;
+    transport->close = _udp_close;
+    transport->data = udp;
+    return transport;
+}
+
+static void _loopback_send(Transport *transport, const void *data, int size) {
+    LoopbackTransport *end = (LoopbackTransport *)transport->data;
+    LoopbackLink *link = end->link;
+    int queue = 1 - end->side;
+    if (size > LOCKSTEP_PACKET_SIZE || link->counts[queue] == LOOPBACK_QUEUE_SIZE) return;
+    if (link->drop_percent > 0) {
+        link->seed ^= link->seed << 13;
+        link->seed ^= link->seed >> 17;
+        link->seed ^= link->seed << 5;
+        if ((int)(link->seed % 100) < link->drop_percent) return;
+    }
+    LoopbackPacket *packet = &link->queues[queue][(link->heads[queue] + link->counts[queue]) % LOOPBACK_QUEUE_SIZE];
+    packet->size = size;
+    memcpy(packet->data, data, size);
+    link->counts[queue]++;
+}
+
+static int _loopback_receive(Transport *transport, void *buffer, int size) {
+    LoopbackTransport *end = (LoopbackTransport *)transport->data;
+    LoopbackLink *link = end->link;
+    int queue = end->side;
+    if (link->counts[queue] == 0) return 0;
+    LoopbackPacket *packet = &link->queues[queue][link->heads[queue]];
+    link->heads[queue] = (link->heads[queue] + 1) % LOOPBACK_QUEUE_SIZE;
+    link->counts[queue]--;
+    int received = packet->size < size ? packet->size : size;
+    memcpy(buffer, packet->data, received);
+    return received;
+}
+
+static void _loopback_close(Transport *transport) {
+    LoopbackTransport *end = (LoopbackTransport *)transport->data;
+    if (--end->link->refcount == 0) free(end->link);
+    free(end);
+    free(transport);
+}
+
+/**
+ * Creates the two ends of an in-process transport
+ * \param first The variable to store the first end
+ * \param second The variable to store the second end
+ * \param drop_percent The percentage of datagrams dropped, to test packet loss
+ * \note Both ends are closed separately, datagrams are delivered in order
+ */
+void transport_loopback_pair(Transport **first, Transport **second, int drop_percent) {
+    LoopbackLink *link = (LoopbackLink *)calloc(1, sizeof(LoopbackLink));
+    if (link == NULL) {
+        fprintf(stderr, "[LOCKSTEP] Failed to allocate memory for loopback link\n");
+        exit(1);
+    }
+    link->drop_percent = drop_percent;
+    link->seed = 0x9E3779B9;
+    link->refcount = 2;
+
+    Transport **ends[2] = {first, second};
+    for (int i = 0; i < 2; i++) {
+        Transport *transport = (Transport *)malloc(sizeof(Transport));
+        LoopbackTransport *end = (LoopbackTransport *)malloc(sizeof(LoopbackTransport));
+        if (transport == NULL || end == NULL) {
+            fprintf(stderr, "[LOCKSTEP] Failed to allocate memory for transport\n");
+            exit(1);
+        }
+        end->link = link;
+        end->side = i;
+        transport->send = _loopback_send;
+        transport->receive = _loopback_receive;
+        transport->close = _loopback_close;
+        transport->data = end;
+        *ends[i] = transport;
+    }
+}
+
+/***********************************************
+ * Lockstep functions
+ ***********************************************/
+
+static void _write_u32(Uint8 *buffer, Uint32 value) {
+    buffer[0] = value;
+    buffer[1] = value >> 8;
+    buffer[2] = value >> 16;
+    buffer[3] = value >> 24;
+}
+
+static Uint32 _read_u32(const Uint8 *buffer) {
+    return buffer[0] | buffer[1] << 8 | buffer[2] << 16 | (Uint32)buffer[3] << 24;
+}
+
+/**
+ * Creates a lockstep session
+ * \param transport The transport to the other player
+ * \param local_player The index of the local player (0 or 1)
+ * \param input_delay The number of ticks between an input and its simulation, up to `LOCKSTEP_MAX_DELAY`
+ * \param apply The function applying commands to the state
+ * \param checksum The function hashing the state
+ * \param state The simulation state
+ * \return The lockstep session
+ * \note Both players must use the same input delay, the first `input_delay` ticks have no input
+ */
+Lockstep *lockstep_create(Transport *transport, int local_player, int input_delay, LockstepApply apply, LockstepChecksum checksum, void *state) {
+    if (local_player < 0 || local_player >= LOCKSTEP_PLAYERS || input_delay < 0 || input_delay > LOCKSTEP_MAX_DELAY) {
+        fprintf(stderr, "[LOCKSTEP] Invalid player %d or input delay %d\n", local_player, input_delay);
+        exit(1);
+    }
+    Lockstep *lockstep = (Lockstep *)calloc(1, sizeof(Lockstep));
+    if (lockstep == NULL) {
+        fprintf(stderr, "[LOCKSTEP] Failed to allocate memory for lockstep\n");
+        exit(1);
+    }
+    lockstep->transport = transport;
+    lockstep->local_player = local_player;
+    lockstep->input_delay = input_delay;
+    lockstep->input_tick = input_delay;
+    lockstep->remote_tick = input_delay;
+    lockstep->remote_ack = input_delay;
+    lockstep->apply = apply;
+    lockstep->checksum = checksum;
+    lockstep->state = state;
+    return lockstep;
+}
+
+/**
+ * Sets the local input, scheduled for the tick `input_delay` ticks after the current one
+ * \param lockstep The lockstep session
+ * \param command The command
+ * \note A player has one command per tick, a later input before the next tick replaces the pending one
+ */
+void lockstep_set_input(Lockstep *lockstep, Command command) {
+    lockstep->input = command;
+}
+
+/**
+ * Compares the checksum of the other player with the local one
+ * \param lockstep The lockstep session
+ * \note The comparison waits until the local simulation reaches the tick of the checksum
+ */
+static void _check_remote_checksum(Lockstep *lockstep) {
+    if (!lockstep->remote_checksum_pending || lockstep->remote_checksum_tick >= lockstep->tick) return;
+    lockstep->remote_checksum_pending = false;
+    if (lockstep->tick - lockstep->remote_checksum_tick > LOCKSTEP_WINDOW) return;
+    Uint32 local = lockstep->checksums[lockstep->remote_checksum_tick % LOCKSTEP_WINDOW];
+    if (local != lockstep->remote_checksum && !lockstep->desync) {
+        lockstep->desync = true;
+        lockstep->desync_tick = lockstep->remote_checksum_tick;
+    }
+}
+
+/**
+ * Reads a datagram of the other player
+ * \param lockstep The lockstep session
+ * \param packet The datagram
+ * \param size The size of the datagram
+ * \note Commands are only kept when they extend the contiguous commands received, every datagram repeats the commands not acknowledged yet
+ */
+static void _read_packet(Lockstep *lockstep, const Uint8 *packet, int size) {
+    if (size < PACKET_HEADER_SIZE || packet[0] != PACKET_MAGIC || packet[1] != 1 - lockstep->local_player) return;
+    int count = packet[18];
+    if (size < PACKET_HEADER_SIZE + count * COMMAND_SIZE) return;
+
+    Uint32 ack = _read_u32(packet + 2);
+    if (ack > lockstep->remote_ack && ack <= lockstep->input_tick) lockstep->remote_ack = ack;
+
+    Uint32 checksum_tick = _read_u32(packet + 6);
+    if (checksum_tick != NO_CHECKSUM && !lockstep->remote_checksum_pending) {
+        lockstep->remote_checksum = _read_u32(packet + 10);
+        lockstep->remote_checksum_tick = checksum_tick;
+        lockstep->remote_checksum_pending = true;
+        _check_remote_checksum(lockstep);
+    }
+
+    Uint32 first_tick = _read_u32(packet + 14);
+    int remote = 1 - lockstep->local_player;
+    const Uint8 *data = packet + PACKET_HEADER_SIZE;
+    for (int i = 0; i < count; i++, data += COMMAND_SIZE) {
+        Uint32 tick = first_tick + i;
+        if (tick < lockstep->remote_tick) continue;
+        if (tick > lockstep->remote_tick || tick >= lockstep->tick + LOCKSTEP_WINDOW) break;
+        lockstep->commands[tick % LOCKSTEP_WINDOW][remote] = (Command){data[0], data[1], data[2]};
+        lockstep->remote_tick++;
+    }
+}
+
+/**
+ * Sends the local commands not acknowledged yet and the checksum of the last tick
+ * \param lockstep The lockstep session
+ */
+static void _send_packet(Lockstep *lockstep) {
+    Uint8 packet[PACKET_HEADER_SIZE + LOCKSTEP_WINDOW * COMMAND_SIZE];
+    Uint32 first_tick = lockstep->remote_ack;
+    if (lockstep->input_tick - first_tick > LOCKSTEP_WINDOW) first_tick = lockstep->input_tick - LOCKSTEP_WINDOW;
+    int count = lockstep->input_tick - first_tick;
+
+    packet[0] = PACKET_MAGIC;
+    packet[1] = lockstep->local_player;
+    _write_u32(packet + 2, lockstep->remote_tick);
+    if (lockstep->tick > 0) {
+        _write_u32(packet + 6, lockstep->tick - 1);
+        _write_u32(packet + 10, lockstep->checksums[(lockstep->tick - 1) % LOCKSTEP_WINDOW]);
+    } else {
+        _write_u32(packet + 6, NO_CHECKSUM);
+        _write_u32(packet + 10, 0);
+    }
+    _write_u32(packet + 14, first_tick);
+    packet[18] = count;
+
+    Uint8 *data = packet + PACKET_HEADER_SIZE;
+    for (int i = 0; i < count; i++, data += COMMAND_SIZE) {
+        Command *command = &lockstep->commands[(first_tick + i) % LOCKSTEP_WINDOW][lockstep->local_player];
+        data[0] = command->type;
+        data[1] = command->x;
+        data[2] = command->y;
+    }
+
+    int size = PACKET_HEADER_SIZE + count * COMMAND_SIZE;
+    lockstep->transport->send(lockstep->transport, packet, size);
+    lockstep->bytes_sent += size;
+    lockstep->packets_sent++;
+}
+
+/**
+ * Updates a lockstep session, to call once per frame
+ * \param lockstep The lockstep session
+ * \return The number of simulated ticks, 0 while the commands of the other player are missing
+ * \note Receives the datagrams, schedules the pending input, simulates at most one tick and sends the local commands
+ * \note The commands of a tick are applied in player order, then the state is hashed to detect desyncs
+ */
+int lockstep_update(Lockstep *lockstep) {
+    Uint8 packet[LOCKSTEP_PACKET_SIZE];
+    int size;
+    while ((size = lockstep->transport->receive(lockstep->transport, packet, sizeof(packet))) > 0) {
+        lockstep->bytes_received += size;
+        lockstep->packets_received++;
+        _read_packet(lockstep, packet, size);
+    }
+
+    if (lockstep->input_tick <= lockstep->tick + lockstep->input_delay) {
+        lockstep->commands[lockstep->input_tick % LOCKSTEP_WINDOW][lockstep->local_player] = lockstep->input;
+        lockstep->input = (Command){COMMAND_NONE, 0, 0};
+        lockstep->input_tick++;
+    }
+
+    int simulated = 0;
+    if (lockstep->tick < lockstep->remote_tick && lockstep->tick < lockstep->input_tick) {
+        Command *commands = lockstep->commands[lockstep->tick % LOCKSTEP_WINDOW];
+        for (int player = 0; player < LOCKSTEP_PLAYERS; player++) {
+            if (commands[player].type != COMMAND_NONE) lockstep->apply(lockstep->state, player, &commands[player]);
+        }
+        lockstep->checksums[lockstep->tick % LOCKSTEP_WINDOW] = lockstep->checksum(lockstep->state);
+        lockstep->tick++;
+        _check_remote_checksum(lockstep);
+        simulated = 1;
+    }
+
+    _send_packet(lockstep);
+    return simulated;
+}
+
+/**
+ * Destroys a lockstep session
+ * \param lockstep The lockstep session
+ * \note The transport is not closed
+ */
+void lockstep_destroy(Lockstep *lockstep) {
+    free(lockstep);
+}
@@ -0,0 +1,347 @@
+#include "replay.h"
+
+// Shortest run of unchanged bytes ending a literal
+#define REPLAY_MIN_RUN 4
+
+/***********************************************
+ * Encoding functions
+ ***********************************************/
+
+/**
+ * Grows a buffer to hold at least a size
+ * \param buffer The buffer
+ * \param capacity The capacity of the buffer
+ * \param size The size to hold
+ */
+static void _reserve(Uint8 **buffer, size_t *capacity, size_t size) {
+    if (size <= *capacity) return;
+    size_t new_capacity = *capacity > 0 ? *capacity : 256;
+    while (new_capacity < size) new_capacity *= 2;
+    Uint8 *new_buffer = (Uint8 *)realloc(*buffer, new_capacity);
+    if (new_buffer == NULL) {
+        fprintf(stderr, "[REPLAY] Failed to allocate memory for replay\n");
+        exit(1);
+    }
+    *buffer = new_buffer;
+    *capacity = new_capacity;
+}
+
+static Uint8 *_write_varint(Uint8 *out, size_t value) {
+    while (value >= 0x80) {
+        *out++ = (Uint8)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (Uint8)value;
+    return out;
+}
+
+static const Uint8 *_read_varint(const Uint8 *in, const Uint8 *end, size_t *value) {
+    *value = 0;
+    for (int shift = 0; in < end && shift < 35; shift += 7) {
+        Uint8 byte = *in++;
+        *value |= (size_t)(byte & 0x7F) << shift;
+        if (byte < 0x80) return in;
+    }
+    return NULL;
+}
+
+/**
+ * Encodes a save as the XOR with the previous one, in pairs of varints (unchanged bytes, changed bytes) followed by the changed bytes
+ * \param out The output, at least `2 * size + 16` bytes
+ * \param previous The previous save, NULL for a keyframe
+ * \param previous_size The size of the previous save, bytes past it are compared with 0
+ * \param save The save
+ * \param size The size of the save
+ * \return The end of the output
+ */
+static Uint8 *_encode_delta(Uint8 *out, const Uint8 *previous, size_t previous_size, const Uint8 *save, size_t size) {
+    size_t common = previous != NULL && previous_size < size ? previous_size : (previous != NULL ? size : 0);
+    size_t pos = 0;
+    while (pos < size) {
+        // Unchanged bytes, compared 8 at a time where both saves have them
+        size_t start = pos;
+        while (pos + 8 <= common) {
+            Uint64 a, b;
+            memcpy(&a, previous + pos, 8);
+            memcpy(&b, save + pos, 8);
+            if (a != b) break;
+            pos += 8;
+        }
+        while (pos < size && save[pos] == (pos < common ? previous[pos] : 0)) pos++;
+        size_t run = pos - start;
+
+        // Changed bytes, until enough unchanged bytes follow
+        size_t literal = pos;
+        size_t unchanged = 0;
+        while (pos < size && unchanged < REPLAY_MIN_RUN) {
+            unchanged = save[pos] == (pos < common ? previous[pos] : 0) ? unchanged + 1 : 0;
+            pos++;
+        }
+        if (unchanged == REPLAY_MIN_RUN) pos -= REPLAY_MIN_RUN;
+        else if (pos == size) pos -= unchanged;
+
+        out = _write_varint(out, run);
+        out = _write_varint(out, pos - literal);
+        for (size_t i = literal; i < pos; i++) {
+            *out++ = save[i] ^ (i < common ? previous[i] : 0);
+        }
+    }
+    return out;
+}
+
+/**
+ * Decodes a tick in the save of the replay, which must hold the previous tick unless the tick is a keyframe
+ * \param replay The replay
+ * \param tick The tick
+ * \return False if the data of the tick is corrupted
+ */
+static bool _decode_tick(Replay *replay, Uint32 tick) {
+    ReplayTick *current = &replay->ticks[tick];
+    if (tick % replay->keyframe_interval == 0) replay->save_size = 0;
+    _reserve(&replay->save, &replay->save_capacity, current->save_size);
+    if (current->save_size > replay->save_size) memset(replay->save + replay->save_size, 0, current->save_size - replay->save_size);
+    replay->save_size = current->save_size;
+
+    const Uint8 *in = replay->data + current->offset;
+    const Uint8 *end = in + current->size;
+    size_t pos = 0;
+    while (in < end) {
+        size_t run, literal;
+        in = _read_varint(in, end, &run);
+        if (in == NULL) return false;
+        in = _read_varint(in, end, &literal);
+        if (in == NULL || pos + run + literal > replay->save_size || (size_t)(end - in) < literal) return false;
+        pos += run;
+        for (size_t i = 0; i < literal; i++) {
+            replay->save[pos + i] ^= in[i];
+        }
+        pos += literal;
+        in += literal;
+    }
+    if (pos != replay->save_size) return false;
+    replay->save_tick = tick;
+    return true;
+}
+
+/**
+ * Decodes the save of a tick, from the save already decoded when it is in the same keyframe interval
+ * \param replay The replay
+ * \param tick The tick
+ * \return False if the data is corrupted
+ */
+static bool _decode_to(Replay *replay, Uint32 tick) {
+    Uint32 keyframe = tick - tick % replay->keyframe_interval;
+    Uint32 first = keyframe;
+    if (replay->save_tick >= keyframe && replay->save_tick <= tick) first = replay->save_tick + 1;
+    for (Uint32 current = first; current <= tick; current++) {
+        if (!_decode_tick(replay, current)) {
+            replay->save_tick = -1;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks that the data of a tick decodes to a save of its size
+ * \param tick The tick
+ * \param data The data of the replay
+ * \param state_size The size of the game state
+ * \return False if the data of the tick is corrupted
+ * \note The runs and literals must cover the save exactly, so the size of the save is bounded by the data
+ */
+static bool _check_tick(const ReplayTick *tick, const Uint8 *data, size_t state_size) {
+    if (tick->save_size < sizeof(SaveHeader) + state_size) return false;
+    const Uint8 *in = data + tick->offset;
+    const Uint8 *end = in + tick->size;
+    size_t pos = 0;
+    while (in < end) {
+        size_t run, literal;
+        in = _read_varint(in, end, &run);
+        if (in == NULL) return false;
+        in = _read_varint(in, end, &literal);
+        if (in == NULL || run > tick->save_size - pos || literal > tick->save_size - pos - run || (size_t)(end - in) < literal) return false;
+        pos += run + literal;
+        in += literal;
+    }
+    return pos == tick->save_size;
+}
+
+/***********************************************
+ * Replay functions
+ ***********************************************/
+
+/**
+ * Creates an empty replay
+ * \param state The game state
+ * \param state_size The size of the game state
+ * \param keyframe_interval The number of ticks between keyframes, seeking decodes up to this number of ticks
+ * \return The replay
+ */
+Replay *replay_create(void *state, size_t state_size, int keyframe_interval) {
+    if (keyframe_interval < 1) {
+        fprintf(stderr, "[REPLAY] Invalid keyframe interval: %d\n", keyframe_interval);
+        exit(1);
+    }
+    Replay *replay = (Replay *)calloc(1, sizeof(Replay));
+    if (replay == NULL) {
+        fprintf(stderr, "[REPLAY] Failed to allocate memory for replay\n");
+        exit(1);
+    }
+    replay->state = state;
+    replay->state_size = state_size;
+    replay->keyframe_interval = keyframe_interval;
+    replay->save_tick = -1;
+    return replay;
+}
+
+/**
+ * Records the game state and the objects as the next tick
+ * \param replay The replay
+ * \note Ticks are always added after the last one, even after seeking
+ */
+void replay_record(Replay *replay) {
+    size_t size;
+    Uint8 *save = save_game_to_memory(replay->state, replay->state_size, &size);
+    bool keyframe = replay->nb_ticks % replay->keyframe_interval == 0;
+    // The delta is encoded against the last tick
+    if (!keyframe && replay->save_tick != (Sint64)replay->nb_ticks - 1 && !_decode_to(replay, replay->nb_ticks - 1)) {
+        fprintf(stderr, "[REPLAY] Failed to decode the last tick to record the next one\n");
+        exit(1);
+    }
+
+    if (replay->nb_ticks == replay->ticks_capacity) {
+        replay->ticks_capacity = replay->ticks_capacity > 0 ? replay->ticks_capacity * 2 : 256;
+        replay->ticks = (ReplayTick *)realloc(replay->ticks, sizeof(ReplayTick) * replay->ticks_capacity);
+        if (replay->ticks == NULL) {
+            fprintf(stderr, "[REPLAY] Failed to allocate memory for replay\n");
+            exit(1);
+        }
+    }
+    _reserve(&replay->data, &replay->data_capacity, replay->data_size + size * 2 + 16);
+    Uint8 *start = replay->data + replay->data_size;
+    Uint8 *end = _encode_delta(start, keyframe ? NULL : replay->save, replay->save_size, save, size);
+    replay->ticks[replay->nb_ticks] = (ReplayTick){replay->data_size, end - start, size};
+    replay->data_size += end - start;
+
+    // The save of the tick is kept to encode the next one
+    free(replay->save);
+    replay->save = save;
+    replay->save_size = size;
+    replay->save_capacity = size;
+    replay->save_tick = replay->nb_ticks;
+    replay->nb_ticks++;
+}
+
+/**
+ * Restores the game state and the objects of a tick
+ * \param replay The replay
+ * \param tick The tick
+ * \return False if the tick was not recorded or cannot be loaded
+ * \note Decodes from the keyframe of the tick, or from the last decoded tick when seeking forward in the same keyframe interval
+ */
+bool replay_seek(Replay *replay, Uint32 tick) {
+    if (tick >= replay->nb_ticks || !_decode_to(replay, tick)) return false;
+    // Loading replaces the offsets of the save, the decoded save is kept for the next ticks
+    _reserve(&replay->scratch, &replay->scratch_capacity, replay->save_size);
+    memcpy(replay->scratch, replay->save, replay->save_size);
+    return load_game_from_memory(replay->scratch, replay->save_size, replay->state, replay->state_size);
+}
+
+/**
+ * Saves a replay in a file
+ * \param replay The replay
+ * \param filename The path to the replay file
+ * \note The file is built in memory and written at once
+ */
+void replay_save(Replay *replay, char *filename) {
+    size_t ticks_size = sizeof(ReplayTick) * replay->nb_ticks;
+    size_t size = sizeof(ReplayHeader) + ticks_size + replay->data_size;
+    Uint8 *buffer = (Uint8 *)malloc(size);
+    if (buffer == NULL) {
+        fprintf(stderr, "[REPLAY] Failed to allocate memory for replay\n");
+        exit(1);
+    }
+    ReplayHeader *header = (ReplayHeader *)buffer;
+    memcpy(header->magic, "TWRP", 4);
+    header->version = REPLAY_VERSION;
+    header->keyframe_interval = replay->keyframe_interval;
+    header->state_size = replay->state_size;
+    header->nb_ticks = replay->nb_ticks;
+    header->data_size = replay->data_size;
+    memcpy(buffer + sizeof(ReplayHeader), replay->ticks, ticks_size);
+    memcpy(buffer + sizeof(ReplayHeader) + ticks_size, replay->data, replay->data_size);
+
+    SDL_RWops *file = SDL_RWFromFile(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "[REPLAY] Failed to open replay file: %s\n", SDL_GetError());
+        exit(1);
+    }
+    if (SDL_RWwrite(file, buffer, size, 1) != 1) {
+        fprintf(stderr, "[REPLAY] Failed to write replay file: %s\n", SDL_GetError());
+        exit(1);
+    }
+    SDL_RWclose(file);
+    free(buffer);
+}
+
+/**
+ * Loads a replay from a file
+ * \param filename The path to the replay file
+ * \param state The game state
+ * \param state_size The size of the game state
+ * \return The replay, NULL if there is no replay, if it was made by another version or game or if it is corrupted
+ * \note The data of every tick is checked, seeking a tick of a loaded replay only fails if the save cannot be loaded
+ */
+Replay *replay_load(char *filename, void *state, size_t state_size) {
+    size_t size;
+    Uint8 *buffer = (Uint8 *)SDL_LoadFile(filename, &size);
+    if (buffer == NULL) return NULL;
+
+    ReplayHeader *header = (ReplayHeader *)buffer;
+    size_t ticks_size = size >= sizeof(ReplayHeader) ? sizeof(ReplayTick) * (size_t)header->nb_ticks : 0;
+    if (size < sizeof(ReplayHeader) || memcmp(header->magic, "TWRP", 4) != 0 || header->version != REPLAY_VERSION
+        || header->state_size != state_size || header->keyframe_interval == 0 || header->keyframe_interval > SDL_MAX_SINT32
+        || size != sizeof(ReplayHeader) + ticks_size + header->data_size) {
+        fprintf(stderr, "[REPLAY] Incompatible replay file: %s\n", filename);
+        SDL_free(buffer);
+        return NULL;
+    }
+    ReplayTick *ticks = (ReplayTick *)(buffer + sizeof(ReplayHeader));
+    const Uint8 *data = buffer + sizeof(ReplayHeader) + ticks_size;
+    for (Uint32 i = 0; i < header->nb_ticks; i++) {
+        if ((size_t)ticks[i].offset + ticks[i].size > header->data_size || !_check_tick(&ticks[i], data, state_size)) {
+            fprintf(stderr, "[REPLAY] Corrupted replay file: %s\n", filename);
+            SDL_free(buffer);
+            return NULL;
+        }
+    }
+
+    Replay *replay = replay_create(state, state_size, header->keyframe_interval);
+    replay->ticks_capacity = header->nb_ticks;
+    replay->nb_ticks = header->nb_ticks;
+    replay->ticks = (ReplayTick *)malloc(ticks_size + 1);
+    replay->data_capacity = header->data_size;
+    replay->data_size = header->data_size;
+    replay->data = (Uint8 *)malloc(header->data_size + 1);
+    if (replay->ticks == NULL || replay->data == NULL) {
+        fprintf(stderr, "[REPLAY] Failed to allocate memory for replay\n");
+        exit(1);
+    }
+    memcpy(replay->ticks, ticks, ticks_size);
+    memcpy(replay->data, data, header->data_size);
+    SDL_free(buffer);
+    return replay;
+}
+
+/**
+ * Destroys a replay
+ * \param replay The replay
+ */
+void replay_destroy(Replay *replay) {
+    free(replay->ticks);
+    free(replay->data);
+    free(replay->save);
+    free(replay->scratch);
+    free(replay);
+}
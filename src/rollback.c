@@ -0,0 +1,160 @@
+#include "rollback.h"
+
+#define SNAPSHOT_ALIGN 16
+
+/***********************************************
+ * Rollback functions
+ ***********************************************/
+
+/**
+ * Creates a rollback session
+ * \param state The simulation state, contiguous and without pointers
+ * \param state_size The size of the state
+ * \param max_objects The maximum number of saved objects, 0 to leave the objects out of the snapshots
+ * \param max_frames The number of frames that can be rewound, up to `ROLLBACK_MAX_FRAMES`
+ * \param advance The function simulating a frame
+ * \return The rollback session
+ * \note The memory of every snapshot is allocated once, saving and loading only copy memory
+ */
+Rollback *rollback_create(void *state, size_t state_size, int max_objects, int max_frames, RollbackAdvance advance) {
+    if (max_frames < 1 || max_frames > ROLLBACK_MAX_FRAMES || max_objects < 0) {
+        fprintf(stderr, "[ROLLBACK] Invalid number of frames %d or objects %d\n", max_frames, max_objects);
+        exit(1);
+    }
+    Rollback *rollback = (Rollback *)calloc(1, sizeof(Rollback));
+    if (rollback == NULL) {
+        fprintf(stderr, "[ROLLBACK] Failed to allocate memory for rollback\n");
+        exit(1);
+    }
+    rollback->state = state;
+    rollback->state_size = state_size;
+    rollback->max_objects = max_objects;
+    rollback->max_frames = max_frames;
+    rollback->advance = advance;
+
+    size_t state_stride = (state_size + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+    size_t objects_stride = (sizeof(ObjectState) * max_objects + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+    rollback->memory = (Uint8 *)malloc((state_stride + objects_stride) * max_frames + 1);
+    if (rollback->memory == NULL) {
+        fprintf(stderr, "[ROLLBACK] Failed to allocate memory for snapshots\n");
+        exit(1);
+    }
+    Uint8 *memory = rollback->memory;
+    for (int i = 0; i < max_frames; i++) {
+        RollbackSnapshot *snapshot = &rollback->snapshots[i];
+        snapshot->frame = (Uint32)-1;
+        snapshot->nb_objects = 0;
+        snapshot->state = memory;
+        snapshot->objects = (ObjectState *)(memory + state_stride);
+        memory += state_stride + objects_stride;
+    }
+    return rollback;
+}
+
+/**
+ * Adds the input of a player for a frame
+ * \param rollback The rollback session
+ * \param player The index of the player
+ * \param frame The frame of the input
+ * \param command The input
+ * \return False if the player does not exist or if the frame is too old to be rewound or too far ahead
+ * \note An input contradicting the prediction of an already simulated frame rewinds the simulation at the next `rollback_advance_frame`
+ */
+bool rollback_add_input(Rollback *rollback, int player, Uint32 frame, Command command) {
+    if (player < 0 || player >= LOCKSTEP_PLAYERS) return false;
+    if (frame + rollback->max_frames < rollback->frame || frame >= rollback->frame + ROLLBACK_MAX_FRAMES) return false;
+    int slot = frame % ROLLBACK_INPUT_FRAMES;
+    if (rollback->confirmed[slot][player]) return true;
+    rollback->inputs[slot][player] = command;
+    rollback->confirmed[slot][player] = true;
+
+    // Predicted as COMMAND_NONE when the frame was simulated
+    if (frame < rollback->frame && command.type != COMMAND_NONE) {
+        if (!rollback->rollback_pending || frame < rollback->rollback_frame) rollback->rollback_frame = frame;
+        rollback->rollback_pending = true;
+    }
+    return true;
+}
+
+/**
+ * Saves the state and the objects as the snapshot of the next frame
+ * \param rollback The rollback session
+ */
+void rollback_save(Rollback *rollback) {
+    RollbackSnapshot *snapshot = &rollback->snapshots[rollback->frame % rollback->max_frames];
+    snapshot->frame = rollback->frame;
+    memcpy(snapshot->state, rollback->state, rollback->state_size);
+    if (rollback->max_objects > 0) {
+        snapshot->nb_objects = save_objects(snapshot->objects, rollback->max_objects);
+        if (snapshot->nb_objects < 0) {
+            fprintf(stderr, "[ROLLBACK] More than %d objects to save\n", rollback->max_objects);
+            exit(1);
+        }
+    }
+}
+
+/**
+ * Restores the state and the objects of a snapshot
+ * \param rollback The rollback session
+ * \param frame The frame of the snapshot, it becomes the next frame to simulate
+ * \return False if the snapshot of the frame was overwritten
+ */
+bool rollback_load(Rollback *rollback, Uint32 frame) {
+    RollbackSnapshot *snapshot = &rollback->snapshots[frame % rollback->max_frames];
+    if (snapshot->frame != frame) return false;
+    memcpy(rollback->state, snapshot->state, rollback->state_size);
+    if (rollback->max_objects > 0) restore_objects(snapshot->objects, snapshot->nb_objects);
+    rollback->frame = frame;
+    return true;
+}
+
+/**
+ * Simulates the next frame
+ * \param rollback The rollback session
+ */
+static void _simulate_frame(Rollback *rollback) {
+    int slot = rollback->frame % ROLLBACK_INPUT_FRAMES;
+    Command inputs[LOCKSTEP_PLAYERS];
+    for (int player = 0; player < LOCKSTEP_PLAYERS; player++) {
+        inputs[player] = rollback->confirmed[slot][player] ? rollback->inputs[slot][player] : (Command){COMMAND_NONE, 0, 0};
+    }
+    rollback_save(rollback);
+    rollback->advance(rollback->state, inputs);
+    rollback->frame++;
+}
+
+/**
+ * Simulates the next frame, first rewinding to the oldest mispredicted frame and simulating it again
+ * \param rollback The rollback session
+ * \return The number of simulated frames, resimulated frames included
+ */
+int rollback_advance_frame(Rollback *rollback) {
+    int simulated = 0;
+    if (rollback->rollback_pending) {
+        rollback->rollback_pending = false;
+        Uint32 frame = rollback->frame;
+        if (rollback_load(rollback, rollback->rollback_frame)) {
+            rollback->rollbacks++;
+            while (rollback->frame < frame) {
+                _simulate_frame(rollback);
+                simulated++;
+            }
+            rollback->resimulated_frames += simulated;
+        }
+    }
+    _simulate_frame(rollback);
+
+    // The slot of the frame leaving the window is reused for the last frame accepting inputs
+    int slot = (rollback->frame + ROLLBACK_MAX_FRAMES - 1) % ROLLBACK_INPUT_FRAMES;
+    memset(rollback->confirmed[slot], 0, sizeof(rollback->confirmed[slot]));
+    return simulated + 1;
+}
+
+/**
+ * Destroys a rollback session
+ * \param rollback The rollback session
+ */
+void rollback_destroy(Rollback *rollback) {
+    free(rollback->memory);
+    free(rollback);
+}
@@ -0,0 +1,310 @@
+#include "save.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define SAVE_ALIGN 16
+#define SAVE_BYTE_ORDER 0x01020304
+
+/**
+ * Saved texture (texture already written in the names of a save)
+ * \param texture The texture
+ * \param offset The offset of its name in the names
+ */
+typedef struct _SavedTexture {
+    Texture *texture;
+    Uint32 offset;
+} SavedTexture;
+
+/**
+ * Mapped file
+ * \param data The content of the file, writable without changing the file
+ * \param size The size of the file
+ * \param handles The handles of the mapping, only used on Windows
+ */
+typedef struct _MappedFile {
+    Uint8 *data;
+    size_t size;
+    void *handles[2];
+} MappedFile;
+
+/***********************************************
+ * Mapping functions
+ ***********************************************/
+
+/**
+ * Maps a file in memory, copy on write
+ * \param filename The path to the file
+ * \param mapped The variable to store the mapping
+ * \return False if the file cannot be mapped
+ */
+static bool _map_file(const char *filename, MappedFile *mapped) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (mapping == NULL) {
+        CloseHandle(file);
+        return false;
+    }
+    mapped->data = (Uint8 *)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (mapped->data == NULL) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    mapped->size = (size_t)size.QuadPart;
+    mapped->handles[0] = file;
+    mapped->handles[1] = mapping;
+#else
+    int file = open(filename, O_RDONLY);
+    if (file < 0) return false;
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0) {
+        close(file);
+        return false;
+    }
+    void *data = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) return false;
+    mapped->data = (Uint8 *)data;
+    mapped->size = info.st_size;
+#endif
+    return true;
+}
+
+/**
+ * Unmaps a file
+ * \param mapped The mapping
+ */
+static void _unmap_file(MappedFile *mapped) {
+#ifdef _WIN32
+    UnmapViewOfFile(mapped->data);
+    CloseHandle(mapped->handles[1]);
+    CloseHandle(mapped->handles[0]);
+#else
+    munmap(mapped->data, mapped->size);
+#endif
+}
+
+/***********************************************
+ * Save functions
+ ***********************************************/
+
+/**
+ * Serializes the game state and every object
+ * \param state The game state, contiguous and without pointers
+ * \param state_size The size of the game state
+ * \param size The variable to store the size of the save
+ * \return The save, to free
+ * \note Textures are saved by name and object data by offset in the game state
+ * \note Object data pointing outside of the game state is saved as NULL
+ */
+Uint8 *save_game_to_memory(const void *state, size_t state_size, size_t *size) {
+    int nb_objects = get_object_count();
+    size_t objects_offset = (sizeof(SaveHeader) + state_size + SAVE_ALIGN - 1) / SAVE_ALIGN * SAVE_ALIGN;
+    size_t strings_offset = objects_offset + sizeof(ObjectState) * nb_objects;
+
+    Uint8 *buffer = (Uint8 *)calloc(1, strings_offset);
+    if (buffer == NULL) {
+        fprintf(stderr, "[SAVE] Failed to allocate memory for save\n");
+        exit(1);
+    }
+    memcpy(buffer + sizeof(SaveHeader), state, state_size);
+    ObjectState *objects = (ObjectState *)(buffer + objects_offset);
+    save_objects(objects, nb_objects);
+
+    // Names of the objects and of their textures, each texture name is written once
+    SavedTexture *textures = NULL;
+    int nb_textures = 0;
+    size_t strings_size = 0;
+    for (int i = 0; i < nb_objects; i++) {
+        strings_size += strlen(objects[i].name) + 1;
+        Texture *texture = objects[i].object.texture;
+        if (texture == NULL) continue;
+        int j = 0;
+        while (j < nb_textures && textures[j].texture != texture) j++;
+        if (j < nb_textures) continue;
+        textures = (SavedTexture *)realloc(textures, sizeof(SavedTexture) * (nb_textures + 1));
+        if (textures == NULL) {
+            fprintf(stderr, "[SAVE] Failed to allocate memory for save\n");
+            exit(1);
+        }
+        textures[nb_textures++] = (SavedTexture){texture, 0};
+        const char *name = get_texture_name(texture);
+        if (name != NULL) strings_size += strlen(name) + 1;
+    }
+
+    buffer = (Uint8 *)realloc(buffer, strings_offset + strings_size);
+    if (buffer == NULL) {
+        fprintf(stderr, "[SAVE] Failed to allocate memory for save\n");
+        exit(1);
+    }
+    objects = (ObjectState *)(buffer + objects_offset);
+    char *strings = (char *)(buffer + strings_offset);
+    size_t offset = 0;
+    for (int i = 0; i < nb_textures; i++) {
+        const char *name = get_texture_name(textures[i].texture);
+        if (name == NULL) continue;
+        size_t length = strlen(name) + 1;
+        memcpy(strings + offset, name, length);
+        textures[i].offset = offset + 1;
+        offset += length;
+    }
+
+    // Pointers are replaced by offsets, 0 stands for NULL
+    const Uint8 *state_start = (const Uint8 *)state;
+    for (int i = 0; i < nb_objects; i++) {
+        ObjectState *current = &objects[i];
+        size_t length = strlen(current->name) + 1;
+        memcpy(strings + offset, current->name, length);
+        current->name = (const char *)(uintptr_t)offset;
+        offset += length;
+
+        Uint32 texture_offset = 0;
+        for (int j = 0; j < nb_textures && current->object.texture != NULL; j++) {
+            if (textures[j].texture == current->object.texture) {
+                texture_offset = textures[j].offset;
+                break;
+            }
+        }
+        current->object.texture = (Texture *)(uintptr_t)texture_offset;
+
+        const Uint8 *data = (const Uint8 *)current->object.data;
+        uintptr_t data_offset = data >= state_start && data < state_start + state_size ? (uintptr_t)(data - state_start) + 1 : 0;
+        current->object.data = (void *)data_offset;
+    }
+    free(textures);
+
+    SaveHeader *header = (SaveHeader *)buffer;
+    memcpy(header->magic, "TWSV", 4);
+    header->version = SAVE_VERSION;
+    header->byte_order = SAVE_BYTE_ORDER;
+    header->pointer_size = sizeof(void *);
+    header->object_size = sizeof(ObjectState);
+    header->state_size = state_size;
+    header->nb_objects = nb_objects;
+    header->objects_offset = objects_offset;
+    header->strings_offset = strings_offset;
+    header->file_size = strings_offset + strings_size;
+    *size = header->file_size;
+    return buffer;
+}
+
+/**
+ * Saves the game state and every object
+ * \param filename The path to the save file
+ * \param state The game state, contiguous and without pointers
+ * \param state_size The size of the game state
+ * \note The file is built in memory and written at once
+ */
+void save_game(char *filename, const void *state, size_t state_size) {
+    size_t size;
+    Uint8 *buffer = save_game_to_memory(state, state_size, &size);
+    SDL_RWops *file = SDL_RWFromFile(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "[SAVE] Failed to open save file: %s\n", SDL_GetError());
+        exit(1);
+    }
+    if (SDL_RWwrite(file, buffer, size, 1) != 1) {
+        fprintf(stderr, "[SAVE] Failed to write save file: %s\n", SDL_GetError());
+        exit(1);
+    }
+    SDL_RWclose(file);
+    free(buffer);
+}
+
+/**
+ * Checks the header of a save
+ * \param data The save
+ * \param size The size of the save
+ * \param state_size The expected size of the game state
+ * \return True if the save can be loaded on this machine
+ */
+static bool _check_save_header(const Uint8 *data, size_t size, size_t state_size) {
+    if (size < sizeof(SaveHeader)) return false;
+    const SaveHeader *header = (const SaveHeader *)data;
+    if (memcmp(header->magic, "TWSV", 4) != 0 || header->version != SAVE_VERSION) return false;
+    if (header->byte_order != SAVE_BYTE_ORDER || header->pointer_size != sizeof(void *) || header->object_size != sizeof(ObjectState)) return false;
+    if (header->state_size != state_size || header->file_size != size) return false;
+    if (header->objects_offset < sizeof(SaveHeader) + state_size || header->objects_offset % SAVE_ALIGN != 0) return false;
+    if (header->strings_offset != header->objects_offset + (size_t)header->nb_objects * sizeof(ObjectState)) return false;
+    if (header->strings_offset > header->file_size) return false;
+    // Every name ends before the end of the file
+    return header->nb_objects == 0 || data[size - 1] == '\0';
+}
+
+/**
+ * Loads the game state and the objects of a serialized save
+ * \param data The save, its offsets are replaced by pointers in place
+ * \param size The size of the save
+ * \param state The game state to overwrite
+ * \param state_size The size of the game state
+ * \return False if the save was made by another version or machine, is corrupted or uses a texture that is not loaded, the game and the objects are then unchanged
+ * \note Every record is checked and resolved before the game and the objects are changed
+ */
+bool load_game_from_memory(Uint8 *data, size_t size, void *state, size_t state_size) {
+    if (!_check_save_header(data, size, state_size)) return false;
+
+    const SaveHeader *header = (const SaveHeader *)data;
+    ObjectState *objects = (ObjectState *)(data + header->objects_offset);
+    const char *strings = (const char *)(data + header->strings_offset);
+    size_t strings_size = header->file_size - header->strings_offset;
+    uintptr_t texture_offset = 0;
+    Texture *texture = NULL;
+    for (Uint32 i = 0; i < header->nb_objects; i++) {
+        ObjectState *current = &objects[i];
+        uintptr_t name_offset = (uintptr_t)current->name;
+        uintptr_t object_texture = (uintptr_t)current->object.texture;
+        uintptr_t data_offset = (uintptr_t)current->object.data;
+        if (name_offset >= strings_size || object_texture > strings_size || data_offset > state_size) return false;
+        // Names start after the end of the previous one
+        if (name_offset > 0 && strings[name_offset - 1] != '\0') return false;
+        if (object_texture > 1 && strings[object_texture - 2] != '\0') return false;
+
+        // Objects sharing a texture share its name, the last lookup is reused
+        if (object_texture != texture_offset) {
+            texture_offset = object_texture;
+            texture = texture_offset != 0 ? find_texture_by_name((char *)strings + texture_offset - 1) : NULL;
+            if (texture_offset != 0 && texture == NULL) {
+                fprintf(stderr, "[SAVE] Texture not loaded: %s\n", strings + texture_offset - 1);
+                return false;
+            }
+        }
+        current->name = engine_intern(strings + name_offset);
+        current->object.texture = texture;
+        current->object.data = data_offset != 0 ? (Uint8 *)state + data_offset - 1 : NULL;
+    }
+
+    memcpy(state, data + sizeof(SaveHeader), state_size);
+    restore_objects(objects, header->nb_objects);
+    return true;
+}
+
+/**
+ * Loads the game state and the objects of a save
+ * \param filename The path to the save file
+ * \param state The game state to overwrite
+ * \param state_size The size of the game state
+ * \return False if there is no save or if it was made by another version or machine, the game and the objects are then unchanged
+ * \note The file is mapped in memory and its objects are used in place once their offsets are replaced by pointers
+ */
+bool load_game(char *filename, void *state, size_t state_size) {
+    MappedFile mapped;
+    if (!_map_file(filename, &mapped)) return false;
+    bool loaded = load_game_from_memory(mapped.data, mapped.size, state, state_size);
+    if (!loaded) fprintf(stderr, "[SAVE] Incompatible or corrupted save file: %s\n", filename);
+    _unmap_file(&mapped);
+    return loaded;
+}